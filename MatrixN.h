@@ -0,0 +1,186 @@
+// ---------------------------------------------------------------------------
+// MatrixN.h - C++ Header File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	Fixed size NxN matrix for small systems.  Lives on the stack and every
+//	loop bound is known at compile time so the compiler can unroll it.  The
+//	math is the same, in the same order, as MatrixNN so the answers match.
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+#ifndef __MATRIXN_H
+#define __MATRIXN_H
+
+/*
+ * Includes
+ */ 
+#include <math.h>
+
+#include "MatrixNN.h"
+
+// ---------------------------------------------------------------------------
+
+#define MATRIXN_MAX		24		// Biggest size we make a fixed version of, past this the blocked LDL^T wins
+
+
+/*
+ * MatrixN - Class Definition
+ *
+ *	Same row/col layout as MatrixNN, just N is a template arg.  The factor
+ *	procs are static and take the rows directly, so they can also be run 
+ *	in place on a MatrixNN's data with rowsOf().
+ */
+template<unsigned N>
+class MatrixN
+{
+public:
+	double m[N][N] ;
+
+	/*
+	 * rowsOf() - Views an NxN MatrixNN's data as fixed size rows.
+	 */
+	static double (*rowsOf(MatrixNN &matNN))[N]
+		{
+		return (double (*)[N]) matNN.ptrDbl ;
+		}
+
+	/*
+	 * load() - Copy in from a MatrixNN that must be NxN.
+	 */
+	void load(const MatrixNN &matNN)
+		{
+		const double *ptrSrc = matNN.ptrDbl ;
+		unsigned i,j ;
+		for (i=0; i < N; ++i)
+			for (j=0; j < N; ++j)
+				m[i][j] = ptrSrc[i*N+j] ;
+		}
+
+	/*
+	 * store() - Copy out to a MatrixNN that must be NxN.
+	 */
+	void store(MatrixNN &matNN) const
+		{
+		double *ptrDst = matNN.ptrDbl ;
+		unsigned i,j ;
+		for (i=0; i < N; ++i)
+			for (j=0; j < N; ++j)
+				ptrDst[i*N+j] = m[i][j] ;
+		}
+
+	/*
+	 * factorizeLU() - Same as MatrixNN::factorizeLU(), partial pivoting on the
+	 *		biggest |a[i][k]|, L and U stored on top of each other.
+	 */
+	static bool factorizeLU(double a[][N], unsigned uPivots[N])
+		{
+		unsigned i,j,k ;
+		for (k=0; k < N; ++k)
+			uPivots[k] = k ;
+
+		for (k=0; k < N; ++k)
+			{
+			double dBiggest = fabs(a[k][k]) ;
+			unsigned uIdxPivot = k ;
+			for (i=k+1; i < N; ++i)
+				{
+				if (fabs(a[i][k]) > dBiggest)
+					{
+					dBiggest = fabs(a[i][k]) ;
+					uIdxPivot = i ;
+					}
+				}
+			unsigned uTemp = uPivots[k] ;
+			uPivots[k] = uPivots[uIdxPivot] ;
+			uPivots[uIdxPivot] = uTemp ;
+			if (uIdxPivot != k)
+				{
+				for (j=0; j < N; ++j)
+					{
+					double dTemp = a[k][j] ;
+					a[k][j] = a[uIdxPivot][j] ;
+					a[uIdxPivot][j] = dTemp ;
+					}
+				}
+
+			double dPivot = a[k][k] ;
+			if (dPivot == 0)
+				return false ;
+			for (i=k+1; i < N; ++i)
+				{
+				a[i][k] = a[i][k] / dPivot ;
+				double dL = a[i][k] ;
+				for (j=k+1; j < N; ++j)
+					a[i][j] = a[i][j] - dL * a[k][j] ;
+				}
+			}
+
+		return true ;
+		}
+
+	/*
+	 * factorizeLDLT() - Same as MatrixNN::factorizeLDLT(), reads the lower triangle,
+	 *		L in the strict lower part, D on the diagonal, upper part is garbage.
+	 *		Copies the lower triangle up and works on the upper rows the same way, 
+	 *		just without the blocks, so the factors come out the same.
+	 */
+	static bool factorizeLDLT(double a[][N])
+		{
+		unsigned i,j,k ;
+		for (i=1; i < N; ++i)
+			for (j=0; j < i; ++j)
+				a[j][i] = a[i][j] ;
+
+		for (k=0; k < N; ++k)
+			{
+			double dD = a[k][k] ;
+			if (!(dD > 0.0))		// Also catches NaN
+				return false ;
+
+			for (i=k+1; i < N; ++i)
+				{
+				a[i][k] = a[k][i] / dD ;
+				double dL = a[i][k] ;
+				for (j=i; j < N; ++j)
+					a[i][j] = a[i][j] - dL * a[k][j] ;
+				}
+			}
+
+		return true ;
+		}
+
+	bool factorizeLU(unsigned uPivots[N]) { return factorizeLU(m, uPivots) ; } ;
+	bool factorizeLDLT(void) { return factorizeLDLT(m) ; } ;
+} ;
+
+// ---------------------------------------------------------------------------
+
+#endif // end of __MATRIXN_H
@@ -1,428 +1,1599 @@
-// ---------------------------------------------------------------------------
-// MatrixNN.cpp - C++ File
-// Copyright 2004 Michael B. Comet
-// ---------------------------------------------------------------------------
-//
-// DESCRIPTION:
-//	A plugin class to do stuff with square NxN matrices.
-//
-// AUTHOR:
-//	Michel B. Comet - comet@comet-cartoons.com
-//	Based on some LU pseudocode from http://www.utsc.utoronto.ca/~nick/cscC50/02may/notes03
-//
-// VERSIONS:
-//	1.05 - 10/12/04 - mcomet - First Version of this file.
-//	1.06 - 10/16/04 - mcomet - Added mirrorData node to help with mirroring.
-//	1.07 - 11/03/04 - mcomet - Now only uses membership points when creating
-//				targets, also put in missing scripts to ZIP file.
-//  1.09c - 12/01/04 - mcomet - Now has option for joint-space vs. pose-space
-//				deformation.  So that the sculpt is either tied to the joint
-//				or the reader as it is brought back up.
-//	1.10 - 01/21/05 - mcomet - Fix for wig out mesh when pose deleted.
-//	
-// ---------------------------------------------------------------------------
-//
-//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
-//  Copyright 2004 Michael B. Comet
-//
-//   This program is free software; you can redistribute it and/or modify
-//   it under the terms of the GNU General Public License as published by
-//   the Free Software Foundation; either version 2 of the License, or
-//   (at your option) any later version.
-//
-//   This program is distributed in the hope that it will be useful,
-//   but WITHOUT ANY WARRANTY; without even the implied warranty of
-//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-//   GNU General Public License for more details.
-//
-//   You should have received a copy of the GNU General Public License
-//   along with this program; if not, write to the Free Software
-//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
-//
-//   For information on poseDeformer contact:
-//			Michael B. Comet - comet@comet-cartoons.com
-//			or visit http://www.comet-cartooons.com/toons/
-//
-// --------------------------------------------------------------------------
-
-/*
- * Includes
- */
-#include "MatrixNN.h"
-
-
-// ---------------------------------------------------------------------------
-
-// ---------------------------------------------------------------------------
-//	Main Node Functions
-// ---------------------------------------------------------------------------
-
-// ---------------------------------------------------------------------------
-
-
-/*
- * MatrixNN::MatrixNN() - constructor
- */
-MatrixNN::MatrixNN() 
-{
-	ptrDbl = NULL ;
-	uDimension = 0 ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * MatrixNN::~MatrixNN() - Destructor
- */
-MatrixNN::~MatrixNN()
-{
-	free() ;			// free any memory alloced before we are totally destroyed!
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * MatrixNN::free() - Frees any alloced memory
- */
-void MatrixNN::free(void)
-{
-	if (ptrDbl != NULL)
-		delete [] ptrDbl ;
-	ptrDbl = NULL ;
-	uDimension = 0 ;
-
-}
-
-// ---------------------------------------------------------------------------
-/*
- * MatrixNN::setDimension() - Aloc the array.  Returns alloced dimension or
- *								0 on error.
- */
-unsigned MatrixNN::setDimension(unsigned uDim)
-{
-	free() ;		// First free anything
-	if (uDim == 0)	// Can't alloc 0 bytes
-		return 0 ;
-
-	unsigned uTotal = uDim * uDim ;	// How many entries in a Nrow x NCol matrix?
-
-	ptrDbl = new double [uTotal] ;		// Alloc
-	if (ptrDbl == NULL)
-		return 0 ;			// out of memory
-
-	uDimension = uDim ;
-
-	identity() ;			// By default set to this.
-
-	return uDimension ;	
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * MatrixNN::getDimension() - Gets the current dimension of the matrix
- */
-unsigned MatrixNN::getDimension(void)
-{
-	return uDimension ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * MatrixNN::fill() - Fills matrix to all the specified value
- */
-void MatrixNN::fill(double dVal)
-{
-	if (uDimension == 0 || ptrDbl == NULL)
-		return ;
-
-	unsigned i,j;
-	for (i=0; i < uDimension; ++i)
-		{
-		for (j=0; j < uDimension; ++j)
-			{
-			unsigned idx = getIndex(i, j);
-			ptrDbl[idx] = dVal ;
-			} // end of j
-		} // end of i
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * MatrixNN::getIndex() - Given a 2d index i,j pair, return the flat
- *			index into the 1D array allocated
- */
-inline unsigned MatrixNN::getIndex(unsigned i, unsigned j)
-{
-	unsigned idx = (i*uDimension) + j ;
-	return idx ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * MatrixNN::identity() - Sets this matrix to identity
- */
-void MatrixNN::identity(void)
-{
-	if (uDimension == 0 || ptrDbl == NULL)
-		return ;
-
-	unsigned i,j;
-	for (i=0; i < uDimension; ++i)
-		{
-		for (j=0; j < uDimension; ++j)
-			{
-			unsigned idx = getIndex(i, j);
-			if (i==j)
-				ptrDbl[idx] = 1.0 ;
-			else
-				ptrDbl[idx] = 0.0 ;
-			} // end of j
-		} // end of i
-
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * MatrixNN::operator[] - We need to do this so that the [][] works...
- */
-double* MatrixNN::operator[](unsigned i)
-{
-	double *ptr = ptrDbl + (i*uDimension) ;
-	return ptr ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * MatrixNN::operator[] - We need to do this so that the [][] works...
- */
-const double* MatrixNN::operator[](unsigned i) const
-{
-	double *ptr = ptrDbl + (i*uDimension) ;
-	return ptr ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * MatrixNN::operator() - Double index into matrix.
- */
-double& MatrixNN::operator()(unsigned i, unsigned j)
-{
-	unsigned idx = getIndex(i, j) ;
-	return (ptrDbl[idx]) ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * MatrixNN::operator() const - Double index into matrix.
- */
-double MatrixNN::operator()(unsigned i, unsigned j) const
-{
-	unsigned idx = (i*uDimension) + j ;
-	return (ptrDbl[idx]) ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * operator<<() - Output
- */
-ostream& operator<<(ostream &os, const MatrixNN &matNN) 
-{
-	os << "MatrixNN " << matNN.uDimension << "x" << matNN.uDimension << endl ;
-	if (matNN.uDimension > 0 && matNN.ptrDbl != NULL)
-		{
-		unsigned i,j;
-		for (i=0; i < matNN.uDimension; ++i)
-			{
-			os << "ROW_" << i << "= " ;
-			for (j=0; j < matNN.uDimension; ++j)
-				{
-				os << matNN[i][j] << " " ;
-				}
-			os << endl ;
-			}
-		}
-	return os ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * MatrixNN::operator=() - Assignemnt operator
- */
-MatrixNN& MatrixNN::operator=(const MatrixNN &matNN) 
-{
-	setDimension( matNN.uDimension );
-
-	unsigned u;
-	unsigned uTotal = uDimension * uDimension ;
-	for (u=0; u < uTotal; ++u)
-		ptrDbl[u] = matNN.ptrDbl[u] ;
-
-	return (*this) ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * MatrixNN::factorizeLU() - For this current matrix, factorize it into 
- *	two matrices L and U, where L is a lower diagonal matrix, and U is an 
- *	upper diagonal matrix, such that this matrix A = L*U ;
- *
- *	To save space, this takes the current matrix and actually modifies it so that it
- *	end up holding both the L and U diagonal values within it when done.
- *
- *	This does so with partial (aka row) pivoting.
- *	uPivots is an array of values that will hold what row index each row was swaped to.
- *	ie: if row 3 was swapped to row 6, then uPivots[3] = 6  (assuming 0...n)
- *
- *
- *	Returns 1 on success, 0 on error
- */
-bool MatrixNN::factorizeLU(unsigned uPivots[])
-{
-	if (uDimension == 0 || ptrDbl == NULL)
-		return false ;
-
-	unsigned i,j,k ;
-
-	MatrixNN &A = (*this) ;	// Easier to work with...
-
-	// Init pivot info
-	for (k=0; k < uDimension; ++k)
-		uPivots[k] = k ;
-
-	for (k=0; k < uDimension-1; ++k)
-		{
-		// For pivoting, first find the greatest value of all the rows in the current column k.
-		double dBiggest = A[k][k] ;
-		unsigned uIdxPivot = k ;
-		for (i=k+1; i < uDimension; ++i)
-			{
-			if (A[i][k] > dBiggest)
-				uIdxPivot = i ;
-			}
-		unsigned uTemp = uPivots[k] ;
-		uPivots[k] = uPivots[uIdxPivot] ;		// Store it!
-		uPivots[uIdxPivot] = uTemp ;
-		// And do actual swap, if needed
-		if (uIdxPivot != k)
-			{
-			for (j=0; j < uDimension ; ++j)
-				{
-				double dTemp = A[k][j] ;
-				A[k][j] = A[uIdxPivot][j] ;
-				A[uIdxPivot][j] = dTemp ;
-				}
-			}
-
-
-		double dPivot = A[k][k] ;
-		if (dPivot == 0)
-			{
-			cout << "Cannot MatrixNN::factorizeLU(), A has become=" << A << endl ;
-			return false ;			// Should do permutation code before this to try to avoid here...		
-			}
-		for (i=k+1; i < uDimension; ++i)
-			{
-			A[i][k] = A[i][k] / A[k][k] ;
-		
-			for (j=i+1; j < uDimension; ++j)
-				{
-				A[i][j] = A[i][j] - ( A[i][k] * A[k][j] );
-				}	// end of j sub cols
-			
-			}	// end of i rows
-		
-		} // end of k cols
-
-	return true ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * solveLU() - Do an actual LU solve on this Matrix.  This is for the case
- *		where this matrix A is a set of linear equations such that Ax = b
- *		and we want to solve for x.
- *
- *		Returns true on success, false otherwise.  Length of b is assumed to
- *			be allocated to same as dimension of matrix as is length of x
- */
-bool MatrixNN::solveLU(double b[], double x[])
-{
-	MatrixNN &A = (*this) ;	// Easier to work with...
-	
-	double *dB = NULL ;
-	unsigned *uPivots = NULL ;
-	dB = new double [uDimension] ;	// Alloc array of orig values of b
-	if (dB == NULL)
-		return false ;
-	uPivots = new unsigned [uDimension] ;	// Alloc pivot array
-	if (uPivots == NULL)
-		{
-		delete [] dB ;
-		return false ;
-		}
-	// Factorize A in to an L and U matrix, that is stored back on top of what A was...
-	// Return false if factorization failed...
-	bool bFac = A.factorizeLU(uPivots) ;
-	if (!bFac)
-		{
-		delete [] dB ;
-		delete [] uPivots ;
-		return bFac ;
-		}
-
-	unsigned i, j ;
-
-	// First swap b array as needed.
-	for (j=0; j < uDimension; ++j)
-		dB[j] = b[ uPivots[j] ] ;	// get proper value into right spot based on pivot permutations done.
-	// dB is now the "real" B array we use for solving...
-
-	// First solve for y in Ly = b
-	for (i=1; i < uDimension; ++i)
-		{
-		for (j=0; j <= i-1; ++j)
-			{
-			dB[i] = dB[i] - (A[i][j] * dB[j]) ; 
-			}
-		}
-
-	// Then solve for x in Ux = y
-	unsigned n = uDimension-1 ;
-	dB[n] = dB[n] / A[n][n] ;
-
-	for (i=n-1; i >= 0; --i)
-		{
-		for (j=i+1; j < uDimension; ++j)
-			{
-			dB[i] = dB[i] - ( A[i][j] * dB[j] / A[i][i] ) ;
-			}
-		if (i == 0)		// hack.  Since i is unsigned i will NEVER be < 0 above!
-			break ;
-		}
-
-	// Now copy final output, ie: dPB to real X user passed in...
-	for (i=0; i < uDimension; ++i)
-		x[i] = dB[i] ;
-
-	delete [] dB ;
-	delete [] uPivots ;
-
-	return true ;
-}
-
-
-// ---------------------------------------------------------------------------
-
-
+// ---------------------------------------------------------------------------
+// MatrixNN.cpp - C++ File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	A plugin class to do stuff with square NxN matrices.
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//	Based on some LU pseudocode from http://www.utsc.utoronto.ca/~nick/cscC50/02may/notes03
+//
+// VERSIONS:
+//	1.05 - 10/12/04 - mcomet - First Version of this file.
+//	1.06 - 10/16/04 - mcomet - Added mirrorData node to help with mirroring.
+//	1.07 - 11/03/04 - mcomet - Now only uses membership points when creating
+//				targets, also put in missing scripts to ZIP file.
+//  1.09c - 12/01/04 - mcomet - Now has option for joint-space vs. pose-space
+//				deformation.  So that the sculpt is either tied to the joint
+//				or the reader as it is brought back up.
+//	1.10 - 01/21/05 - mcomet - Fix for wig out mesh when pose deleted.
+//	
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+/*
+ * Includes
+ */
+
+#include "MatrixNN.h"
+#include "MatrixN.h"
+#include "poseDeformerKernel.h"
+
+#define LUBLOCK			48		// Cols per LU panel
+#define LUCOLBLOCK		256		// Cols per strip of the LU trailing update
+#define LDLTTILE		32		// Tile size for the LDL^T lower to upper copy
+
+
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+//	Main Node Functions
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+
+
+unsigned MatrixNN::uAllocCount = 0 ;
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::MatrixNN() - constructor
+ */
+MatrixNN::MatrixNN() 
+{
+	ptrDbl = NULL ;
+	uDimension = 0 ;
+	ptrHeap = NULL ;
+	uCapacity = 0 ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::MatrixNN() - Copy constructor
+ */
+MatrixNN::MatrixNN(const MatrixNN &matNN) 
+{
+	ptrDbl = NULL ;
+	uDimension = 0 ;
+	ptrHeap = NULL ;
+	uCapacity = 0 ;
+
+	(*this) = matNN ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::MatrixNN() - Move constructor, takes matNN's data and leaves it empty.
+ */
+MatrixNN::MatrixNN(MatrixNN &&matNN) 
+{
+	ptrDbl = NULL ;
+	uDimension = 0 ;
+	ptrHeap = NULL ;
+	uCapacity = 0 ;
+
+	take(matNN) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::~MatrixNN() - Destructor
+ */
+MatrixNN::~MatrixNN()
+{
+	free() ;			// free any memory alloced before we are totally destroyed!
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::free() - Frees any alloced memory
+ */
+void MatrixNN::free(void)
+{
+	if (ptrHeap != NULL)
+		delete [] ptrHeap ;
+	ptrHeap = NULL ;
+	ptrDbl = NULL ;
+	uCapacity = 0 ;
+	uDimension = 0 ;
+
+}
+
+// ---------------------------------------------------------------------------
+/*
+ * MatrixNN::setDimension() - Aloc the array.  Returns alloced dimension or
+ *								0 on error.
+ *
+ *	If there is already room for uDim x uDim nothing is alloced.  Small ones
+ *	go in dInline, the rest on the heap lined up to MATRIXNN_ALIGN bytes.
+ *	The values are left as whatever was there, so fill() or identity() it
+ *	if that matters.
+ */
+unsigned MatrixNN::setDimension(unsigned uDim)
+{
+	if (uDim == 0)	// Can't alloc 0 bytes
+		{
+		free() ;
+		return 0 ;
+		}
+
+	unsigned uTotal = uDim * uDim ;	// How many entries in a Nrow x NCol matrix?
+	if (uTotal <= uCapacity)
+		{
+		uDimension = uDim ;		// Already have room
+		return uDimension ;
+		}
+
+	free() ;		// First free anything
+
+	if (uDim <= MATRIXNN_INLINE)
+		{
+		ptrDbl = dInline ;
+		uCapacity = MATRIXNN_INLINE * MATRIXNN_INLINE ;
+		}
+	else
+		{
+		unsigned uPad = MATRIXNN_ALIGN / sizeof(double) ;
+		ptrHeap = new double [uTotal + uPad] ;		// Alloc, with room to slide up to the alignment
+		if (ptrHeap == NULL)
+			return 0 ;			// out of memory
+		++uAllocCount ;
+
+		size_t uAddr = (size_t)ptrHeap ;
+		uAddr = (uAddr + MATRIXNN_ALIGN - 1) & ~(size_t)(MATRIXNN_ALIGN - 1) ;
+		ptrDbl = (double *)uAddr ;
+		uCapacity = uTotal ;
+		}
+
+	uDimension = uDim ;
+
+	return uDimension ;	
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::getDimension() - Gets the current dimension of the matrix
+ */
+unsigned MatrixNN::getDimension(void)
+{
+	return uDimension ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::fill() - Fills matrix to all the specified value
+ */
+void MatrixNN::fill(double dVal)
+{
+	if (uDimension == 0 || ptrDbl == NULL)
+		return ;
+
+	unsigned i,j;
+	for (i=0; i < uDimension; ++i)
+		{
+		for (j=0; j < uDimension; ++j)
+			{
+			unsigned idx = getIndex(i, j);
+			ptrDbl[idx] = dVal ;
+			} // end of j
+		} // end of i
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::getIndex() - Given a 2d index i,j pair, return the flat
+ *			index into the 1D array allocated
+ */
+inline unsigned MatrixNN::getIndex(unsigned i, unsigned j)
+{
+	unsigned idx = (i*uDimension) + j ;
+	return idx ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::identity() - Sets this matrix to identity
+ */
+void MatrixNN::identity(void)
+{
+	if (uDimension == 0 || ptrDbl == NULL)
+		return ;
+
+	unsigned i,j;
+	for (i=0; i < uDimension; ++i)
+		{
+		for (j=0; j < uDimension; ++j)
+			{
+			unsigned idx = getIndex(i, j);
+			if (i==j)
+				ptrDbl[idx] = 1.0 ;
+			else
+				ptrDbl[idx] = 0.0 ;
+			} // end of j
+		} // end of i
+
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::operator[] - We need to do this so that the [][] works...
+ */
+double* MatrixNN::operator[](unsigned i)
+{
+	double *ptr = ptrDbl + (i*uDimension) ;
+	return ptr ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::operator[] - We need to do this so that the [][] works...
+ */
+const double* MatrixNN::operator[](unsigned i) const
+{
+	double *ptr = ptrDbl + (i*uDimension) ;
+	return ptr ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::operator() - Double index into matrix.
+ */
+double& MatrixNN::operator()(unsigned i, unsigned j)
+{
+	unsigned idx = getIndex(i, j) ;
+	return (ptrDbl[idx]) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::operator() const - Double index into matrix.
+ */
+double MatrixNN::operator()(unsigned i, unsigned j) const
+{
+	unsigned idx = (i*uDimension) + j ;
+	return (ptrDbl[idx]) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * operator<<() - Output
+ */
+ostream& operator<<(ostream &os, const MatrixNN &matNN) 
+{
+	os << "MatrixNN " << matNN.uDimension << "x" << matNN.uDimension << endl ;
+	if (matNN.uDimension > 0 && matNN.ptrDbl != NULL)
+		{
+		unsigned i,j;
+		for (i=0; i < matNN.uDimension; ++i)
+			{
+			os << "ROW_" << i << "= " ;
+			for (j=0; j < matNN.uDimension; ++j)
+				{
+				os << matNN[i][j] << " " ;
+				}
+			os << endl ;
+			}
+		}
+	return os ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::operator=() - Assignemnt operator
+ */
+MatrixNN& MatrixNN::operator=(const MatrixNN &matNN) 
+{
+	if (&matNN == this)
+		return (*this) ;
+
+	setDimension( matNN.uDimension );		// Reuses our storage if it's big enough
+
+	unsigned u;
+	unsigned uTotal = uDimension * uDimension ;
+	for (u=0; u < uTotal; ++u)
+		ptrDbl[u] = matNN.ptrDbl[u] ;
+
+	return (*this) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::operator=() - Move assignment, takes matNN's data and leaves it empty.
+ */
+MatrixNN& MatrixNN::operator=(MatrixNN &&matNN) 
+{
+	if (&matNN == this)
+		return (*this) ;
+
+	free() ;
+	take(matNN) ;
+
+	return (*this) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::take() - Moves matNN's data into this empty matrix.  Heap storage is 
+ *		just handed over, inline storage has to be copied.  matNN is left empty.
+ */
+void MatrixNN::take(MatrixNN &matNN)
+{
+	if (matNN.ptrHeap != NULL)
+		{
+		ptrHeap = matNN.ptrHeap ;
+		ptrDbl = matNN.ptrDbl ;
+		uCapacity = matNN.uCapacity ;
+		uDimension = matNN.uDimension ;
+		matNN.ptrHeap = NULL ;
+		matNN.ptrDbl = NULL ;
+		matNN.uCapacity = 0 ;
+		matNN.uDimension = 0 ;
+		}
+	else if (matNN.uDimension != 0)
+		{
+		(*this) = matNN ;
+		matNN.free() ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * luFactor() - The actual work of MatrixNN::factorizeLU(), see there.  Written 
+ *		over a plain row major array.  Returns false on a zero pivot.
+ */
+static bool luFactor(double *a, unsigned uN, unsigned uPivots[])
+{
+	unsigned i,j,k ;
+
+	int nKernel = poseKernelResolve(eKernelAuto) ;
+
+	// Init pivot info
+	for (k=0; k < uN; ++k)
+		uPivots[k] = k ;
+
+	unsigned uBlock ;
+	for (uBlock=0; uBlock < uN; uBlock += LUBLOCK)
+		{
+		unsigned uEnd = uBlock + LUBLOCK ;		// One past the last col of this panel
+		if (uEnd > uN)
+			uEnd = uN ;
+
+		// Factor the panel, cols uBlock..uEnd-1, only updating inside the panel.
+		for (k=uBlock; k < uEnd; ++k)
+			{
+			// For pivoting, first find the greatest magnitude of all the rows in the current column k.
+			double dBiggest = fabs(a[k*uN+k]) ;
+			unsigned uIdxPivot = k ;
+			for (i=k+1; i < uN; ++i)
+				{
+				if (fabs(a[i*uN+k]) > dBiggest)
+					{
+					dBiggest = fabs(a[i*uN+k]) ;
+					uIdxPivot = i ;
+					}
+				}
+			unsigned uTemp = uPivots[k] ;
+			uPivots[k] = uPivots[uIdxPivot] ;		// Store it!
+			uPivots[uIdxPivot] = uTemp ;
+			// And do actual swap, if needed.  Whole rows, so the cols right of 
+			// the panel get swapped too and are fixed up below.
+			if (uIdxPivot != k)
+				{
+				double *ptrRowK = a + k*uN ;
+				double *ptrRowP = a + uIdxPivot*uN ;
+				for (j=0; j < uN ; ++j)
+					{
+					double dTemp = ptrRowK[j] ;
+					ptrRowK[j] = ptrRowP[j] ;
+					ptrRowP[j] = dTemp ;
+					}
+				}
+
+			double dPivot = a[k*uN+k] ;
+			if (dPivot == 0)
+				return false ;			// Should do permutation code before this to try to avoid here...		
+			for (i=k+1; i < uN; ++i)
+				{
+				double *ptrRowI = a + i*uN ;
+				ptrRowI[k] = ptrRowI[k] / dPivot ;
+				poseKernelRowUpdate(nKernel, ptrRowI[k], a+k*uN+k+1, ptrRowI+k+1, uEnd-(k+1)) ;
+				}	// end of i rows
+			
+			} // end of k cols
+
+		if (uEnd == uN)
+			break ;
+
+		// Now the cols right of the panel.  For the panel rows that is solving 
+		// with the unit L of the panel, for the rows below it's the trailing 
+		// update A -= L * U.  Either way row i takes off row k for every panel
+		// col k < i, and row k is always finished before row i needs it.
+		unsigned uCol ;
+		for (uCol=uEnd; uCol < uN; uCol += LUCOLBLOCK)
+			{
+			unsigned uCols = uN - uCol ;
+			if (uCols > LUCOLBLOCK)
+				uCols = LUCOLBLOCK ;
+
+			for (i=uBlock+1; i < uN; ++i)
+				{
+				double *ptrRowI = a + i*uN ;
+				unsigned uLast = (i < uEnd) ? i : uEnd ;
+				poseKernelRowsUpdate(nKernel, ptrRowI+uBlock, uLast-uBlock, a+uBlock*uN+uCol, uN, ptrRowI+uCol, uCols) ;
+				}
+			}
+
+		} // end of blocks
+
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * luSubstitute() - The actual work of MatrixNN::substituteLU(), over a plain
+ *		row major array.
+ */
+static void luSubstitute(const double *a, unsigned uN, const unsigned uPivots[], const double b[], double x[], double dB[])
+{
+	unsigned i, j ;
+
+	// First swap b array as needed.
+	for (j=0; j < uN; ++j)
+		dB[j] = b[ uPivots[j] ] ;	// get proper value into right spot based on pivot permutations done.
+	// dB is now the "real" B array we use for solving...
+
+	// First solve for y in Ly = b, L has 1's on the diagonal.
+	for (i=1; i < uN; ++i)
+		{
+		const double *ptrRowI = a + i*uN ;
+		for (j=0; j < i; ++j)
+			{
+			dB[i] = dB[i] - (ptrRowI[j] * dB[j]) ; 
+			}
+		}
+
+	// Then solve for x in Ux = y, from the bottom up.
+	i = uN ;
+	while (i > 0)
+		{
+		--i ;
+		const double *ptrRowI = a + i*uN ;
+		for (j=i+1; j < uN; ++j)
+			{
+			dB[i] = dB[i] - ( ptrRowI[j] * dB[j] ) ;
+			}
+		dB[i] = dB[i] / ptrRowI[i] ;
+		}
+
+	// Now copy final output, ie: dPB to real X user passed in...
+	for (i=0; i < uN; ++i)
+		x[i] = dB[i] ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * ldltFactor() - The actual work of MatrixNN::factorizeLDLT(), over a plain array.
+ *		The lower triangle is copied up first and the work is all done on the
+ *		upper triangle a row at a time, like luFactor() without the pivoting:
+ *		row i takes l_ik * row k off its cols from i on, where l_ik is the 
+ *		finished a[k][i] / D_k, and l_ik goes into the lower triangle as L.  
+ *		Same blocks as luFactor(), so the trailing rows are only walked once per
+ *		panel and every row op is contiguous.  Returns false if a D value comes 
+ *		out <= 0.
+ */
+static bool ldltFactor(double *a, unsigned uN)
+{
+	unsigned i,j,k ;
+
+	int nKernel = poseKernelResolve(eKernelAuto) ;
+
+	// Lower triangle up, in tiles so both sides stay in cache.
+	unsigned uTileI, uTileJ ;
+	for (uTileI=0; uTileI < uN; uTileI += LDLTTILE)
+		{
+		unsigned uEndI = (uTileI + LDLTTILE < uN) ? (uTileI + LDLTTILE) : uN ;
+		for (uTileJ=0; uTileJ <= uTileI; uTileJ += LDLTTILE)
+			{
+			for (i=uTileI; i < uEndI; ++i)
+				{
+				unsigned uEndJ = (uTileJ + LDLTTILE < i) ? (uTileJ + LDLTTILE) : i ;
+				for (j=uTileJ; j < uEndJ; ++j)
+					a[j*uN+i] = a[i*uN+j] ;
+				}
+			}
+		}
+
+	unsigned uBlock ;
+	for (uBlock=0; uBlock < uN; uBlock += LUBLOCK)
+		{
+		unsigned uEnd = uBlock + LUBLOCK ;		// One past the last row of this panel
+		if (uEnd > uN)
+			uEnd = uN ;
+
+		// Factor the panel rows, only updating inside the panel cols.
+		for (k=uBlock; k < uEnd; ++k)
+			{
+			double *ptrRowK = a + k*uN ;
+			double dD = ptrRowK[k] ;
+			if (!(dD > 0))		// Also catches NaN
+				return false ;
+			for (i=k+1; i < uEnd; ++i)
+				{
+				double *ptrRowI = a + i*uN ;
+				ptrRowI[k] = ptrRowK[i] / dD ;
+				poseKernelRowUpdate(nKernel, ptrRowI[k], ptrRowK+i, ptrRowI+i, uEnd-i) ;
+				}
+			}
+
+		if (uEnd == uN)
+			break ;
+
+		// Now the cols right of the panel, in strips.  The panel rows take off 
+		// the panel rows above them, same as luFactor().  The rows below only 
+		// need their cols from the diagonal on, and their L for this panel is 
+		// worked out in the strip that holds their diagonal, since by then the
+		// panel rows' col i is finished.
+		unsigned uCol ;
+		for (uCol=uEnd; uCol < uN; uCol += LUCOLBLOCK)
+			{
+			unsigned uColEnd = uCol + LUCOLBLOCK ;
+			if (uColEnd > uN)
+				uColEnd = uN ;
+
+			for (i=uBlock+1; i < uEnd; ++i)
+				{
+				double *ptrRowI = a + i*uN ;
+				poseKernelRowsUpdate(nKernel, ptrRowI+uBlock, i-uBlock, a+uBlock*uN+uCol, uN, ptrRowI+uCol, uColEnd-uCol) ;
+				}
+
+			for (i=uEnd; i < uColEnd; ++i)
+				{
+				double *ptrRowI = a + i*uN ;
+				unsigned uFrom = uCol ;
+				if (i >= uCol)
+					{
+					for (k=uBlock; k < uEnd; ++k)
+						ptrRowI[k] = a[k*uN+i] / a[k*uN+k] ;
+					uFrom = i ;
+					}
+				poseKernelRowsUpdate(nKernel, ptrRowI+uBlock, uEnd-uBlock, a+uBlock*uN+uFrom, uN, ptrRowI+uFrom, uColEnd-uFrom) ;
+				}
+			}
+
+		} // end of blocks
+
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * ldltSubstitute() - The actual work of MatrixNN::substituteLDLT(), over a plain
+ *		row major array.
+ */
+static void ldltSubstitute(const double *a, unsigned uN, const double b[], double x[])
+{
+	unsigned i, j ;
+
+	// Solve L y = b
+	for (i=0; i < uN; ++i)
+		{
+		const double *ptrRowI = a + i*uN ;
+		double dVal = b[i] ;
+		for (j=0; j < i; ++j)
+			dVal = dVal - ( ptrRowI[j] * x[j] ) ;
+		x[i] = dVal ;
+		}
+
+	// Then D z = y
+	for (i=0; i < uN; ++i)
+		x[i] = x[i] / a[i*uN+i] ;
+
+	// Then L^T x = z, from the bottom up.
+	i = uN ;
+	while (i > 0)
+		{
+		--i ;
+		for (j=i+1; j < uN; ++j)
+			x[i] = x[i] - ( a[j*uN+i] * x[j] ) ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * ldltSubstitutePacked() - Same as ldltSubstitute() for the packed rows 
+ *		MatrixNNFactor keeps, L[i][0..i-1] then D[i] for each row.  Same order 
+ *		of ops, so the same answer as solving with the square factors.
+ */
+static void ldltSubstitutePacked(const double *p, unsigned uN, const double b[], double x[])
+{
+	unsigned i, j ;
+
+	// Solve L y = b
+	const double *ptrRowI = p ;
+	for (i=0; i < uN; ++i)
+		{
+		double dVal = b[i] ;
+		for (j=0; j < i; ++j)
+			dVal = dVal - ( ptrRowI[j] * x[j] ) ;
+		x[i] = dVal ;
+		ptrRowI += i + 1 ;
+		}
+
+	// Then D z = y
+	ptrRowI = p ;
+	for (i=0; i < uN; ++i)
+		{
+		x[i] = x[i] / ptrRowI[i] ;
+		ptrRowI += i + 1 ;
+		}
+
+	// Then L^T x = z, from the bottom up.
+	i = uN ;
+	while (i > 0)
+		{
+		--i ;
+		double dVal = x[i] ;
+		for (j=i+1; j < uN; ++j)
+			dVal = dVal - ( p[j*(j+1)/2 + i] * x[j] ) ;
+		x[i] = dVal ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * panelRowsUpdate() - dDst -= dL[r] * row r of dSrc for a panel uP wide, rows in
+ *		order, thru poseKernelRowsUpdate().  Same order of ops as one b at a 
+ *		time, so a panel column comes out the same as solving that b on its own.
+ */
+static inline void panelRowsUpdate(int nKernel, const double *dL, unsigned uRows, const double *dSrc, unsigned uP, double *dDst)
+{
+	poseKernelRowsUpdate(nKernel, dL, uRows, dSrc, uP, dDst, uP) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * luSubstitutePanel() - luSubstitute() for uP right hand sides at once.  Row i of
+ *		dIn holds entry i of each b, and dOut gets the answers the same way, so 
+ *		each row op of the substitution runs down a whole panel row.  dIn and 
+ *		dOut can't be the same.
+ */
+static void luSubstitutePanel(const double *a, unsigned uN, const unsigned uPivots[], const double *dIn, double *dOut, unsigned uP)
+{
+	unsigned i, c ;
+	int nKernel = poseKernelResolve(eKernelAuto) ;
+
+	for (i=0; i < uN; ++i)
+		{
+		const double *ptrSrc = dIn + uPivots[i]*uP ;
+		double *ptrDst = dOut + i*uP ;
+		for (c=0; c < uP; ++c)
+			ptrDst[c] = ptrSrc[c] ;
+		}
+
+	// Ly = b, L has 1's on the diagonal.
+	for (i=1; i < uN; ++i)
+		panelRowsUpdate(nKernel, a + i*uN, i, dOut, uP, dOut + i*uP) ;
+
+	// Ux = y, from the bottom up.
+	i = uN ;
+	while (i > 0)
+		{
+		--i ;
+		const double *ptrRowI = a + i*uN ;
+		double *ptrDst = dOut + i*uP ;
+		panelRowsUpdate(nKernel, ptrRowI + i+1, uN-(i+1), dOut + (i+1)*uP, uP, ptrDst) ;
+		for (c=0; c < uP; ++c)
+			ptrDst[c] = ptrDst[c] / ptrRowI[i] ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * ldltSubstitutePanel() - ldltSubstitute() for uP right hand sides at once, in 
+ *		place on dW laid out like luSubstitutePanel().  For L^T, col i of L is
+ *		copied into dCol, at least dimension long, so it can go thru the kernel
+ *		like a row.
+ */
+static void ldltSubstitutePanel(const double *a, unsigned uN, double *dW, unsigned uP, double *dCol)
+{
+	unsigned i, j, c ;
+	int nKernel = poseKernelResolve(eKernelAuto) ;
+
+	for (i=1; i < uN; ++i)
+		panelRowsUpdate(nKernel, a + i*uN, i, dW, uP, dW + i*uP) ;
+
+	for (i=0; i < uN; ++i)
+		for (c=0; c < uP; ++c)
+			dW[i*uP+c] = dW[i*uP+c] / a[i*uN+i] ;
+
+	i = uN ;
+	while (i > 0)
+		{
+		--i ;
+		for (j=i+1; j < uN; ++j)
+			dCol[j] = a[j*uN+i] ;
+		panelRowsUpdate(nKernel, dCol + i+1, uN-(i+1), dW + (i+1)*uP, uP, dW + i*uP) ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * ldltSubstitutePackedPanel() - ldltSubstitutePacked() for uP right hand sides at 
+ *		once, in place on dW laid out like luSubstitutePanel().  dCol is for
+ *		the cols of L, same as ldltSubstitutePanel().
+ */
+static void ldltSubstitutePackedPanel(const double *p, unsigned uN, double *dW, unsigned uP, double *dCol)
+{
+	unsigned i, j, c ;
+	int nKernel = poseKernelResolve(eKernelAuto) ;
+
+	for (i=1; i < uN; ++i)
+		panelRowsUpdate(nKernel, p + i*(i+1)/2, i, dW, uP, dW + i*uP) ;
+
+	for (i=0; i < uN; ++i)
+		{
+		double dD = p[i*(i+1)/2 + i] ;
+		for (c=0; c < uP; ++c)
+			dW[i*uP+c] = dW[i*uP+c] / dD ;
+		}
+
+	i = uN ;
+	while (i > 0)
+		{
+		--i ;
+		for (j=i+1; j < uN; ++j)
+			dCol[j] = p[j*(j+1)/2 + i] ;
+		panelRowsUpdate(nKernel, dCol + i+1, uN-(i+1), dW + (i+1)*uP, uP, dW + i*uP) ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::factorizeLU() - For this current matrix, factorize it into 
+ *	two matrices L and U, where L is a lower diagonal matrix, and U is an 
+ *	upper diagonal matrix, such that this matrix A = L*U ;
+ *
+ *	To save space, this takes the current matrix and actually modifies it so that it
+ *	end up holding both the L and U diagonal values within it when done.
+ *
+ *	This does so with partial (aka row) pivoting on the biggest |a[i][k]|.
+ *	uPivots is an array of values that will hold what row index each row was swaped to.
+ *	ie: if row 3 was swapped to row 6, then uPivots[3] = 6  (assuming 0...n)
+ *
+ *	It's done in blocks of LUBLOCK cols (right-looking).  A panel of cols is 
+ *	factored, then the cols to the right of it are brought up to date in 
+ *	LUCOLBLOCK wide strips so the panel rows being read stay in cache.  Each
+ *	element still gets the same updates in the same order as the plain 
+ *	triple loop, so the answer doesn't change, it's just much faster for big N.
+ *
+ *	Returns 1 on success, 0 on error
+ */
+bool MatrixNN::factorizeLU(unsigned uPivots[])
+{
+	if (uDimension == 0 || ptrDbl == NULL)
+		return false ;
+
+	if (!luFactor(ptrDbl, uDimension, uPivots))
+		{
+		cout << "Cannot MatrixNN::factorizeLU(), A has become=" << (*this) << endl ;
+		return false ;
+		}
+
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * solveLU() - Do an actual LU solve on this Matrix.  This is for the case
+ *		where this matrix A is a set of linear equations such that Ax = b
+ *		and we want to solve for x.
+ *
+ *		Returns true on success, false otherwise.  Length of b is assumed to
+ *			be allocated to same as dimension of matrix as is length of x
+ */
+bool MatrixNN::solveLU(double b[], double x[])
+{
+	double *dB = NULL ;
+	unsigned *uPivots = NULL ;
+	dB = new double [uDimension] ;	// Alloc array of orig values of b
+	if (dB == NULL)
+		return false ;
+	uPivots = new unsigned [uDimension] ;	// Alloc pivot array
+	if (uPivots == NULL)
+		{
+		delete [] dB ;
+		return false ;
+		}
+
+	bool bSolve = solveLU(b, x, dB, uPivots) ;
+
+	delete [] dB ;
+	delete [] uPivots ;
+
+	return bSolve ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * solveLU() - Same as above, but the caller hands in the work space so nothing
+ *		is alloced.  dB and uPivots must both be at least dimension long.
+ */
+bool MatrixNN::solveLU(double b[], double x[], double dB[], unsigned uPivots[])
+{
+	MatrixNN &A = (*this) ;	// Easier to work with...
+
+	// Factorize A in to an L and U matrix, that is stored back on top of what A was...
+	// Return false if factorization failed...
+	bool bFac = A.factorizeLU(uPivots) ;
+	if (!bFac)
+		return bFac ;
+
+	return substituteLU(uPivots, b, x, dB) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * substituteLU() - Once this matrix holds the L and U from factorizeLU(), solves 
+ *		Ax = b by forward then back substitution.  Can be called for as many b's
+ *		as wanted without factoring again.  dB is work space, dimension long.
+ *		b and x may be the same array.
+ */
+bool MatrixNN::substituteLU(const unsigned uPivots[], const double b[], double x[], double dB[]) const
+{
+	if (uDimension == 0 || ptrDbl == NULL)
+		return false ;
+
+	luSubstitute(ptrDbl, uDimension, uPivots, b, x, dB) ;
+	return true ;
+}
+
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::factorizeLDLT() - For a symmetric positive definite matrix, factorize it
+ *	into L * D * L^T where L is unit lower triangular and D is diagonal.  Needs 
+ *	about half the work of factorizeLU() and no pivoting.  Blocked the same way,
+ *	see ldltFactor().
+ *
+ *	Only the lower triangle (and diagonal) is read.  When done the strict lower 
+ *	triangle holds L and the diagonal holds D.  The strict upper triangle is used 
+ *	as work space, so it is garbage after.
+ *
+ *	Returns false if a D value comes out <= 0, ie: the matrix isn't SPD.
+ */
+bool MatrixNN::factorizeLDLT(void)
+{
+	if (uDimension == 0 || ptrDbl == NULL)
+		return false ;
+
+	return ldltFactor(ptrDbl, uDimension) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNN::substituteLDLT() - Once this matrix holds the L and D from factorizeLDLT(), 
+ *		solves Ax = b.  Nothing is alloced, b and x may be the same array.
+ */
+bool MatrixNN::substituteLDLT(const double b[], double x[]) const
+{
+	if (uDimension == 0 || ptrDbl == NULL)
+		return false ;
+
+	ldltSubstitute(ptrDbl, uDimension, b, x) ;
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNNFactor::MatrixNNFactor() - constructor
+ */
+MatrixNNFactor::MatrixNNFactor()
+{
+	uDimension = 0 ;
+	ptrPacked = NULL ;
+	ptrPivots = NULL ;
+	ptrWork = NULL ;
+	ptrPanel = NULL ;
+	bLDLT = false ;
+	bFactored = false ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNNFactor::~MatrixNNFactor() - Destructor
+ */
+MatrixNNFactor::~MatrixNNFactor()
+{
+	free() ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNNFactor::free() - Frees any alloced memory
+ */
+void MatrixNNFactor::free(void)
+{
+	matFac.free() ;
+	uDimension = 0 ;
+	if (ptrPacked != NULL)
+		delete [] ptrPacked ;
+	ptrPacked = NULL ;
+	if (ptrPivots != NULL)
+		delete [] ptrPivots ;
+	ptrPivots = NULL ;
+	if (ptrWork != NULL)
+		delete [] ptrWork ;
+	ptrWork = NULL ;
+	if (ptrPanel != NULL)
+		delete [] ptrPanel ;
+	ptrPanel = NULL ;
+	bLDLT = false ;
+	bFactored = false ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNNFactor::alloc() - Makes room for a uDim x uDim system.  Only reallocs 
+ *		if the size changed, either way it is no longer factored.  Returns false 
+ *		if out of memory.
+ */
+bool MatrixNNFactor::alloc(unsigned uDim)
+{
+	bFactored = false ;
+	if (matFac.uDimension == uDim && ptrPivots != NULL)
+		return true ;
+
+	free() ;		// Also throws out any packed LDL^T factors
+	if (matFac.setDimension(uDim) != uDim)
+		return false ;
+	uDimension = uDim ;
+	ptrPivots = new unsigned [uDim] ;
+	ptrWork = new double [uDim] ;
+	ptrPanel = new double [uDim * MATRIXNN_PANEL * 2] ;
+	if (ptrPivots == NULL || ptrWork == NULL || ptrPanel == NULL)
+		{
+		free() ;
+		return false ;
+		}
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNNFactor::factorizeLU() - LU factors whatever the caller filled into 
+ *		matFac, in place.
+ */
+bool MatrixNNFactor::factorizeLU(void)
+{
+	bLDLT = false ;
+	bFactored = false ;
+	if (ptrPivots == NULL)
+		return false ;
+	bFactored = matFac.factorizeLU(ptrPivots) ;
+	return bFactored ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNNFactor::factorizeLDLT() - LDL^T factors whatever the caller filled into 
+ *		matFac, in place, then packs the factors so only half the storage is
+ *		kept.  If this fails matFac is garbage, refill before trying LU.
+ */
+bool MatrixNNFactor::factorizeLDLT(void)
+{
+	bLDLT = true ;
+	bFactored = matFac.factorizeLDLT() ;
+	if (bFactored)
+		pack() ;
+	return bFactored ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNNFactor::pack() - Copies the lower triangle and diagonal of matFac into
+ *		ptrPacked a row at a time and frees matFac.  If out of memory matFac is
+ *		just kept, solve() works from either.
+ */
+void MatrixNNFactor::pack(void)
+{
+	unsigned uN = matFac.uDimension ;
+	ptrPacked = new double [uN * (uN + 1) / 2] ;
+	if (ptrPacked == NULL)
+		return ;
+
+	unsigned i,j ;
+	double *ptrDst = ptrPacked ;
+	for (i=0; i < uN; ++i)
+		{
+		const double *ptrRow = matFac[i] ;
+		for (j=0; j <= i; ++j)
+			*ptrDst++ = ptrRow[j] ;
+		}
+	matFac.free() ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNNFactor::factorize() - Copies matA in and LU factors it.  matA is left alone.
+ */
+bool MatrixNNFactor::factorize(const MatrixNN &matA)
+{
+	unsigned uDim = matA.uDimension ;
+	if (!alloc(uDim) || uDim == 0)
+		return false ;
+
+	unsigned u ;
+	unsigned uTotal = uDim * uDim ;
+	for (u=0; u < uTotal; ++u)
+		matFac.ptrDbl[u] = matA.ptrDbl[u] ;
+
+	return factorizeLU() ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * factorizeFixedN() - Does MatrixNNFactor::factorizeFixed() for one size, in place
+ *		on matFac.  The factors stay in matFac rather than a MatrixN on the stack
+ *		since they are kept and solved against frame after frame, and copying
+ *		them in and back out measured slower than the factoring itself saves
+ *		at these sizes (see bench/fixedBench.cpp).  Only a copy of A is kept on 
+ *		the stack, so if LDL^T fails LU can be tried right away.
+ */
+template<unsigned N>
+static bool factorizeFixedN(MatrixNN &matFac, unsigned uPivots[], bool &bLDLT)
+{
+	MatrixN<N> matOrig ;
+	matOrig.load(matFac) ;
+
+	bLDLT = true ;
+	if (MatrixN<N>::factorizeLDLT( MatrixN<N>::rowsOf(matFac) ))
+		return true ;
+
+	bLDLT = false ;
+	matOrig.store(matFac) ;		// LDL^T wrote over it.
+	return MatrixN<N>::factorizeLU( MatrixN<N>::rowsOf(matFac), uPivots ) ;
+}
+
+// ---------------------------------------------------------------------------
+
+#define FIXEDCASE(N)	case N: bFactored = factorizeFixedN<N>(matFac, ptrPivots, bLDLT) ; break ;
+
+/*
+ * MatrixNNFactor::factorizeFixed() - For small matrices.  Tries LDL^T and then LU
+ *		on whatever was filled into matFac, using the fixed size MatrixN code
+ *		for this dimension.  If both fail matFac is garbage.  Gives the same 
+ *		factors as factorizeLDLT() or factorizeLU() would, just faster, but 
+ *		they stay square in matFac.  Returns false if both fail or the
+ *		dimension is over MATRIXN_MAX.
+ */
+bool MatrixNNFactor::factorizeFixed(void)
+{
+	bLDLT = false ;
+	bFactored = false ;
+	if (ptrPivots == NULL)
+		return false ;
+
+	switch (matFac.uDimension)
+		{
+		FIXEDCASE(1)  FIXEDCASE(2)  FIXEDCASE(3)  FIXEDCASE(4)
+		FIXEDCASE(5)  FIXEDCASE(6)  FIXEDCASE(7)  FIXEDCASE(8)
+		FIXEDCASE(9)  FIXEDCASE(10) FIXEDCASE(11) FIXEDCASE(12)
+		FIXEDCASE(13) FIXEDCASE(14) FIXEDCASE(15) FIXEDCASE(16)
+		FIXEDCASE(17) FIXEDCASE(18) FIXEDCASE(19) FIXEDCASE(20)
+		FIXEDCASE(21) FIXEDCASE(22) FIXEDCASE(23) FIXEDCASE(24)
+		}
+
+	return bFactored ;
+}
+
+#undef FIXEDCASE
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNNFactor::solvePanel() - Solves the uP b's side by side in dIn's rows into
+ *		dOut's rows, with whichever factorization we have.
+ */
+bool MatrixNNFactor::solvePanel(const double *dIn, double *dOut, unsigned uP)
+{
+	unsigned uN = uDimension ;
+	if (!bLDLT)
+		{
+		luSubstitutePanel(matFac.ptrDbl, uN, ptrPivots, dIn, dOut, uP) ;
+		return true ;
+		}
+
+	unsigned u ;
+	for (u=0; u < uN * uP; ++u)
+		dOut[u] = dIn[u] ;
+	if (ptrPacked != NULL)
+		ldltSubstitutePackedPanel(ptrPacked, uN, dOut, uP, ptrWork) ;
+	else
+		ldltSubstitutePanel(matFac.ptrDbl, uN, dOut, uP, ptrWork) ;
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNNFactor::solve() - Solves Ax = b with whichever factorization we have.
+ */
+bool MatrixNNFactor::solve(const double b[], double x[])
+{
+	if (!bFactored)
+		return false ;
+	if (bLDLT && ptrPacked != NULL)
+		{
+		ldltSubstitutePacked(ptrPacked, uDimension, b, x) ;
+		return true ;
+		}
+	if (bLDLT)
+		return matFac.substituteLDLT(b, x) ;
+	return matFac.substituteLU(ptrPivots, b, x, ptrWork) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNNFactor::solve() - Solves for uRHS right hand sides at once.  B holds them
+ *		one after the other, each dimension long, and X gets the answers the same 
+ *		way.  B and X may be the same array.  They're done MATRIXNN_PANEL at a time,
+ *		turned side by side so each row of the factors is read once per panel 
+ *		and runs down a whole panel row, instead of once per b.  Each answer 
+ *		is the same as solving its b on its own.
+ */
+bool MatrixNNFactor::solve(const double B[], double X[], unsigned uRHS)
+{
+	if (!bFactored)
+		return false ;
+
+	unsigned uDim = uDimension ;
+	double *dIn = ptrPanel ;
+	double *dOut = ptrPanel + uDim * MATRIXNN_PANEL ;
+	unsigned r, i ;
+	unsigned uFirst ;
+	for (uFirst=0; uFirst < uRHS; uFirst += MATRIXNN_PANEL)
+		{
+		unsigned uP = uRHS - uFirst ;
+		if (uP > MATRIXNN_PANEL)
+			uP = MATRIXNN_PANEL ;
+
+		for (r=0; r < uP; ++r)
+			{
+			const double *ptrB = B + (uFirst+r)*uDim ;
+			for (i=0; i < uDim; ++i)
+				dIn[i*uP+r] = ptrB[i] ;
+			}
+
+		if (!solvePanel(dIn, dOut, uP))
+			return false ;
+
+		for (r=0; r < uP; ++r)
+			{
+			double *ptrX = X + (uFirst+r)*uDim ;
+			for (i=0; i < uDim; ++i)
+				ptrX[i] = dOut[i*uP+r] ;
+			}
+		}
+
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixNNFactor::solve() - Every row of matB is solved for and the answer put
+ *		into the same row of matX, ie: X^T = A^-1 B^T.  matX must already be the
+ *		same size, and may be matB.
+ */
+bool MatrixNNFactor::solve(const MatrixNN &matB, MatrixNN &matX)
+{
+	unsigned uDim = uDimension ;
+	if (matB.uDimension != uDim || matX.uDimension != uDim)
+		return false ;
+
+	return solve(matB.ptrDbl, matX.ptrDbl, uDim) ;
+}
+
+// ---------------------------------------------------------------------------
+
+
+
+/*
+ * MatrixSkyline::MatrixSkyline() - constructor
+ */
+MatrixSkyline::MatrixSkyline()
+{
+	uDimension = 0 ;
+	ptrPerm = NULL ;
+	ptrInv = NULL ;
+	ptrFirst = NULL ;
+	ptrStart = NULL ;
+	ptrEnv = NULL ;
+	uEnvelope = 0 ;
+	ptrWork = NULL ;
+	bFactored = false ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixSkyline::~MatrixSkyline() - Destructor
+ */
+MatrixSkyline::~MatrixSkyline()
+{
+	free() ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixSkyline::free() - Frees any alloced memory
+ */
+void MatrixSkyline::free(void)
+{
+	if (ptrPerm != NULL)
+		delete [] ptrPerm ;
+	ptrPerm = NULL ;
+	if (ptrInv != NULL)
+		delete [] ptrInv ;
+	ptrInv = NULL ;
+	if (ptrFirst != NULL)
+		delete [] ptrFirst ;
+	ptrFirst = NULL ;
+	if (ptrStart != NULL)
+		delete [] ptrStart ;
+	ptrStart = NULL ;
+	if (ptrEnv != NULL)
+		delete [] ptrEnv ;
+	ptrEnv = NULL ;
+	if (ptrWork != NULL)
+		delete [] ptrWork ;
+	ptrWork = NULL ;
+	uDimension = 0 ;
+	uEnvelope = 0 ;
+	bFactored = false ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixSkyline::setPattern() - Sizes the matrix for uDim rows from a neighbour
+ *		list: row i's off diagonal non zeros are the cols uNbr[uNbrStart[i]] up to
+ *		uNbr[uNbrStart[i+1]], listed from both sides.  Orders the rows with reverse
+ *		Cuthill-McKee, seeding each connected piece from its lowest degree row, 
+ *		then allocs the envelope and zeroes it.  Returns false if out of memory.
+ */
+bool MatrixSkyline::setPattern(unsigned uDim, const unsigned *uNbrStart, const unsigned *uNbr)
+{
+	free() ;
+	if (uDim == 0)
+		return true ;
+
+	ptrPerm = new unsigned [uDim] ;
+	ptrInv = new unsigned [uDim] ;
+	ptrFirst = new unsigned [uDim] ;
+	ptrStart = new unsigned [uDim+1] ;
+	ptrWork = new double [uDim] ;
+	unsigned *uByDeg = new unsigned [uDim] ;
+	unsigned *uCount = new unsigned [uDim+1] ;
+	if (ptrPerm == NULL || ptrInv == NULL || ptrFirst == NULL || ptrStart == NULL || 
+		ptrWork == NULL || uByDeg == NULL || uCount == NULL)
+		{
+		if (uByDeg != NULL)
+			delete [] uByDeg ;
+		if (uCount != NULL)
+			delete [] uCount ;
+		free() ;
+		return false ;
+		}
+	uDimension = uDim ;
+
+	unsigned i, k, d ;
+
+	// Counting sort the rows by degree.
+	for (d=0; d <= uDim; ++d)
+		uCount[d] = 0 ;
+	for (i=0; i < uDim; ++i)
+		{
+		d = uNbrStart[i+1] - uNbrStart[i] ;
+		++uCount[ (d < uDim) ? d : uDim ] ;
+		}
+	unsigned uPos = 0 ;
+	for (d=0; d <= uDim; ++d)
+		{
+		unsigned uNum = uCount[d] ;
+		uCount[d] = uPos ;
+		uPos += uNum ;
+		}
+	for (i=0; i < uDim; ++i)
+		{
+		d = uNbrStart[i+1] - uNbrStart[i] ;
+		uByDeg[ uCount[ (d < uDim) ? d : uDim ]++ ] = i ;
+		}
+
+	// Cuthill-McKee, breadth first with each row's new neighbours in increasing
+	// degree.  ptrPerm is the queue, ptrInv == uDim means not reached yet.
+	for (i=0; i < uDim; ++i)
+		ptrInv[i] = uDim ;
+
+	unsigned uOrdered = 0 ;
+	unsigned s ;
+	for (s=0; s < uDim; ++s)
+		{
+		unsigned uSeed = uByDeg[s] ;
+		if (ptrInv[uSeed] != uDim)
+			continue ;
+		ptrInv[uSeed] = uOrdered ;
+		ptrPerm[uOrdered++] = uSeed ;
+
+		unsigned uHead ;
+		for (uHead=uOrdered-1; uHead < uOrdered; ++uHead)
+			{
+			unsigned uRow = ptrPerm[uHead] ;
+			unsigned uNew = uOrdered ;
+			for (k=uNbrStart[uRow]; k < uNbrStart[uRow+1]; ++k)
+				{
+				unsigned uCol = uNbr[k] ;
+				if (uCol < uDim && ptrInv[uCol] == uDim)
+					{
+					ptrInv[uCol] = uOrdered ;
+					ptrPerm[uOrdered++] = uCol ;
+					}
+				}
+
+			// Only a handful each time, so insertion sort them.
+			for (k=uNew+1; k < uOrdered; ++k)
+				{
+				unsigned uIns = ptrPerm[k] ;
+				unsigned uInsDeg = uNbrStart[uIns+1] - uNbrStart[uIns] ;
+				unsigned m = k ;
+				while (m > uNew && uNbrStart[ptrPerm[m-1]+1] - uNbrStart[ptrPerm[m-1]] > uInsDeg)
+					{
+					ptrPerm[m] = ptrPerm[m-1] ;
+					--m ;
+					}
+				ptrPerm[m] = uIns ;
+				}
+			}
+		}
+
+	delete [] uByDeg ;
+	delete [] uCount ;
+
+	// ...reversed, which gives a smaller envelope than forward.
+	for (i=0; i < uDim/2; ++i)
+		{
+		unsigned uSwap = ptrPerm[i] ;
+		ptrPerm[i] = ptrPerm[uDim-1-i] ;
+		ptrPerm[uDim-1-i] = uSwap ;
+		}
+	for (i=0; i < uDim; ++i)
+		ptrInv[ ptrPerm[i] ] = i ;
+
+	// Now the envelope, each row from its lowest neighbour to the diagonal.
+	uPos = 0 ;
+	for (i=0; i < uDim; ++i)
+		{
+		unsigned uRow = ptrPerm[i] ;
+		unsigned uFirst = i ;
+		for (k=uNbrStart[uRow]; k < uNbrStart[uRow+1]; ++k)
+			{
+			if (uNbr[k] < uDim && ptrInv[uNbr[k]] < uFirst)
+				uFirst = ptrInv[uNbr[k]] ;
+			}
+		ptrFirst[i] = uFirst ;
+		ptrStart[i] = uPos ;
+		uPos += i - uFirst + 1 ;
+		}
+	ptrStart[uDim] = uPos ;
+
+	ptrEnv = new double [uPos] ;
+	if (ptrEnv == NULL)
+		{
+		free() ;
+		return false ;
+		}
+	uEnvelope = uPos ;
+	for (k=0; k < uPos; ++k)
+		ptrEnv[k] = 0.0 ;
+
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixSkyline::set() - Sets A[i][j] and A[j][i], i and j in the original order.
+ *		Anything outside the pattern given to setPattern() is ignored.
+ */
+void MatrixSkyline::set(unsigned i, unsigned j, double dVal)
+{
+	if (i >= uDimension || j >= uDimension)
+		return ;
+
+	unsigned uRow = ptrInv[i] ;
+	unsigned uCol = ptrInv[j] ;
+	if (uCol > uRow)
+		{
+		unsigned uSwap = uRow ;
+		uRow = uCol ;
+		uCol = uSwap ;
+		}
+	if (uCol < ptrFirst[uRow])
+		return ;
+
+	ptrEnv[ ptrStart[uRow] + uCol - ptrFirst[uRow] ] = dVal ;
+	bFactored = false ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixSkyline::factorizeLDLT() - Row by row LDL^T of the envelope, in place.  
+ *		Each row first gets L[r][c]*D[c], which only needs the part of rows r 
+ *		and c both store, then is divided thru by D.  Returns false if a D value 
+ *		comes out <= 0.
+ */
+bool MatrixSkyline::factorizeLDLT(void)
+{
+	bFactored = false ;
+	if (ptrEnv == NULL)
+		return false ;
+
+	unsigned r, c, k ;
+	for (r=0; r < uDimension; ++r)
+		{
+		unsigned uFirstR = ptrFirst[r] ;
+		double *ptrRowR = ptrEnv + ptrStart[r] ;		// Col c is at ptrRowR[c - uFirstR]
+
+		for (c=uFirstR; c < r; ++c)
+			{
+			unsigned uFirstC = ptrFirst[c] ;
+			const double *ptrRowC = ptrEnv + ptrStart[c] ;
+			unsigned uK = (uFirstR > uFirstC) ? uFirstR : uFirstC ;
+			double dVal = ptrRowR[c - uFirstR] ;
+			for (k=uK; k < c; ++k)
+				dVal = dVal - ( ptrRowR[k - uFirstR] * ptrRowC[k - uFirstC] ) ;
+			ptrRowR[c - uFirstR] = dVal ;
+			}
+
+		double dD = ptrRowR[r - uFirstR] ;
+		for (c=uFirstR; c < r; ++c)
+			{
+			double dLD = ptrRowR[c - uFirstR] ;
+			double dL = dLD / ptrEnv[ptrStart[c+1] - 1] ;
+			dD = dD - ( dLD * dL ) ;
+			ptrRowR[c - uFirstR] = dL ;
+			}
+
+		if (!(dD > 0.0))		// Also catches NaN
+			return false ;
+		ptrRowR[r - uFirstR] = dD ;
+		} // end of r rows
+
+	bFactored = true ;
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * MatrixSkyline::solve() - Once factored, solves Ax = b.  Nothing is alloced, 
+ *		b and x may be the same array.
+ */
+bool MatrixSkyline::solve(const double b[], double x[])
+{
+	if (!bFactored)
+		return false ;
+
+	unsigned r, c ;
+	double *dW = ptrWork ;
+	for (r=0; r < uDimension; ++r)
+		dW[r] = b[ ptrPerm[r] ] ;
+
+	// Solve L y = b, then D z = y
+	for (r=0; r < uDimension; ++r)
+		{
+		unsigned uFirstR = ptrFirst[r] ;
+		const double *ptrRowR = ptrEnv + ptrStart[r] ;
+		double dVal = dW[r] ;
+		for (c=uFirstR; c < r; ++c)
+			dVal = dVal - ( ptrRowR[c - uFirstR] * dW[c] ) ;
+		dW[r] = dVal ;
+		}
+	for (r=0; r < uDimension; ++r)
+		dW[r] = dW[r] / ptrEnv[ptrStart[r+1] - 1] ;
+
+	// Solve L^T x = z, going up the rows and taking each answer out of the rows above
+	for (r=uDimension; r > 0; --r)
+		{
+		unsigned uFirstR = ptrFirst[r-1] ;
+		const double *ptrRowR = ptrEnv + ptrStart[r-1] ;
+		double dX = dW[r-1] ;
+		for (c=uFirstR; c < r-1; ++c)
+			dW[c] = dW[c] - ( ptrRowR[c - uFirstR] * dX ) ;
+		}
+
+	for (r=0; r < uDimension; ++r)
+		x[ ptrPerm[r] ] = dW[r] ;
+
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
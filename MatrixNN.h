@@ -1,102 +1,212 @@
-// ---------------------------------------------------------------------------
-// MatrixNN.h - C++ Header File
-// Copyright 2004 Michael B. Comet
-// ---------------------------------------------------------------------------
-//
-// DESCRIPTION:
-//	A plugin class to do stuff with square NxN matrices.
-//
-// AUTHOR:
-//	Michel B. Comet - comet@comet-cartoons.com
-//
-// VERSIONS:
-//	1.05 - 10/12/04 - mcomet - First Version of this file.
-//	1.06 - 10/16/04 - mcomet - Added mirrorData node to help with mirroring.
-//	1.07 - 11/03/04 - mcomet - Now only uses membership points when creating
-//				targets, also put in missing scripts to ZIP file.
-//  1.09c - 12/01/04 - mcomet - Now has option for joint-space vs. pose-space
-//				deformation.  So that the sculpt is either tied to the joint
-//				or the reader as it is brought back up.
-//	1.10 - 01/21/05 - mcomet - Fix for wig out mesh when pose deleted.
-//	
-// ---------------------------------------------------------------------------
-//
-//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
-//  Copyright 2004 Michael B. Comet
-//
-//   This program is free software; you can redistribute it and/or modify
-//   it under the terms of the GNU General Public License as published by
-//   the Free Software Foundation; either version 2 of the License, or
-//   (at your option) any later version.
-//
-//   This program is distributed in the hope that it will be useful,
-//   but WITHOUT ANY WARRANTY; without even the implied warranty of
-//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-//   GNU General Public License for more details.
-//
-//   You should have received a copy of the GNU General Public License
-//   along with this program; if not, write to the Free Software
-//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
-//
-//   For information on poseDeformer contact:
-//			Michael B. Comet - comet@comet-cartoons.com
-//			or visit http://www.comet-cartooons.com/toons/
-//
-// --------------------------------------------------------------------------
-
-#ifndef __MATRIXNN_H
-#define __MATRIXNN_H
-
-/*
- * Includes
- */ 
-#include <math.h>
-#include <ostream>
-#include <iostream>
-#include <fstream>
-using namespace::std ;
-
-// ---------------------------------------------------------------------------
-
-
-/*
- * MatrixNN - Class Definition
- *
- *	i=row j=col
- *			 j=0  j=1  j=2  ... j=n
- *		i=0
- *		i=1
- *		i=2
- *		...
- *		i=n
- */
-class MatrixNN
-{
-public:
-	MatrixNN();
-	virtual	~MatrixNN();
-
-public:
-	double *ptrDbl ;			// ptr to actual data of double.
-	unsigned uDimension ;		// For the NxN matrix, what size is N?
-	void free(void) ;			// Free any alloced memory
-	unsigned setDimension(unsigned uDim) ;		// Set the array size/alloc it.
-	unsigned getDimension(void) ;	// What is size?
-	void fill(double dVal=0) ;		// Fill array to values Default=0
-	inline unsigned getIndex(unsigned i, unsigned j) ;	// Get index into array for i,j
-	void identity(void) ;			// Set to identity matrix.
-
-	double* operator[](unsigned i) ;
-	const double* operator[](unsigned i) const ;
-	double& operator()(unsigned i, unsigned j) ;
-	double operator()(unsigned i, unsigned j) const ;
-	friend ostream& operator<<(ostream &os, const MatrixNN &matNN) ;
-	MatrixNN& operator=(const MatrixNN &matNN) ;
-	bool factorizeLU(unsigned uPivots[]) ;
-	bool solveLU(double b[], double x[]) ;
-} ;
-
-
-// ---------------------------------------------------------------------------
-
-#endif // end of __MATRIXNN_H
+// ---------------------------------------------------------------------------
+// MatrixNN.h - C++ Header File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	A plugin class to do stuff with square NxN matrices.
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// VERSIONS:
+//	1.05 - 10/12/04 - mcomet - First Version of this file.
+//	1.06 - 10/16/04 - mcomet - Added mirrorData node to help with mirroring.
+//	1.07 - 11/03/04 - mcomet - Now only uses membership points when creating
+//				targets, also put in missing scripts to ZIP file.
+//  1.09c - 12/01/04 - mcomet - Now has option for joint-space vs. pose-space
+//				deformation.  So that the sculpt is either tied to the joint
+//				or the reader as it is brought back up.
+//	1.10 - 01/21/05 - mcomet - Fix for wig out mesh when pose deleted.
+//	
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+#ifndef __MATRIXNN_H
+#define __MATRIXNN_H
+
+/*
+ * Includes
+ */ 
+#include <math.h>
+#include <ostream>
+#include <iostream>
+#include <fstream>
+using namespace::std ;
+
+// ---------------------------------------------------------------------------
+
+#define MATRIXNN_INLINE		4		// Up to this N is stored inside the object, no heap
+#define MATRIXNN_ALIGN		64		// Heap storage starts on a cache line, good for SIMD
+#define MATRIXNN_PANEL		16		// Right hand sides the multi solve does at once
+
+
+/*
+ * MatrixNN - Class Definition
+ *
+ *	i=row j=col
+ *			 j=0  j=1  j=2  ... j=n
+ *		i=0
+ *		i=1
+ *		i=2
+ *		...
+ *		i=n
+ */
+class MatrixNN
+{
+public:
+	MatrixNN();
+	MatrixNN(const MatrixNN &matNN);
+	MatrixNN(MatrixNN &&matNN);
+	virtual	~MatrixNN();
+
+public:
+	double *ptrDbl ;			// ptr to actual data of double.  dInline or somewhere in ptrHeap.
+	unsigned uDimension ;		// For the NxN matrix, what size is N?
+	double *ptrHeap ;			// What new[] really gave us, NULL if not on the heap
+	unsigned uCapacity ;		// How many doubles ptrDbl has room for
+	double dInline[MATRIXNN_INLINE*MATRIXNN_INLINE] ;	// Storage for small matrices
+	static unsigned uAllocCount ;	// How many heap allocs every MatrixNN has done.  Debug only, not thread safe.
+
+	void free(void) ;			// Free any alloced memory
+	unsigned setDimension(unsigned uDim) ;		// Set the array size/alloc it.  Values are NOT set.
+	unsigned getDimension(void) ;	// What is size?
+	void fill(double dVal=0) ;		// Fill array to values Default=0
+	inline unsigned getIndex(unsigned i, unsigned j) ;	// Get index into array for i,j
+	void identity(void) ;			// Set to identity matrix.
+
+	double* operator[](unsigned i) ;
+	const double* operator[](unsigned i) const ;
+	double& operator()(unsigned i, unsigned j) ;
+	double operator()(unsigned i, unsigned j) const ;
+	friend ostream& operator<<(ostream &os, const MatrixNN &matNN) ;
+	MatrixNN& operator=(const MatrixNN &matNN) ;
+	MatrixNN& operator=(MatrixNN &&matNN) ;
+	bool factorizeLU(unsigned uPivots[]) ;
+	bool solveLU(double b[], double x[]) ;
+	bool solveLU(double b[], double x[], double dB[], unsigned uPivots[]) ;	// No alloc, caller gives work space
+	bool substituteLU(const unsigned uPivots[], const double b[], double x[], double dB[]) const ;	// Solve with an already factored matrix
+	bool factorizeLDLT(void) ;		// Symmetric positive definite only
+	bool substituteLDLT(const double b[], double x[]) const ;	// Solve with an already factored matrix
+
+private:
+	void take(MatrixNN &matNN) ;	// Move matNN's data into this, leaving matNN empty
+} ;
+
+
+
+// ---------------------------------------------------------------------------
+
+
+/*
+ * MatrixNNFactor - Class Definition
+ *
+ *	A factored matrix that can be solved against as many times as wanted.
+ *	Owns its own pivots and work space, so once alloc'd the factorize and
+ *	solve calls don't alloc anything.  The work space is shared between
+ *	calls, so use one of these per thread.
+ *
+ *	The one exception is factorizeLDLT(), which moves L and D out of matFac
+ *	into ptrPacked, half the size, and frees matFac.  A kept LDL^T factorization
+ *	only costs N(N+1)/2 doubles that way.  The next alloc() makes matFac again.
+ */
+class MatrixNNFactor
+{
+public:
+	MatrixNNFactor();
+	virtual	~MatrixNNFactor();
+
+public:
+	MatrixNN matFac ;			// The factored matrix, L and U (or L and D) stored on top of each other
+	unsigned uDimension ;		// N, still set once matFac is freed for ptrPacked
+	double *ptrPacked ;			// LDL^T factors by rows, L[i][0..i-1] then D[i], N(N+1)/2 long.  NULL if not packed
+	unsigned *ptrPivots ;		// Row pivots from factorizeLU()
+	double *ptrWork ;			// Solve work space, dimension long
+	double *ptrPanel ;			// Multi solve work space, 2 panels of dimension x MATRIXNN_PANEL
+	bool bLDLT ;				// True if matFac holds an LDL^T factorization, else LU
+	bool bFactored ;			// True if the last factorize worked
+
+	void free(void) ;			// Free any alloced memory
+	bool alloc(unsigned uDim) ;	// Size for uDim, only reallocs if the size changed
+	unsigned getDimension(void) const { return uDimension ; } ;
+	bool factorizeLU(void) ;		// Factor whatever was filled into matFac
+	bool factorizeLDLT(void) ;		// Same, symmetric positive definite only, then packs it
+	bool factorize(const MatrixNN &matA) ;	// Copy matA in and LU factor it
+	bool factorizeFixed(void) ;		// LDL^T then LU with fixed size loops, in place, dimension <= MATRIXN_MAX only
+	bool solve(const double b[], double x[]) ;	// Ax = b, b and x may be the same array
+	bool solve(const double B[], double X[], unsigned uRHS) ;	// uRHS b's, each dimension long, one after the other
+	bool solve(const MatrixNN &matB, MatrixNN &matX) ;	// Every row of matB is a b, answers go in the rows of matX
+
+private:
+	void pack(void) ;			// Move the LDL^T factors from matFac into ptrPacked
+	bool solvePanel(const double *dIn, double *dOut, unsigned uP) ;	// uP b's side by side in dIn's rows
+} ;
+
+
+// ---------------------------------------------------------------------------
+
+
+/*
+ * MatrixSkyline - Class Definition
+ *
+ *	A sparse symmetric matrix kept as its lower envelope (skyline): each row
+ *	only stores from its first non zero col up to the diagonal, all in one
+ *	array.  LDL^T never fills in outside the envelope, so it is factored in
+ *	place.  setPattern() reorders the rows and cols with reverse Cuthill-McKee
+ *	first, which keeps neighbours close to the diagonal so the envelope only
+ *	grows with how many neighbours each row has rather than with N^2.
+ *
+ *	i and j passed in are always in the caller's original order, the
+ *	reordering is never seen outside.  Symmetric positive definite only.
+ */
+class MatrixSkyline
+{
+public:
+	MatrixSkyline();
+	virtual	~MatrixSkyline();
+
+public:
+	unsigned uDimension ;		// N
+	unsigned *ptrPerm ;			// ptrPerm[row] = original index stored at that row
+	unsigned *ptrInv ;			// ptrInv[original index] = row
+	unsigned *ptrFirst ;		// First col stored for each row
+	unsigned *ptrStart ;		// Where each row starts in ptrEnv, N+1 long
+	double *ptrEnv ;			// Rows of the envelope one after the other, diagonal last
+	unsigned uEnvelope ;		// How many doubles are in ptrEnv
+	double *ptrWork ;			// Solve work space, N long
+	bool bFactored ;			// True if the last factorizeLDLT worked
+
+	void free(void) ;			// Free any alloced memory
+	bool setPattern(unsigned uDim, const unsigned *uNbrStart, const unsigned *uNbr) ;	// Order and alloc from a neighbour list, zeroes it
+	void set(unsigned i, unsigned j, double dVal) ;	// A[i][j] = A[j][i] = dVal, must be in the pattern
+	unsigned getDimension(void) const { return uDimension ; } ;
+	bool factorizeLDLT(void) ;	// In place
+	bool solve(const double b[], double x[]) ;	// Ax = b, b and x may be the same array
+} ;
+
+
+// ---------------------------------------------------------------------------
+
+#endif // end of __MATRIXNN_H
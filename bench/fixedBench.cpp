@@ -0,0 +1,195 @@
+// ---------------------------------------------------------------------------
+// fixedBench.cpp - C++ File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	Standalone benchmark of small RBF matrix factor latency, the 4 to 24
+//	pose rigs most nodes have.  MatrixNNFactor::factorizeFixed(), the fixed
+//	size MatrixN<N> path updateRBFCache() uses up to MATRIXN_MAX, against
+//	the dynamic factorizeLDLT() and factorizeLU() it would use otherwise.
+//	Each call includes copying A back into matFac, since they all work in
+//	place, and is timed over many repeats.  32 is past MATRIXN_MAX, so it
+//	only runs the dynamic ones, to show where they catch up.
+//
+//		g++ -O2 -I.. fixedBench.cpp ../MatrixNN.cpp ../poseDeformerKernel.cpp -o fixedBench
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+/*
+ * Includes
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "MatrixNN.h"
+#include "MatrixN.h"
+
+// ---------------------------------------------------------------------------
+
+#define BENCHREPS		20000	// Factorizations timed per size and path
+
+typedef enum { eBenchFixed, eBenchLDLT, eBenchLU } EBENCHPATH ;
+
+// ---------------------------------------------------------------------------
+
+/*
+ * nowSecs() - Monotonic wall clock in seconds.
+ */
+static double nowSecs(void)
+{
+	struct timespec ts ;
+	clock_gettime(CLOCK_MONOTONIC, &ts) ;
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9 ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * fillRBF() - A Gaussian RBF matrix for uN random unit reader vectors, like
+ *		fillRBFMatrix() makes at the default 45 degree width.
+ */
+static void fillRBF(MatrixNN &matA, unsigned uN)
+{
+	double *dRead = new double [uN * 3] ;
+	unsigned i,j ;
+	for (i=0; i < uN; ++i)
+		{
+		double *dVec = dRead + i * 3 ;
+		double dLen ;
+		do	{
+			dVec[0] = (double)rand() / RAND_MAX * 2.0 - 1.0 ;
+			dVec[1] = (double)rand() / RAND_MAX * 2.0 - 1.0 ;
+			dVec[2] = (double)rand() / RAND_MAX * 2.0 - 1.0 ;
+			dLen = sqrt(dVec[0]*dVec[0] + dVec[1]*dVec[1] + dVec[2]*dVec[2]) ;
+			} while (dLen < 0.1 || dLen > 1.0) ;
+		dVec[0] /= dLen ;
+		dVec[1] /= dLen ;
+		dVec[2] /= dLen ;
+		}
+
+	for (i=0; i < uN; ++i)
+		{
+		for (j=0; j < uN; ++j)
+			{
+			const double *dA = dRead + i * 3 ;
+			const double *dB = dRead + j * 3 ;
+			double dDot = dA[0]*dB[0] + dA[1]*dB[1] + dA[2]*dB[2] ;
+			if (dDot > 1.0)
+				dDot = 1.0 ;
+			if (dDot < -1.0)
+				dDot = -1.0 ;
+			double dDist = acos(dDot) / 3.14159 ;
+			matA[i][j] = exp( -16.0 * dDist * dDist) ;
+			}
+		matA[i][i] += 1e-3 ;
+		}
+
+	delete [] dRead ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * timePath() - Average secs for one copy in + factor with the given path.
+ */
+static double timePath(int nPath, const MatrixNN &matA, MatrixNNFactor &fac)
+{
+	unsigned uN = matA.uDimension ;
+	unsigned uTotal = uN * uN ;
+	unsigned r, u ;
+	bool bOk = true ;
+
+	double dStart = nowSecs() ;
+	for (r=0; r < BENCHREPS; ++r)
+		{
+		if (!fac.alloc(uN))		// Only reallocs when LDL^T packed the last one
+			return -1.0 ;
+		for (u=0; u < uTotal; ++u)
+			fac.matFac.ptrDbl[u] = matA.ptrDbl[u] ;
+
+		if (nPath == (int)eBenchFixed)
+			bOk = fac.factorizeFixed() && bOk ;
+		else if (nPath == (int)eBenchLDLT)
+			bOk = fac.factorizeLDLT() && bOk ;
+		else
+			bOk = fac.factorizeLU() && bOk ;
+		}
+	double dSecs = (nowSecs() - dStart) / BENCHREPS ;
+
+	return bOk ? dSecs : -1.0 ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * main() - N = 4 to MATRIXN_MAX, then 32.
+ */
+int main(int argc, char **argv)
+{
+	srand(1234) ;
+	printf("%4s  %12s %12s %12s  %s\n", "N", "fixed ns", "LDL^T ns", "LU ns", "fixed speedup vs LDL^T") ;
+
+	static const unsigned uSizes[] = { 4, 8, 12, 16, 24, 32 } ;
+	unsigned s ;
+	for (s=0; s < sizeof(uSizes) / sizeof(uSizes[0]); ++s)
+		{
+		unsigned uN = uSizes[s] ;
+		MatrixNN matA ;
+		if (matA.setDimension(uN) != uN)
+			return 1 ;
+		fillRBF(matA, uN) ;
+
+		MatrixNNFactor fac ;
+		double dLDLT = timePath(eBenchLDLT, matA, fac) ;
+		double dLU = timePath(eBenchLU, matA, fac) ;
+		if (dLDLT < 0.0 || dLU < 0.0)
+			{
+			printf("%4u  could not factor\n", uN) ;
+			return 1 ;
+			}
+		if (uN > MATRIXN_MAX)
+			{
+			printf("%4u  %12s %12.0f %12.0f\n", uN, "-", dLDLT * 1e9, dLU * 1e9) ;
+			continue ;
+			}
+
+		double dFixed = timePath(eBenchFixed, matA, fac) ;
+		if (dFixed < 0.0)
+			{
+			printf("%4u  could not factor\n", uN) ;
+			return 1 ;
+			}
+		printf("%4u  %12.0f %12.0f %12.0f  %.1fx\n", uN, dFixed * 1e9, dLDLT * 1e9, dLU * 1e9, dLDLT / dFixed) ;
+		}
+
+	return 0 ;
+}
@@ -0,0 +1,190 @@
+// ---------------------------------------------------------------------------
+// luBench.cpp - C++ File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	Standalone benchmark of the blocked MatrixNN::factorizeLU() against the
+//	plain textbook triple loop LU it replaced, same partial pivoting, for
+//	N = 16 up to 4096.  Both should give the same bits, that's checked too.
+//
+//		g++ -O2 -I.. luBench.cpp ../MatrixNN.cpp ../poseDeformerKernel.cpp -o luBench
+//		./luBench [maxN]
+//
+//	The textbook LU at 4096 takes a while, pass a smaller maxN to skip it.
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+/*
+ * Includes
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "MatrixNN.h"
+
+// ---------------------------------------------------------------------------
+
+#define BENCHMINSECS	0.2		// Small sizes are repeated until this much time went by
+
+// ---------------------------------------------------------------------------
+
+/*
+ * nowSecs() - Monotonic wall clock in seconds.
+ */
+static double nowSecs(void)
+{
+	struct timespec ts ;
+	clock_gettime(CLOCK_MONOTONIC, &ts) ;
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9 ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * textbookLU() - The unblocked LU, column k at a time, every row below it
+ *		updated across the whole rest of the row.  Same pivoting as luFactor().
+ */
+static bool textbookLU(double *a, unsigned uN, unsigned uPivots[])
+{
+	unsigned i,j,k ;
+	for (k=0; k < uN; ++k)
+		uPivots[k] = k ;
+
+	for (k=0; k < uN; ++k)
+		{
+		double dBiggest = fabs(a[k*uN+k]) ;
+		unsigned uIdxPivot = k ;
+		for (i=k+1; i < uN; ++i)
+			{
+			if (fabs(a[i*uN+k]) > dBiggest)
+				{
+				dBiggest = fabs(a[i*uN+k]) ;
+				uIdxPivot = i ;
+				}
+			}
+		unsigned uTemp = uPivots[k] ;
+		uPivots[k] = uPivots[uIdxPivot] ;
+		uPivots[uIdxPivot] = uTemp ;
+		if (uIdxPivot != k)
+			{
+			for (j=0; j < uN; ++j)
+				{
+				double dTemp = a[k*uN+j] ;
+				a[k*uN+j] = a[uIdxPivot*uN+j] ;
+				a[uIdxPivot*uN+j] = dTemp ;
+				}
+			}
+
+		double dPivot = a[k*uN+k] ;
+		if (dPivot == 0)
+			return false ;
+		for (i=k+1; i < uN; ++i)
+			{
+			a[i*uN+k] = a[i*uN+k] / dPivot ;
+			double dL = a[i*uN+k] ;
+			for (j=k+1; j < uN; ++j)
+				a[i*uN+j] = a[i*uN+j] - dL * a[k*uN+j] ;
+			}
+		}
+
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * main() - N = 16 up to maxN, doubling.
+ */
+int main(int argc, char **argv)
+{
+	unsigned uMaxN = (argc > 1) ? (unsigned)atoi(argv[1]) : 4096 ;
+
+	srand(1234) ;
+	printf("%6s  %14s %14s  %8s  %s\n", "N", "textbook ms", "blocked ms", "speedup", "same") ;
+
+	unsigned uN ;
+	for (uN=16; uN <= uMaxN; uN *= 2)
+		{
+		unsigned uTotal = uN * uN ;
+		double *dOrig = new double [uTotal] ;
+		double *dText = new double [uTotal] ;
+		unsigned *uPivText = new unsigned [uN] ;
+		unsigned *uPivBlock = new unsigned [uN] ;
+		MatrixNN matA ;
+		if (dOrig == NULL || dText == NULL || uPivText == NULL || uPivBlock == NULL || matA.setDimension(uN) != uN)
+			{
+			printf("out of memory at N=%u\n", uN) ;
+			return 1 ;
+			}
+
+		unsigned u ;
+		for (u=0; u < uTotal; ++u)
+			dOrig[u] = (double)rand() / RAND_MAX * 2.0 - 1.0 ;
+
+		// Each one repeated until BENCHMINSECS, the copy in is not timed.
+		double dTextSecs = 0.0 ;
+		unsigned uTextReps = 0 ;
+		do	{
+			memcpy(dText, dOrig, sizeof(double) * uTotal) ;
+			double dStart = nowSecs() ;
+			textbookLU(dText, uN, uPivText) ;
+			dTextSecs += nowSecs() - dStart ;
+			++uTextReps ;
+			} while (dTextSecs < BENCHMINSECS) ;
+
+		double dBlockSecs = 0.0 ;
+		unsigned uBlockReps = 0 ;
+		do	{
+			memcpy(matA.ptrDbl, dOrig, sizeof(double) * uTotal) ;
+			double dStart = nowSecs() ;
+			matA.factorizeLU(uPivBlock) ;
+			dBlockSecs += nowSecs() - dStart ;
+			++uBlockReps ;
+			} while (dBlockSecs < BENCHMINSECS) ;
+
+		bool bSame = (memcmp(dText, matA.ptrDbl, sizeof(double) * uTotal) == 0 &&
+				memcmp(uPivText, uPivBlock, sizeof(unsigned) * uN) == 0) ;
+
+		double dText1 = dTextSecs / uTextReps ;
+		double dBlock1 = dBlockSecs / uBlockReps ;
+		printf("%6u  %14.3f %14.3f  %7.1fx  %s\n", uN, dText1 * 1000.0, dBlock1 * 1000.0,
+				dText1 / dBlock1, bSame ? "yes" : "NO") ;
+
+		delete [] dOrig ;
+		delete [] dText ;
+		delete [] uPivText ;
+		delete [] uPivBlock ;
+		}
+
+	return 0 ;
+}
@@ -0,0 +1,416 @@
+// ---------------------------------------------------------------------------
+// precisionBench.cpp - C++ File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	Standalone benchmark of double vs mixed precision for what RBF-Solved
+//	needs, C = A^-1 for big pose sets.  Double is what buildCoef() does,
+//	MatrixNNFactor::factorizeLDLT() then solve() against I a panel at a 
+//	time.  Mixed is a float LU of A, a float solve of all N b's at once, 
+//	then iterative refinement: R = I - A X in double, a float solve for the
+//	correction, until R is down to what a double solve leaves and stops 
+//	shrinking.  Mixed is done here rather than in MatrixNN since it never 
+//	wins, and this is the numbers that say so.  All N b's are done as one
+//	panel with row ops the compiler can vectorize, about the best case 
+//	for Mixed.  Reports times, refinement steps and the biggest |A C - I|.
+//
+//		g++ -O2 -I.. precisionBench.cpp ../MatrixNN.cpp ../poseDeformerKernel.cpp -o precisionBench
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+/*
+ * Includes
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
+#include <time.h>
+
+#include "MatrixNN.h"
+
+// ---------------------------------------------------------------------------
+
+#define BENCHSIGMA		-16.0		// rbfSigma2() of the default 45 degree width
+#define BENCHLAMBDA		1e-3		// rbfRegularize, random poses this close need some
+#define BENCHERRROWS	50			// Rows of C checked against A, it's N^2 each
+#define BENCHMAXREFINE	10			// Most refinement steps before giving up on float
+
+// ---------------------------------------------------------------------------
+
+/*
+ * nowSecs() - Monotonic wall clock in seconds.
+ */
+static double nowSecs(void)
+{
+	struct timespec ts ;
+	clock_gettime(CLOCK_MONOTONIC, &ts) ;
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9 ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * randUnit() - Random unit vector into dVec[3].
+ */
+static void randUnit(double *dVec)
+{
+	double dLen ;
+	do	{
+		dVec[0] = (double)rand() / RAND_MAX * 2.0 - 1.0 ;
+		dVec[1] = (double)rand() / RAND_MAX * 2.0 - 1.0 ;
+		dVec[2] = (double)rand() / RAND_MAX * 2.0 - 1.0 ;
+		dLen = sqrt(dVec[0]*dVec[0] + dVec[1]*dVec[1] + dVec[2]*dVec[2]) ;
+		} while (dLen < 0.1 || dLen > 1.0) ;
+	dVec[0] /= dLen ;
+	dVec[1] /= dLen ;
+	dVec[2] /= dLen ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * fillA() - fillRBFMatrix() with the exact Gaussian, A[i][j] = phi(angle / pi)
+ *		plus BENCHLAMBDA on the diagonal.
+ */
+static void fillA(MatrixNN &matA, const double *dRead, unsigned uPoses)
+{
+	unsigned i,j ;
+	for (i=0; i < uPoses; ++i)
+		{
+		for (j=0; j < uPoses; ++j)
+			{
+			const double *dA = dRead + i * 3 ;
+			const double *dB = dRead + j * 3 ;
+			double dDot = dA[0]*dB[0] + dA[1]*dB[1] + dA[2]*dB[2] ;
+			if (dDot > 1.0)
+				dDot = 1.0 ;
+			if (dDot < -1.0)
+				dDot = -1.0 ;
+			double dDist = acos(dDot) / 3.14159 ;
+			matA[i][j] = exp( BENCHSIGMA * dDist * dDist) ;
+			}
+		matA[i][i] += BENCHLAMBDA ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * floatLU() - Right looking LU with partial pivoting, in float, row ops only.
+ */
+static bool floatLU(float *a, unsigned uN, unsigned uPivots[])
+{
+	unsigned i,j,k ;
+	for (k=0; k < uN; ++k)
+		uPivots[k] = k ;
+
+	for (k=0; k < uN; ++k)
+		{
+		float fBiggest = fabsf(a[k*uN+k]) ;
+		unsigned uIdxPivot = k ;
+		for (i=k+1; i < uN; ++i)
+			{
+			if (fabsf(a[i*uN+k]) > fBiggest)
+				{
+				fBiggest = fabsf(a[i*uN+k]) ;
+				uIdxPivot = i ;
+				}
+			}
+		unsigned uTemp = uPivots[k] ;
+		uPivots[k] = uPivots[uIdxPivot] ;
+		uPivots[uIdxPivot] = uTemp ;
+		if (uIdxPivot != k)
+			{
+			for (j=0; j < uN; ++j)
+				{
+				float fTemp = a[k*uN+j] ;
+				a[k*uN+j] = a[uIdxPivot*uN+j] ;
+				a[uIdxPivot*uN+j] = fTemp ;
+				}
+			}
+
+		float fPivot = a[k*uN+k] ;
+		if (fPivot == 0.0f)
+			return false ;
+		const float *ptrRowK = a + k*uN ;
+		for (i=k+1; i < uN; ++i)
+			{
+			float *ptrRowI = a + i*uN ;
+			ptrRowI[k] = ptrRowI[k] / fPivot ;
+			float fL = ptrRowI[k] ;
+			for (j=k+1; j < uN; ++j)
+				ptrRowI[j] = ptrRowI[j] - fL * ptrRowK[j] ;
+			}
+		}
+
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * floatSolveAll() - X = A^-1 B for N b's side by side, with floatLU()'s factors.
+ *		Row i of dB holds entry i of every b.  Answers go in dX the same way, 
+ *		fWork is N*N floats.
+ */
+static void floatSolveAll(const float *a, unsigned uN, const unsigned uPivots[], const double *dB, double *dX, float *fWork)
+{
+	unsigned i,j,c ;
+	for (i=0; i < uN; ++i)
+		{
+		const double *ptrSrc = dB + uPivots[i]*uN ;
+		float *ptrDst = fWork + i*uN ;
+		for (c=0; c < uN; ++c)
+			ptrDst[c] = (float)ptrSrc[c] ;
+		}
+
+	for (i=1; i < uN; ++i)		// L y = b
+		{
+		float *ptrRowI = fWork + i*uN ;
+		for (j=0; j < i; ++j)
+			{
+			float fL = a[i*uN+j] ;
+			const float *ptrRowJ = fWork + j*uN ;
+			for (c=0; c < uN; ++c)
+				ptrRowI[c] = ptrRowI[c] - fL * ptrRowJ[c] ;
+			}
+		}
+
+	i = uN ;
+	while (i > 0)				// U x = y
+		{
+		--i ;
+		float *ptrRowI = fWork + i*uN ;
+		for (j=i+1; j < uN; ++j)
+			{
+			float fU = a[i*uN+j] ;
+			const float *ptrRowJ = fWork + j*uN ;
+			for (c=0; c < uN; ++c)
+				ptrRowI[c] = ptrRowI[c] - fU * ptrRowJ[c] ;
+			}
+		float fInv = 1.0f / a[i*uN+i] ;
+		for (c=0; c < uN; ++c)
+			ptrRowI[c] = ptrRowI[c] * fInv ;
+		}
+
+	for (i=0; i < uN * uN; ++i)
+		dX[i] = (double)fWork[i] ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * mixedInverse() - matCoef = A^-1 with a float LU and refinement in double, see
+ *		the top.  uIters gets how many refinement steps it took.  Returns false
+ *		if it doesn't converge, where the node would have gone to double.
+ */
+static bool mixedInverse(const MatrixNN &matA, MatrixNN &matCoef, double &dFactor, unsigned &uIters)
+{
+	unsigned uN = matA.uDimension ;
+	unsigned uTotal = uN * uN ;
+	float *fLU = new float [uTotal] ;
+	float *fWork = new float [uTotal] ;
+	double *dR = new double [uTotal] ;
+	double *dC = new double [uTotal] ;
+	unsigned *uPivots = new unsigned [uN] ;
+	unsigned i,k,c ;
+
+	double dStart = nowSecs() ;
+	double dNormA = 0.0 ;
+	for (i=0; i < uN; ++i)
+		{
+		double dSum = 0.0 ;
+		for (c=0; c < uN; ++c)
+			{
+			fLU[i*uN+c] = (float)matA[i][c] ;
+			dSum += fabs(matA[i][c]) ;
+			}
+		if (dSum > dNormA)
+			dNormA = dSum ;
+		}
+	bool bOk = floatLU(fLU, uN, uPivots) ;
+	dFactor = nowSecs() - dStart ;
+
+	if (bOk)
+		{
+		for (i=0; i < uTotal; ++i)
+			dR[i] = 0.0 ;
+		for (i=0; i < uN; ++i)
+			dR[i*uN+i] = 1.0 ;
+		floatSolveAll(fLU, uN, uPivots, dR, matCoef.ptrDbl, fWork) ;
+
+		double dTol = dNormA * DBL_EPSILON * sqrt((double)uN) ;
+		double dLastR = HUGE_VAL ;
+		bOk = false ;
+		for (uIters=0; uIters < BENCHMAXREFINE; ++uIters)
+			{
+			// R = I - A X, a row of A at a time against the rows of X.
+			double dNormR = 0.0 ;
+			double dNormX = 0.0 ;
+			for (i=0; i < uN; ++i)
+				{
+				double *ptrR = dR + i*uN ;
+				for (c=0; c < uN; ++c)
+					ptrR[c] = (i == c) ? 1.0 : 0.0 ;
+				for (k=0; k < uN; ++k)
+					{
+					double dA = matA[i][k] ;
+					const double *ptrX = matCoef[k] ;
+					for (c=0; c < uN; ++c)
+						ptrR[c] = ptrR[c] - dA * ptrX[c] ;
+					}
+				for (c=0; c < uN; ++c)
+					{
+					if (fabs(ptrR[c]) > dNormR)
+						dNormR = fabs(ptrR[c]) ;
+					if (fabs(matCoef[i][c]) > dNormX)
+						dNormX = fabs(matCoef[i][c]) ;
+					}
+				}
+
+			bool bSmall = (dNormR <= dNormX * dTol) ;
+			if (bSmall && !(dNormR < dLastR * 0.5))
+				{
+				bOk = true ;
+				break ;
+				}
+			if (!(dNormR < dLastR))
+				{
+				bOk = bSmall ;
+				break ;
+				}
+			dLastR = dNormR ;
+
+			floatSolveAll(fLU, uN, uPivots, dR, dC, fWork) ;
+			for (i=0; i < uTotal; ++i)
+				matCoef.ptrDbl[i] += dC[i] ;
+			}
+		}
+
+	delete [] fLU ;
+	delete [] fWork ;
+	delete [] dR ;
+	delete [] dC ;
+	delete [] uPivots ;
+	return bOk ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * coefErr() - Biggest |A C - I| over the first BENCHERRROWS rows of C.
+ */
+static double coefErr(const MatrixNN &matA, const MatrixNN &matCoef)
+{
+	unsigned uN = matA.uDimension ;
+	double dErr = 0.0 ;
+	unsigned i,j,k ;
+	for (i=0; i < uN && i < BENCHERRROWS; ++i)
+		{
+		for (j=0; j < uN; ++j)
+			{
+			double dSum = 0.0 ;
+			for (k=0; k < uN; ++k)
+				dSum += matA[j][k] * matCoef[i][k] ;
+			double dDiff = fabs(dSum - ((i == j) ? 1.0 : 0.0)) ;
+			if (dDiff > dErr || dDiff != dDiff)
+				dErr = (dDiff != dDiff) ? HUGE_VAL : dDiff ;
+			}
+		}
+	return dErr ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * main() - 200 up to 2000 poses, or up to maxPoses.
+ */
+int main(int argc, char **argv)
+{
+	unsigned uMaxPoses = (argc > 1) ? (unsigned)atoi(argv[1]) : 2000 ;
+	srand(1234) ;
+
+	printf("Gaussian, width 45 deg, lambda %g\n", BENCHLAMBDA) ;
+	printf("%6s %8s  %10s %10s %10s  %5s  %10s\n", "poses", "mode", "factor ms", "coef ms", "total ms",
+			"iters", "|AC - I|") ;
+
+	static const unsigned uSizes[] = { 200, 500, 1000, 2000 } ;
+	unsigned s, i ;
+	for (s=0; s < sizeof(uSizes) / sizeof(uSizes[0]) && uSizes[s] <= uMaxPoses; ++s)
+		{
+		unsigned uPoses = uSizes[s] ;
+		double *dRead = new double [uPoses * 3] ;
+		MatrixNN matA, matCoef ;
+		MatrixNNFactor facA ;
+		if (dRead == NULL || matA.setDimension(uPoses) != uPoses || 
+			matCoef.setDimension(uPoses) != uPoses || !facA.alloc(uPoses))
+			{
+			printf("out of memory at %u poses\n", uPoses) ;
+			return 1 ;
+			}
+		for (i=0; i < uPoses; ++i)
+			randUnit(dRead + i * 3) ;
+		fillA(matA, dRead, uPoses) ;
+
+		// Double, updateRBFCache() then buildCoef().  The copy in isn't timed.
+		facA.matFac = matA ;
+		double dStart = nowSecs() ;
+		bool bOk = facA.factorizeLDLT() ;
+		double dFactor = nowSecs() - dStart ;
+		dStart = nowSecs() ;
+		if (bOk)
+			{
+			matCoef.identity() ;
+			bOk = facA.solve(matCoef, matCoef) ;
+			}
+		double dCoef = nowSecs() - dStart ;
+		if (!bOk)
+			{
+			printf("%6u %8s  could not solve\n", uPoses, "Double") ;
+			return 1 ;
+			}
+		printf("%6u %8s  %10.2f %10.2f %10.2f  %5s  %10.2e\n", uPoses, "Double", dFactor * 1000.0, 
+				dCoef * 1000.0, (dFactor + dCoef) * 1000.0, "-", coefErr(matA, matCoef)) ;
+
+		// Mixed.
+		unsigned uIters = 0 ;
+		dStart = nowSecs() ;
+		bOk = mixedInverse(matA, matCoef, dFactor, uIters) ;
+		double dTotal = nowSecs() - dStart ;
+		printf("%6u %8s  %10.2f %10.2f %10.2f  %5u  %10.2e%s\n", uPoses, "Mixed", dFactor * 1000.0, 
+				(dTotal - dFactor) * 1000.0, dTotal * 1000.0, uIters, coefErr(matA, matCoef),
+				bOk ? "" : "  did not converge") ;
+
+		delete [] dRead ;
+		}
+
+	return 0 ;
+}
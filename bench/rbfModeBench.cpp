@@ -0,0 +1,309 @@
+// ---------------------------------------------------------------------------
+// rbfModeBench.cpp - C++ File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	Standalone benchmark of the two dense RBF blend modes, RBF-LUFactorize
+//	and RBF-Solved, for 10, 100 and 1000 poses on one influence.  Random
+//	ReadAxis reader vectors, Gaussian kernel at the default 45 degree
+//	avgPoseSepRBF.  Setup is what updateRBFCache() does when the poses
+//	change, plus buildCoef() for RBF-Solved.  Per frame is the kernel row
+//	plus the O(N) pass for RBF-LUFactorize, or the N^2 coefficient matvec
+//	for RBF-Solved.  Also shows how good the RBF-Solved coefficients are,
+//	as the biggest entry of A C - I.
+//
+//		g++ -O2 -I.. rbfModeBench.cpp ../MatrixNN.cpp ../poseDeformerKernel.cpp -o rbfModeBench
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+/*
+ * Includes
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "MatrixNN.h"
+#include "MatrixN.h"
+
+// ---------------------------------------------------------------------------
+
+#define BENCHSIGMA		-16.0		// rbfSigma2() of the default 45 degree width
+#define BENCHLAMBDA		1e-3		// rbfRegularize, random poses this close need some
+#define BENCHFRAMES		2000		// Frames timed per mode, spread over the sizes
+#define BENCHREPS		3			// Setups timed per mode, best one is reported
+
+// ---------------------------------------------------------------------------
+
+/*
+ * nowSecs() - Monotonic wall clock in seconds.
+ */
+static double nowSecs(void)
+{
+	struct timespec ts ;
+	clock_gettime(CLOCK_MONOTONIC, &ts) ;
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9 ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * randUnit() - Random unit vector into dVec[3].
+ */
+static void randUnit(double *dVec)
+{
+	double dLen ;
+	do	{
+		dVec[0] = (double)rand() / RAND_MAX * 2.0 - 1.0 ;
+		dVec[1] = (double)rand() / RAND_MAX * 2.0 - 1.0 ;
+		dVec[2] = (double)rand() / RAND_MAX * 2.0 - 1.0 ;
+		dLen = sqrt(dVec[0]*dVec[0] + dVec[1]*dVec[1] + dVec[2]*dVec[2]) ;
+		} while (dLen < 0.1 || dLen > 1.0) ;
+	dVec[0] /= dLen ;
+	dVec[1] /= dLen ;
+	dVec[2] /= dLen ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * kernelRow() - dRow[j] = phi(angle(dCur, pose j) / pi), same as rbfKernelRow()
+ *		with the exact Gaussian.
+ */
+static void kernelRow(const double *dRead, unsigned uPoses, const double *dCur, double *dRow)
+{
+	unsigned j ;
+	for (j=0; j < uPoses; ++j)
+		{
+		const double *dVec = dRead + j * 3 ;
+		double dDot = dCur[0]*dVec[0] + dCur[1]*dVec[1] + dCur[2]*dVec[2] ;
+		if (dDot > 1.0)
+			dDot = 1.0 ;
+		if (dDot < -1.0)
+			dDot = -1.0 ;
+		double dDist = acos(dDot) / 3.14159 ;
+		dRow[j] = exp( BENCHSIGMA * dDist * dDist) ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * setupFactor() - fillRBFMatrix() and the dense double path of updateRBFCache().
+ */
+static bool setupFactor(MatrixNNFactor &facA, const double *dRead, unsigned uPoses)
+{
+	if (!facA.alloc(uPoses))
+		return false ;
+
+	unsigned i ;
+	bool bDone = false ;
+	int nTry ;
+	for (nTry=0; nTry < 2 && !bDone; ++nTry)
+		{
+		for (i=0; i < uPoses; ++i)
+			{
+			kernelRow(dRead, uPoses, dRead + i * 3, facA.matFac[i]) ;
+			facA.matFac[i][i] += BENCHLAMBDA ;
+			}
+		if (uPoses <= MATRIXN_MAX)
+			return facA.factorizeFixed() ;
+		bDone = (nTry == 0) ? facA.factorizeLDLT() : facA.factorizeLU() ;
+		}
+	return bDone ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * frameInterp() - Per frame RBF-LUFactorize, interpWeights() after the cache check.
+ */
+static void frameInterp(const double *dRead, unsigned uPoses, const double *dCur, double *dRow, double *dWts)
+{
+	kernelRow(dRead, uPoses, dCur, dRow) ;
+
+	double dTotalOrig = 0.0 ;
+	unsigned i ;
+	for (i=0; i < uPoses; ++i)
+		dTotalOrig += dWts[i] ;
+	if (dTotalOrig > 1.0)
+		dTotalOrig = 1.0 ;
+
+	double dTotal = 0.0 ;
+	for (i=0; i < uPoses; ++i)
+		{
+		dWts[i] = dWts[i] * dRow[i] ;
+		if (dWts[i] < 0.0)
+			dWts[i] = 0.0 ;
+		dTotal += dWts[i] ;
+		}
+	for (i=0; i < uPoses && dTotal != 0.0; ++i)
+		dWts[i] = dWts[i] / dTotal * dTotalOrig ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * frameSolved() - Per frame RBF-Solved, solvedWeights() after buildCoef().
+ */
+static void frameSolved(const MatrixNN &matCoef, const double *dRead, unsigned uPoses, const double *dCur, double *dRow, double *dWts)
+{
+	kernelRow(dRead, uPoses, dCur, dRow) ;
+
+	unsigned i, j ;
+	for (i=0; i < uPoses; ++i)
+		{
+		const double *dCoef = matCoef[i] ;
+		double dWt = 0.0 ;
+		for (j=0; j < uPoses; ++j)
+			dWt += dCoef[j] * dRow[j] ;
+		dWts[i] = (dWt < 0.0) ? 0.0 : dWt ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * main() - 10, 100 and 1000 poses.
+ */
+int main(int argc, char **argv)
+{
+	srand(1234) ;
+
+	printf("Gaussian, width 45 deg, lambda %g\n", BENCHLAMBDA) ;
+	printf("%6s  %14s %14s  %14s %14s  %12s\n", "poses", "LU setup ms", "LU frame us",
+			"Solved setup ms", "Solved frame us", "|AC - I|") ;
+
+	static const unsigned uSizes[] = { 10, 100, 1000 } ;
+	unsigned s, i, j, f ;
+	for (s=0; s < sizeof(uSizes) / sizeof(uSizes[0]); ++s)
+		{
+		unsigned uPoses = uSizes[s] ;
+		double *dRead = new double [uPoses * 3] ;
+		double *dRow = new double [uPoses] ;
+		double *dWts = new double [uPoses] ;
+		double *dCurs = new double [BENCHFRAMES * 3] ;
+		if (dRead == NULL || dRow == NULL || dWts == NULL || dCurs == NULL)
+			{
+			printf("out of memory at %u poses\n", uPoses) ;
+			return 1 ;
+			}
+		for (i=0; i < uPoses; ++i)
+			randUnit(dRead + i * 3) ;
+		for (f=0; f < BENCHFRAMES; ++f)
+			randUnit(dCurs + f * 3) ;
+		unsigned uFrames = (uPoses >= 1000) ? BENCHFRAMES / 10 : BENCHFRAMES ;
+
+		// RBF-LUFactorize, only needs the factorization to exist.
+		MatrixNNFactor facA ;
+		double dLUSetup = 1e30 ;
+		int r ;
+		for (r=0; r < BENCHREPS; ++r)
+			{
+			double dStart = nowSecs() ;
+			bool bOk = setupFactor(facA, dRead, uPoses) ;
+			double dTime = nowSecs() - dStart ;
+			if (!bOk)
+				{
+				printf("%6u  could not factor\n", uPoses) ;
+				return 1 ;
+				}
+			if (dTime < dLUSetup)
+				dLUSetup = dTime ;
+			}
+
+		double dStart = nowSecs() ;
+		for (f=0; f < uFrames; ++f)
+			{
+			for (i=0; i < uPoses; ++i)
+				dWts[i] = 1.0 ;
+			frameInterp(dRead, uPoses, dCurs + f * 3, dRow, dWts) ;
+			}
+		double dLUFrame = (nowSecs() - dStart) / uFrames ;
+
+		// RBF-Solved, same factorization then C = A^-1, like buildCoef().
+		MatrixNNFactor facB ;
+		MatrixNN matCoef ;
+		double dSolvedSetup = 1e30 ;
+		for (r=0; r < BENCHREPS; ++r)
+			{
+			dStart = nowSecs() ;
+			bool bOk = setupFactor(facB, dRead, uPoses) ;
+			if (bOk && matCoef.setDimension(uPoses) == uPoses)
+				{
+				matCoef.identity() ;
+				bOk = facB.solve(matCoef, matCoef) ;
+				}
+			double dTime = nowSecs() - dStart ;
+			if (!bOk)
+				{
+				printf("%6u  could not solve the coefficients\n", uPoses) ;
+				return 1 ;
+				}
+			if (dTime < dSolvedSetup)
+				dSolvedSetup = dTime ;
+			}
+
+		dStart = nowSecs() ;
+		for (f=0; f < uFrames; ++f)
+			frameSolved(matCoef, dRead, uPoses, dCurs + f * 3, dRow, dWts) ;
+		double dSolvedFrame = (nowSecs() - dStart) / uFrames ;
+
+		// Row i of matCoef is A^-1 e_i, so A times it should be e_i.  Only the
+		// first few, it's N^2 each.
+		double dErr = 0.0 ;
+		for (i=0; i < uPoses && i < 50; ++i)
+			{
+			for (j=0; j < uPoses; ++j)
+				{
+				kernelRow(dRead, uPoses, dRead + j * 3, dRow) ;		// Row j of A
+				dRow[j] += BENCHLAMBDA ;
+				double dSum = 0.0 ;
+				unsigned k ;
+				for (k=0; k < uPoses; ++k)
+					dSum += dRow[k] * matCoef[i][k] ;
+				double dDiff = fabs(dSum - ((i == j) ? 1.0 : 0.0)) ;
+				if (dDiff > dErr)
+					dErr = dDiff ;
+				}
+			}
+
+		printf("%6u  %14.3f %14.2f  %14.3f %14.2f  %12.2e\n", uPoses, dLUSetup * 1000.0, dLUFrame * 1e6,
+				dSolvedSetup * 1000.0, dSolvedFrame * 1e6, dErr) ;
+
+		delete [] dRead ;
+		delete [] dRow ;
+		delete [] dWts ;
+		delete [] dCurs ;
+		}
+
+	return 0 ;
+}
@@ -0,0 +1,374 @@
+// ---------------------------------------------------------------------------
+// scheduleBench.cpp - C++ File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	Standalone benchmark of the two evalSchedule loop orders, Tile and
+//	Pose-Major, on big synthetic meshes.  Both use the same kernel calls
+//	as poseDeformer::deformPointsTile() / deformPointsPose() over dense
+//	SoA delta blocks, so only the memory traffic differs.  Reports time per
+//	deform and, on Linux where perf events are allowed, last level cache
+//	misses per deform.  Also checks the two orders give the same bits.
+//
+//		g++ -O2 -I.. scheduleBench.cpp ../poseDeformerKernel.cpp -o scheduleBench
+//		./scheduleBench [xforms]
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+/*
+ * Includes
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "poseDeformerKernel.h"
+
+// ---------------------------------------------------------------------------
+
+#define BENCHREPS		5		// Deforms timed per schedule, best one is reported
+
+/*
+ * benchMesh - Synthetic mesh, pts and one dense SoA delta block per xform, laid out
+ *		like poseDeformerXFormCache does.
+ */
+struct benchMesh
+	{
+	unsigned uPts ;
+	unsigned uXForms ;
+	double *ptrPos ;			// SoA x[], y[], z[]
+	double *ptrPct ;			// Weight * envelope per pt
+	double **ptrDelta ;			// Per xform SoA x[], y[], z[]
+	double (*ptrMap)[9] ;		// Per xform 3x3 map
+	double *ptrAcc ;			// Pose major accumulator, SoA
+	} ;
+
+// ---------------------------------------------------------------------------
+
+/*
+ * nowSecs() - Monotonic wall clock in seconds.
+ */
+static double nowSecs(void)
+{
+	struct timespec ts ;
+	clock_gettime(CLOCK_MONOTONIC, &ts) ;
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9 ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * missOpen() - Opens an LLC miss counter for this thread.  Returns -1 if perf
+ *		events aren't there or aren't allowed, then only times are shown.
+ */
+static int missOpen(void)
+{
+#ifdef __linux__
+	struct perf_event_attr attr ;
+	memset(&attr, 0, sizeof(attr)) ;
+	attr.size = sizeof(attr) ;
+	attr.type = PERF_TYPE_HW_CACHE ;
+	attr.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) ;
+	attr.disabled = 1 ;
+	attr.exclude_kernel = 1 ;
+	attr.exclude_hv = 1 ;
+	int nFd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0) ;
+	if (nFd < 0)
+		{
+		attr.type = PERF_TYPE_HARDWARE ;		// Some cpus only have the generic one
+		attr.config = PERF_COUNT_HW_CACHE_MISSES ;
+		nFd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0) ;
+		}
+	return nFd ;
+#else
+	return -1 ;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * missStart(), missStop() - Resets and reads the counter around one deform.
+ */
+static void missStart(int nFd)
+{
+#ifdef __linux__
+	if (nFd < 0)
+		return ;
+	ioctl(nFd, PERF_EVENT_IOC_RESET, 0) ;
+	ioctl(nFd, PERF_EVENT_IOC_ENABLE, 0) ;
+#endif
+}
+
+static long long missStop(int nFd)
+{
+#ifdef __linux__
+	if (nFd < 0)
+		return -1 ;
+	ioctl(nFd, PERF_EVENT_IOC_DISABLE, 0) ;
+	long long llCount = 0 ;
+	if (read(nFd, &llCount, sizeof(llCount)) != (ssize_t)sizeof(llCount))
+		return -1 ;
+	return llCount ;
+#else
+	return -1 ;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * meshCreate(), meshDestroy() - Random pts, wts, deltas and maps.
+ */
+static bool meshCreate(benchMesh &mesh, unsigned uPts, unsigned uXForms)
+{
+	mesh.uPts = uPts ;
+	mesh.uXForms = uXForms ;
+	mesh.ptrPos = new double [uPts * 3] ;
+	mesh.ptrPct = new double [uPts] ;
+	mesh.ptrAcc = new double [uPts * 3] ;
+	mesh.ptrDelta = new double * [uXForms] ;
+	mesh.ptrMap = new double [uXForms][9] ;
+	if (mesh.ptrPos == NULL || mesh.ptrPct == NULL || mesh.ptrAcc == NULL || mesh.ptrDelta == NULL || mesh.ptrMap == NULL)
+		return false ;
+
+	unsigned i, x ;
+	for (i=0; i < uPts * 3; ++i)
+		mesh.ptrPos[i] = (double)rand() / RAND_MAX * 10.0 - 5.0 ;
+	for (i=0; i < uPts; ++i)
+		mesh.ptrPct[i] = (double)rand() / RAND_MAX ;
+	for (x=0; x < uXForms; ++x)
+		{
+		mesh.ptrDelta[x] = new double [uPts * 3] ;
+		if (mesh.ptrDelta[x] == NULL)
+			return false ;
+		for (i=0; i < uPts * 3; ++i)
+			mesh.ptrDelta[x][i] = (double)rand() / RAND_MAX * 0.2 - 0.1 ;
+		for (i=0; i < 9; ++i)
+			mesh.ptrMap[x][i] = (double)rand() / RAND_MAX * 2.0 - 1.0 ;
+		}
+	return true ;
+}
+
+static void meshDestroy(benchMesh &mesh)
+{
+	unsigned x ;
+	for (x=0; x < mesh.uXForms; ++x)
+		delete [] mesh.ptrDelta[x] ;
+	delete [] mesh.ptrDelta ;
+	delete [] mesh.ptrMap ;
+	delete [] mesh.ptrPos ;
+	delete [] mesh.ptrPct ;
+	delete [] mesh.ptrAcc ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * deformTile() - Same order as deformPointsTile(), each tile of KERNELTILE pts
+ *		on the stack goes thru every xform, then is blended.
+ */
+static void deformTile(int nKernel, const benchMesh &mesh, double *dOut)
+{
+	double dDefX[KERNELTILE], dDefY[KERNELTILE], dDefZ[KERNELTILE] ;
+	unsigned uPts = mesh.uPts ;
+	const double *dPosX = mesh.ptrPos ;
+	const double *dPosY = mesh.ptrPos + uPts ;
+	const double *dPosZ = mesh.ptrPos + uPts * 2 ;
+
+	unsigned uTile, k, x ;
+	for (uTile=0; uTile < uPts; uTile += KERNELTILE)
+		{
+		unsigned uCount = (uPts - uTile > KERNELTILE) ? KERNELTILE : (uPts - uTile) ;
+		for (k=0; k < uCount; ++k)
+			{
+			dDefX[k] = dPosX[uTile+k] ;
+			dDefY[k] = dPosY[uTile+k] ;
+			dDefZ[k] = dPosZ[uTile+k] ;
+			}
+
+		for (x=0; x < mesh.uXForms; ++x)
+			{
+			const double *dDelta = mesh.ptrDelta[x] ;
+			poseKernelAccumulate(nKernel, mesh.ptrMap[x], dDelta + uTile, dDelta + uPts + uTile, dDelta + uPts * 2 + uTile,
+					dDefX, dDefY, dDefZ, uCount) ;
+			}
+
+		for (k=0; k < uCount; ++k)
+			{
+			double dPct = mesh.ptrPct[uTile+k] ;
+			dOut[uTile+k] = ((1.0-dPct) * dPosX[uTile+k]) + (dPct * dDefX[k]) ;
+			dOut[uPts+uTile+k] = ((1.0-dPct) * dPosY[uTile+k]) + (dPct * dDefY[k]) ;
+			dOut[uPts*2+uTile+k] = ((1.0-dPct) * dPosZ[uTile+k]) + (dPct * dDefZ[k]) ;
+			}
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * deformPose() - Same order as deformPointsPose(), fill the accumulator, stream
+ *		each xform's whole block down it, then one blend pass.
+ */
+static void deformPose(int nKernel, const benchMesh &mesh, double *dOut)
+{
+	unsigned uPts = mesh.uPts ;
+	const double *dPosX = mesh.ptrPos ;
+	const double *dPosY = mesh.ptrPos + uPts ;
+	const double *dPosZ = mesh.ptrPos + uPts * 2 ;
+	double *dAccX = mesh.ptrAcc ;
+	double *dAccY = mesh.ptrAcc + uPts ;
+	double *dAccZ = mesh.ptrAcc + uPts * 2 ;
+
+	unsigned uTile, k, x ;
+	memcpy(mesh.ptrAcc, mesh.ptrPos, sizeof(double) * uPts * 3) ;
+
+	for (x=0; x < mesh.uXForms; ++x)
+		{
+		const double *dDelta = mesh.ptrDelta[x] ;
+		for (uTile=0; uTile < uPts; uTile += KERNELTILE)
+			{
+			unsigned uCount = (uPts - uTile > KERNELTILE) ? KERNELTILE : (uPts - uTile) ;
+			poseKernelAccumulate(nKernel, mesh.ptrMap[x], dDelta + uTile, dDelta + uPts + uTile, dDelta + uPts * 2 + uTile,
+					dAccX + uTile, dAccY + uTile, dAccZ + uTile, uCount) ;
+			}
+		}
+
+	for (k=0; k < uPts; ++k)
+		{
+		double dPct = mesh.ptrPct[k] ;
+		dOut[k] = ((1.0-dPct) * dPosX[k]) + (dPct * dAccX[k]) ;
+		dOut[uPts+k] = ((1.0-dPct) * dPosY[k]) + (dPct * dAccY[k]) ;
+		dOut[uPts*2+k] = ((1.0-dPct) * dPosZ[k]) + (dPct * dAccZ[k]) ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * timeSchedule() - Best of BENCHREPS deforms.  Fills in secs and misses for the best.
+ */
+static void timeSchedule(bool bPose, int nKernel, int nFd, const benchMesh &mesh, double *dOut,
+				double &dSecs, long long &llMisses)
+{
+	dSecs = 1e30 ;
+	llMisses = -1 ;
+	int r ;
+	for (r=0; r < BENCHREPS; ++r)
+		{
+		missStart(nFd) ;
+		double dStart = nowSecs() ;
+		if (bPose)
+			deformPose(nKernel, mesh, dOut) ;
+		else
+			deformTile(nKernel, mesh, dOut) ;
+		double dTime = nowSecs() - dStart ;
+		long long llCount = missStop(nFd) ;
+		if (dTime < dSecs)
+			{
+			dSecs = dTime ;
+			llMisses = llCount ;
+			}
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * main() - 10k to 1M pts, Tile vs Pose-Major.
+ */
+int main(int argc, char **argv)
+{
+	unsigned uXForms = (argc > 1) ? (unsigned)atoi(argv[1]) : 32 ;
+	if (uXForms == 0)
+		uXForms = 32 ;
+
+	srand(1234) ;
+	int nKernel = poseKernelResolve(eKernelAuto) ;
+	int nFd = missOpen() ;
+
+	printf("kernel %s, %u dense xforms, best of %d\n", poseKernelName(nKernel), uXForms, BENCHREPS) ;
+	if (nFd < 0)
+		printf("(no perf events here, times only)\n") ;
+	printf("%9s  %12s %14s  %12s %14s  %s\n", "pts", "tile ms", "tile misses", "pose ms", "pose misses", "same") ;
+
+	static const unsigned uSizes[] = { 10000, 100000, 300000, 1000000 } ;
+	unsigned s ;
+	for (s=0; s < sizeof(uSizes) / sizeof(uSizes[0]); ++s)
+		{
+		benchMesh mesh ;
+		if (!meshCreate(mesh, uSizes[s], uXForms))
+			{
+			printf("out of memory at %u pts\n", uSizes[s]) ;
+			return 1 ;
+			}
+		double *dOutTile = new double [uSizes[s] * 3] ;
+		double *dOutPose = new double [uSizes[s] * 3] ;
+
+		double dTileSecs, dPoseSecs ;
+		long long llTileMiss, llPoseMiss ;
+		timeSchedule(false, nKernel, nFd, mesh, dOutTile, dTileSecs, llTileMiss) ;
+		timeSchedule(true, nKernel, nFd, mesh, dOutPose, dPoseSecs, llPoseMiss) ;
+		bool bSame = (memcmp(dOutTile, dOutPose, sizeof(double) * uSizes[s] * 3) == 0) ;
+
+		char szTileMiss[32], szPoseMiss[32] ;
+		if (llTileMiss < 0 || llPoseMiss < 0)
+			{
+			strcpy(szTileMiss, "n/a") ;
+			strcpy(szPoseMiss, "n/a") ;
+			}
+		else
+			{
+			snprintf(szTileMiss, sizeof(szTileMiss), "%lld", llTileMiss) ;
+			snprintf(szPoseMiss, sizeof(szPoseMiss), "%lld", llPoseMiss) ;
+			}
+
+		printf("%9u  %12.3f %14s  %12.3f %14s  %s\n", uSizes[s], dTileSecs * 1000.0, szTileMiss,
+				dPoseSecs * 1000.0, szPoseMiss, bSame ? "yes" : "NO") ;
+
+		delete [] dOutTile ;
+		delete [] dOutPose ;
+		meshDestroy(mesh) ;
+		}
+
+#ifdef __linux__
+	if (nFd >= 0)
+		close(nFd) ;
+#endif
+	return 0 ;
+}
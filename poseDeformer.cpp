@@ -1,1047 +1,2978 @@
-// ---------------------------------------------------------------------------
-// poseDeformer.cpp - C++ File
-// Copyright 2004 Michael B. Comet
-// ---------------------------------------------------------------------------
-//
-// DESCRIPTION:
-//	The poseDeformer deformer plugin
-//
-// AUTHOR:
-//	Michel B. Comet - comet@comet-cartoons.com
-//
-// VERSIONS:
-//	09/22/04 - comet - Initial Rev
-//	1.03 - 10/05/04 - mcomet - Fixed so does entire loop of all points even
-//				if not in membership, so that targets work and ed-mem works.
-//				Also removed MProgressWindow since seemed buggy.
-//	1.04 - 10/07/04 - mcomet - Made it so now much faster at generating poses.
-//	1.05 - 10/15/04 - mcomet - Now has new RBF interpolation mode.
-//	1.06 - 10/16/04 - mcomet - Added mirrorData node to help with mirroring.
-//	1.07 - 11/03/04 - mcomet - Now only uses membership points when creating
-//				targets, also put in missing scripts to ZIP file.
-//  1.09c - 12/01/04 - mcomet - Now has option for joint-space vs. pose-space
-//				deformation.  So that the sculpt is either tied to the joint
-//				or the reader as it is brought back up.
-//	1.10 - 01/21/05 - mcomet - Fix for wig out mesh when pose deleted.
-//	1.11 - 08/05/05 - mcomet - Now has user Scale settings.
-//
-// ---------------------------------------------------------------------------
-//
-//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
-//  Copyright 2004 Michael B. Comet
-//
-//   This program is free software; you can redistribute it and/or modify
-//   it under the terms of the GNU General Public License as published by
-//   the Free Software Foundation; either version 2 of the License, or
-//   (at your option) any later version.
-//
-//   This program is distributed in the hope that it will be useful,
-//   but WITHOUT ANY WARRANTY; without even the implied warranty of
-//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-//   GNU General Public License for more details.
-//
-//   You should have received a copy of the GNU General Public License
-//   along with this program; if not, write to the Free Software
-//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
-//
-//   For information on poseDeformer contact:
-//			Michael B. Comet - comet@comet-cartoons.com
-//			or visit http://www.comet-cartooons.com/toons/
-//
-// --------------------------------------------------------------------------
-
-
-
-// ---------------------------------------------------------------------------
-
-/*
- * Includes
- */
-#include <string.h>
-#include <fstream>
-#include <iostream>
-#include <math.h>
-
-#include "poseDeformer.h" 
-#include "plugin.h" 
-#include "MatrixNN.h"
-
-// ---------------------------------------------------------------------------
-
-/*
- * For local testing of nodes you can use any identifier between 
- * 0x00000000 and 0x0007ffff, but for any node that you plan to use 
- * for more permanent purposes, you should get a universally unique id 
- * from Alias|Wavefront Assist. You will be assigned a unique range 
- * that you can manage on your own.
- */
-MTypeId poseDeformer::id( ID_POSEDEFORMER );
-
-/*
- * static attributes
- */
-MObject	poseDeformer::aInputSettings ;		// Cmpd input settings
-MObject	poseDeformer::aBlendMode ;			// Do normal additive, or try to normalize weights if >1.0?
-MObject	poseDeformer::aIsolate ;			// Turn on a specific pose weight 100% for editing/viewing.
-MObject	poseDeformer::aRBFWidth ;			// Width of blending for Radial Basis Function/LU Factorization
-MObject	poseDeformer::aDeformSpace ;		// Deform relative to joint space or poseReader space?
-MObject	poseDeformer::aUserScale ;			// Cmpd scale of how much to alter output by
-MObject	poseDeformer::aUserScaleX ;			// X
-MObject	poseDeformer::aUserScaleY ;			// Y
-MObject	poseDeformer::aUserScaleZ ;			// Z
-
-
-MObject	poseDeformer::aInputData ;			// Cmpd input data
-MObject	poseDeformer::aWorldMatrix ;		// Array of world matrix's for each live skin infl object.  Matches skinCluser "matrix" attr.
-
-MObject	poseDeformer::aPose ;				// Cmpd array of poses
-MObject poseDeformer::aPoseName ;			// String for user defined name for pose
-MObject	poseDeformer::aPoseWeight ;			// Weight of the pose
-MObject	poseDeformer::aPoseActive;			// True if this pose is not currently deleted.
-MObject	poseDeformer::aPoseXForm ;			// Cmpd Array of Data of point for each xform that created this pose.
-MObject	poseDeformer::aPoseXFormStr ;		// Relative str of the given transform for this pose.  Usually 1/#posexforms when the pose was made
-MObject	poseDeformer::aPoseXFormIdx ;		// Index of which infl the data is stored for.
-MObject	poseDeformer::aPoseXFormWorldMatrix ; // World Matrix for this poseReader
-MObject poseDeformer::aPoseXFormReadAxis ;	// What axis this poseReader is using...
-MObject	poseDeformer::aPoseXFormNumPts ;		// Num of Delta Pts
-MObject	poseDeformer::aPoseDelta ;			// Cmpd array delta points for the pose one for each pt
-MObject	poseDeformer::aPoseDeltaX ;			// What was change in X relative to this matrix?
-MObject	poseDeformer::aPoseDeltaY ;			// What was change in Y relative to this matrix?
-MObject	poseDeformer::aPoseDeltaZ ;			// What was change in Z relative to this matrix?
-
-
-// ---------------------------------------------------------------------------
-
-// ---------------------------------------------------------------------------
-//	Main Maya Plugin Functions
-// ---------------------------------------------------------------------------
-
-// ---------------------------------------------------------------------------
-
-/*
- * poseDeformer::creator() - Proc to allocated a new node
- */
-void* poseDeformer::creator()
-{
-    return new poseDeformer();
-}
-
-// ---------------------------------------------------------------------------
-
-
-/*
- * poseDeformer::poseDeformer() - constructor
- */
-poseDeformer::poseDeformer() 
-{
-
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * poseDeformer::~poseDeformer() - Destructor
- */
-poseDeformer::~poseDeformer()
-{
-}
-
-// ---------------------------------------------------------------------------
-
-// ---------------------------------------------------------------------------
-//	Attr, Compute and Deform Functions
-// ---------------------------------------------------------------------------
-
-// ---------------------------------------------------------------------------
-
-
-
-/*
- * poseDeformer::initialize() - Set up our attrs
- *
- * By default, attributes are: 
- * ---------------------------
- * readable 
- * writable 
- * connectable 
- * storable 
- * cached 
- * not arrays 
- * have indices that matter 
- * do not use an array builder 
- * not keyable 
- * not hidden 
- * not used as colors 
- * not indeterminant 
- * set to disconnect behavior kNothing 
- *
- */
-MStatus poseDeformer::initialize()
-{ 
-    MStatus stat;
-    
-    // local attribute initialization
-    MFnNumericAttribute nAttr ;
-    MFnMatrixAttribute mAttr ;
-    MFnCompoundAttribute cAttr ;
-    MFnEnumAttribute eAttr ;
-    MFnGenericAttribute gAttr ;
-	MFnTypedAttribute tAttr ;
-
-	// Make Attributes
-	//
-	aRBFWidth = nAttr.create("avgPoseSepRBF", "rbfw", MFnNumericData::kDouble, 45) ;
-	nAttr.setMin(0.001) ;
-	nAttr.setMax(180.0) ;
-	nAttr.setKeyable(true) ;
-
-	aBlendMode = eAttr.create( "blendMode", "bmod", 2 );
-	eAttr.setKeyable(true);
-	eAttr.addField("Additive", eBlendAdditive) ;
-	eAttr.addField("Normalize", eBlendNormalize) ;
-	eAttr.addField("RBF-LUFactorize", eBlendRBF) ;
-
-	aDeformSpace = eAttr.create( "deformSpace", "dspc", 0 );
-	eAttr.setKeyable(true);
-	eAttr.addField("joint-space", eSpaceJoint ) ;
-	eAttr.addField("pose-space", eSpacePose ) ;
-
-	aIsolate = nAttr.create("isolate", "iso", MFnNumericData::kInt, 0) ;
-	nAttr.setMin(0) ;
-	nAttr.setKeyable(true) ;
-
-	aUserScaleX = nAttr.create("userScaleX", "usx", MFnNumericData::kDouble, 1.0 ) ;
-	nAttr.setKeyable(true) ;
-	aUserScaleY = nAttr.create("userScaleY", "usy", MFnNumericData::kDouble, 1.0 ) ;
-	nAttr.setKeyable(true) ;
-	aUserScaleZ = nAttr.create("userScaleZ", "usz", MFnNumericData::kDouble, 1.0 ) ;
-	nAttr.setKeyable(true) ;
-
-	aUserScale = cAttr.create( "userScale", "uscl") ;
-    cAttr.addChild( aUserScaleX ) ;
-    cAttr.addChild( aUserScaleY ) ;
-    cAttr.addChild( aUserScaleZ ) ;
-
-
-	aInputSettings = cAttr.create( "inputSettings", "inset") ;
-    cAttr.addChild( aRBFWidth ) ;
-    cAttr.addChild( aBlendMode ) ;
-    cAttr.addChild( aDeformSpace ) ;
-    cAttr.addChild( aIsolate ) ;
-    cAttr.addChild( aUserScale ) ;
-
-
-/*
-    aMeshIn = fnGenericAttr.create( "meshIn", "mesh", &stat );
-    fnGenericAttr.addAccept(MFnData::kNurbsSurface);
-    fnGenericAttr.addAccept(MFnData::kMesh);
-//    fnGenericAttr.addAccept(MFnData::kSubdSurface);
-*/
-
-	aWorldMatrix = mAttr.create("worldMatrix", "wm", MFnMatrixAttribute::kDouble) ;
-	mAttr.setArray(true);
-	mAttr.setUsesArrayDataBuilder(true);
-
-	aInputData = cAttr.create( "inputData", "indat") ;
-    cAttr.addChild( aWorldMatrix ) ;
-
-	MFnStringData fnStr ;
-	MObject oStr ;
-	oStr = fnStr.create("");  // Set default value.
-	aPoseName = tAttr.create("poseName", "pnm", MFnData::kString, oStr) ;
-
-	aPoseWeight = nAttr.create("poseWeight", "pwt", MFnNumericData::kDouble, 0.0) ;
-	aPoseActive = nAttr.create("poseActive", "pact", MFnNumericData::kBoolean, 1) ;
-
-	aPoseXFormStr = nAttr.create("poseXFormStr", "pxstr", MFnNumericData::kDouble, 0.0) ;
-	aPoseXFormIdx = nAttr.create("poseXFormIdx", "pxidx", MFnNumericData::kInt, -1) ;
-	aPoseXFormWorldMatrix = mAttr.create("poseXFormWorldMatrix", "pxmat", MFnMatrixAttribute::kDouble) ;
-	aPoseXFormReadAxis = eAttr.create( "poseXFormReadAxis", "pxaxi", 1) ;
-	eAttr.addField("X-Axis", 0) ;
-	eAttr.addField("Y-Axis", 1) ;
-	eAttr.addField("Z-Axis", 2) ;
-	aPoseXFormNumPts = nAttr.create("poseXFormNumPts", "pxnpt", MFnNumericData::kInt, 0) ;
-
-
-	aPoseDeltaX = nAttr.create("poseDeltaX", "pdx", MFnNumericData::kDouble, 0.0) ;
-	aPoseDeltaY = nAttr.create("poseDeltaY", "pdy", MFnNumericData::kDouble, 0.0) ;
-	aPoseDeltaZ = nAttr.create("poseDeltaZ", "pdz", MFnNumericData::kDouble, 0.0) ;
-
-	aPoseDelta = cAttr.create( "poseDelta", "pdlt") ;
-	cAttr.setArray(true) ;
-	cAttr.setUsesArrayDataBuilder(true) ;
-    cAttr.addChild( aPoseDeltaX ) ;
-    cAttr.addChild( aPoseDeltaY ) ;
-    cAttr.addChild( aPoseDeltaZ ) ;
-
-	aPoseXForm = cAttr.create( "poseXForm", "pxfm") ;
-	cAttr.setArray(true) ;
-	cAttr.setUsesArrayDataBuilder(true) ;
-	cAttr.addChild( aPoseXFormStr ) ;
-	cAttr.addChild( aPoseXFormIdx ) ;
-	cAttr.addChild( aPoseXFormWorldMatrix ) ;
-	cAttr.addChild( aPoseXFormReadAxis ) ;
-	cAttr.addChild( aPoseXFormNumPts ) ;
-	cAttr.addChild( aPoseDelta ) ;
-
-
-	aPose = cAttr.create( "pose", "pos") ;
-	cAttr.setArray(true) ;
-	cAttr.setUsesArrayDataBuilder(true) ;
-	cAttr.addChild( aPoseName ) ;
-	cAttr.addChild( aPoseWeight ) ;
-	cAttr.addChild( aPoseXForm ) ;
-	cAttr.addChild( aPoseActive ) ;
-
-
-	// Add Attrs
-	stat = addAttribute( aInputSettings );
-		MERR(stat, "Cannot add attribute aInputSettings.") ;
-	stat = addAttribute( aInputData );
-		MERR(stat, "Cannot add attribute aInputData.") ;
-	stat = addAttribute( aPose );
-		MERR(stat, "Cannot add attribute aPose.") ;
-
-	// Affect them 
-    attributeAffects( aInputSettings, outputGeom );
-    attributeAffects( aInputData, outputGeom );
-    attributeAffects( aPose, outputGeom );
-	
-	return MS::kSuccess;
-}
-
-
-// ---------------------------------------------------------------------------
-
-/*
- * poseDeformer::deform() - Main deform stuff
- *
- * Method: deform
- *
- * Description:   Deform the point with a squash algorithm
- *
- * Arguments:
- *   data		: the datablock of the node
- *   iter		: an iterator for the geometry to be deformed
- *   m    		: matrix to transform the point into world space
- *   multiIndex	        : the index of the geometry that we are deforming
- *
- */
-MStatus poseDeformer::deform( MDataBlock& data, MItGeometry& iter, const MMatrix& matWorld,	
-						unsigned int multiIndex)
-{
-    MStatus stat;
-
-
-	MMatrix invmatWorld = matWorld.inverse() ;
-
-    MObject thisNode = thisMObject();
-    MString name = MFnDependencyNode(thisNode).name() ;
-
-	MDataHandle hNodeState = data.inputValue( state, &stat) ;
-	int nNodeState = hNodeState.asShort() ;
-	if (nNodeState == 1)
-		return MS::kSuccess ;
-
-    // Envelope data from the base class.
-    // The envelope is simply a scale factor.
-    //
-    MDataHandle hEnvelope = data.inputValue(envelope, &stat);
-    if (MS::kSuccess != stat)  return stat;
-    float fEnv = hEnvelope.asFloat();	
-	if (fEnv <= 0.0)			// if off...done!
-		return MS::kSuccess; 
-
-	// Get other data...
-	//
-    MDataHandle hBlendMode = data.inputValue( aBlendMode, &stat );
-    int nBlendMode = hBlendMode.asShort();	
-
-    MDataHandle hDeformSpace = data.inputValue( aDeformSpace, &stat );
-    int nDeformSpace = hDeformSpace.asShort();	
-	
-    MDataHandle hIsolate = data.inputValue( aIsolate, &stat );
-    int nIsolate = hIsolate.asInt();	
-
-    MDataHandle hRBFWidth = data.inputValue( aRBFWidth, &stat );
-    double dRBFWidth = hRBFWidth.asDouble() / 180.0 ;		// We want 0-1, but are giving user 0-180 to be nice.
-
-    MDataHandle hUserScaleX = data.inputValue( aUserScaleX, &stat );
-    double dUserScaleX = hUserScaleX.asDouble() ;
-    MDataHandle hUserScaleY = data.inputValue( aUserScaleY, &stat );
-    double dUserScaleY = hUserScaleY.asDouble() ;
-    MDataHandle hUserScaleZ = data.inputValue( aUserScaleZ, &stat );
-    double dUserScaleZ = hUserScaleZ.asDouble() ;
-
-
-	MMatrix *matArr=NULL ;		// Array of matrices for each input influence transform.
-	unsigned uMat = 0 ;			// How big is array?
-    stat = readMatrixArray(data, name, &matArr, uMat) ;
-
-	// Make sure we had an array of matrices to read...
-	if (stat != MS::kSuccess || uMat == 0 || matArr == NULL)
-		return MS::kSuccess ;
-
-	unsigned uPoses ;
-	MDoubleArray dArrWts ;
-	MVectorArray vArrRead ;
-	MVector vCur ;
-	stat = readPoseWeights(data, name, uPoses, dArrWts, nIsolate, vArrRead, vCur, matArr ) ;
-
-
-
-	// Make sure we even had poses made...
-	if (stat != MS::kSuccess || uPoses == 0)
-		{
-		if (matArr != NULL)
-			{
-			delete [] matArr ;
-			matArr = NULL ;
-			}
-		return MS::kSuccess ;
-		}
-
-	if (nBlendMode == eBlendNormalize && nIsolate == 0 )
-		{
-		normalizeWeights(dArrWts) ;
-		}
-	else if (nBlendMode == eBlendRBF && nIsolate == 0 )
-		{
-		interpWeights(dArrWts, vArrRead, vCur, dRBFWidth) ;
-		}
-
-// cout << name << ": dArrWts="<< dArrWts <<endl ;
-
-
-    // iterate through each point in the geometry
-    //
-	unsigned uPtIdx = 0;
-	for ( iter.reset(); !iter.isDone() ; iter.next() ) 
-        {
-		uPtIdx = iter.index() ;	// Do THIS since we actually store pose data this way...
-
-#if DEBUG > 0
-		cout << "DEBUG: pt [" << uPtIdx << "/" << iter.count() << "]" << endl ;
-#endif
-		
-		MPoint pt = iter.position();
-		MPoint ptWorld = pt * matWorld ;
-		MPoint ptDef = ptWorld ;
-
-		// What is user assigned weighting for this point?
-		float fWt = weightValue(data, multiIndex, iter.index());
-		if ( fWt <= 0.0 )	// if this pt isn't affected at all...just ignore it!
-			continue ;
-
-
-		// poseDeformer algorithm ******************************************
-	    //
-		
-		// Get handle to main pose cmpd array...
-		MArrayDataHandle hArrCmpdPose = data.inputArrayValue( aPose, &stat) ;
-		if (stat != MS::kSuccess)
-			continue ;
-		
-		// For this point...go thru each pose
-		do
-			{
-			MDataHandle hCmpdPose = hArrCmpdPose.inputValue(&stat) ;		// Get compound element item.
-			if (stat != MS::kSuccess)
-				continue ;
-
-			unsigned uPoseIdx = hArrCmpdPose.elementIndex(&stat) ;		// What index'd pose are we looking at?
-
-			double dPoseWt = dArrWts[uPoseIdx] ;		// Get stored weight for that pose
-
-			if (dPoseWt == 0.0)		// If weight is zero, nothing to do anyhow...
-				continue ;
-			
-
-			// And in each pose, go thru each transform that generated it...
-			MArrayDataHandle hArrCmpdPoseXForm = hCmpdPose.child( aPoseXForm ) ;	// Get cmpd array of xforms in pose
-			do
-				{
-
-
-				MDataHandle hCmpdPoseXForm  = hArrCmpdPoseXForm.inputValue(&stat) ;	// Get xform element
-				if (stat != MS::kSuccess)
-					continue ;
-
-				MDataHandle hPoseXFormStr = hCmpdPoseXForm.child( aPoseXFormStr ) ;	// Get relative str of this xform in the pose
-				double dPoseXFormStr = hPoseXFormStr.asDouble() ;
-				if (dPoseXFormStr == 0.0)		// If weight is zero, nothing to do anyhow...
-					continue ;
-
-				MDataHandle hPoseXFormIdx = hCmpdPoseXForm.child( aPoseXFormIdx ) ;	// Get index of what matrix to use
-				int nMatIdx = hPoseXFormIdx.asInt() ;
-				if (nMatIdx < 0)		// Make sure a valid index.
-					continue ;
-
-				MDataHandle hPoseXFormWorldMatrix = hCmpdPoseXForm.child( aPoseXFormWorldMatrix ) ;	// Get poseReader matrix for this pose/xform combo
-				MMatrix matReader = hPoseXFormWorldMatrix.asMatrix();
-
-
-				// And within each Transform, read the point data it stored....
-				MArrayDataHandle hArrCmpdPoseDelta = hCmpdPoseXForm.child( aPoseDelta ) ;	// Get delta cmpd array in pose
-				stat = hArrCmpdPoseDelta.jumpToElement(uPtIdx) ;	// Go to proper index for this point.
-				if (stat != MS::kSuccess)
-					continue ;
-
-				MDataHandle hCmpdPoseDelta = hArrCmpdPoseDelta.inputValue(&stat) ;	// Get cmpd element of delta data
-				if (stat != MS::kSuccess)
-					continue ;
-
-				MDataHandle hPoseDeltaX = hCmpdPoseDelta.child( aPoseDeltaX ) ;	
-				MDataHandle hPoseDeltaY = hCmpdPoseDelta.child( aPoseDeltaY ) ;	
-				MDataHandle hPoseDeltaZ = hCmpdPoseDelta.child( aPoseDeltaZ ) ;	
-				double dDeltaX = hPoseDeltaX.asDouble() ;
-				double dDeltaY = hPoseDeltaY.asDouble() ;
-				double dDeltaZ = hPoseDeltaZ.asDouble() ;
-
-				// At this point we have the point we are deforming in the main loop here...
-				// We've got the pose weight for the pose we are calculating....
-				// We know which matrix index the offset is for and the relative weight of the transform
-				//		for how much it in particular influences the overal pose against other transforms in the same pose.
-				// So...basic calc is make a ptVector which is in the given matrix space,
-				//		and mult it by the world matrix, this will put the vector into
-				//		world space.  Then tack on this world offset to the point based on weight.
-				//
-				MVector vDelta( dDeltaX, dDeltaY, dDeltaZ) ;
-				// FINDME!
-				if (nDeformSpace == (int)eSpaceJoint)		// Joint space
-					vDelta = vDelta * matArr[nMatIdx] ;			// Mult by proper matrix
-				else if (nDeformSpace == (int)eSpacePose)	// Pose space
-					vDelta = vDelta * matReader ;				// Mult by proper matrix
-
-					// Take into acct user scale...this effectively increases or decreases
-					// the stored "offset" so that if the rig is scaling, we can dampend down
-					// or raise up as needed.  In World Space!
-				vDelta.x *= dUserScaleX ;
-				vDelta.y *= dUserScaleY ;
-				vDelta.z *= dUserScaleZ ;
-
-					// Now offset point by amount of this pose.  We base change both on actual live weight
-					//	as well as stored xform strength.  This is typically is 1/#infl that made the pose,
-					//	so that if 3 influences created this, each one would do 1/3 of the work to make the 
-					//	final pose.
-					//
-				ptDef = ptDef + ( (dPoseWt * dPoseXFormStr) * vDelta ) ;
-
-//				cout << name << ": nMatIdx=" << nMatIdx << " dPoseXFormStr=" << dPoseXFormStr << " dPoseWt=" << dPoseWt << endl ;
-				
-				} while (hArrCmpdPoseXForm.next()) ;	// Go thru each XForm in pose
-
-
-			} while (hArrCmpdPose.next()) ;		// End of each pose
-
-	
-
-	    //
-	    // end of poseDeformer algorithm ************************************
-
-
-		// Do final blending on point between what is deformed, and original based on Maya deformer weight and envelope.
-		double dPct = fWt * fEnv ;
-		ptDef = ((1.0-dPct) * ptWorld) + (dPct * ptDef);
-
-		ptDef = ptDef * invmatWorld ;		// Back to local space
-		iter.setPosition( ptDef ) ;
-
-	    } // end of iter
-
-
-	// Free any alloced sutff
-	//
-	if (matArr != NULL)
-		{
-		delete [] matArr ;
-		matArr = NULL ;
-		}
-
-	return MS::kSuccess ;   // if we got this far, return success.
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * poseDeformer::readMatrixArray() - Reads in the matrix array of data of all infl matrices
- *		Sets a ptr to the allocated matrices, and sets uMat to number alloced.
- */
-MStatus poseDeformer::readMatrixArray(MDataBlock& data, MString name, MMatrix **matArr, unsigned &uMat)
-{
-	MStatus stat ;
-	
-	MMatrix *matPtr = NULL ;
-
-	*matArr = NULL ;
-	uMat = 0 ;
-
-	MArrayDataHandle hArrWorldMatrix = data.inputArrayValue( aWorldMatrix, &stat) ;
-		MERR(stat, name+MString(": Cannot obtain worldMatrix array data handle.")) ;
-	
-	// First pass, go thru all of the entries and see what highed logical index is..
-	do
-		{
-		unsigned uIdx = hArrWorldMatrix.elementIndex(&stat) ;
-		if (stat != MS::kSuccess)
-			continue ;
-		if (uIdx >= uMat)
-			uMat = uIdx + 1 ;
-
-		} while (hArrWorldMatrix.next()) ;
-
-	// Alloc Matrix array
-	if (uMat == 0)
-		return MS::kFailure ;		// nothing to alloc!
-
-
-	matPtr = new MMatrix [uMat] ;
-	if (matPtr == NULL)
-		return MS::kFailure ;		// out of memory.
-	*matArr = matPtr ;
-
-		// RESET
-	hArrWorldMatrix = data.inputArrayValue( aWorldMatrix, &stat) ;
-
-	// Second pass, actually read in each matrix...
-	unsigned uIdx ;
-	for (uIdx=0; uIdx < uMat; ++uIdx)
-		{
-		stat = hArrWorldMatrix.jumpToElement( uIdx ) ;
-		if (stat != MS::kSuccess)
-			continue ;
-
-		MDataHandle hEleWorldMatrix = hArrWorldMatrix.inputValue(&stat) ;
-		if (stat != MS::kSuccess)
-			continue ;
-
-			// Store it in the array!
-		matPtr[uIdx] = hEleWorldMatrix.asMatrix();	
-		}
-
-	return MS::kSuccess ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * readPoseWeights()  - Reads weights for all the poses in
- */
-MStatus poseDeformer::readPoseWeights(MDataBlock& data, MString name, 
-			unsigned &uPoses, MDoubleArray &dArrWts, int nIsolate,
-			MVectorArray &vArrRead, MVector &vCur, const MMatrix *matArr )
-{
-	MStatus stat ;
-    uPoses = 0 ;
-
-	// Get handle to main pose cmpd array...
-	MArrayDataHandle hArrCmpdPose = data.inputArrayValue( aPose, &stat) ;
-	if (stat != MS::kSuccess)
-		return stat ;
-
-	// Pass 1 see how many
-	do
-		{
-		unsigned uIdx = hArrCmpdPose.elementIndex() ;
-		if (stat != MS::kSuccess)
-			continue ;
-		if (uIdx >= uPoses)
-			uPoses = uIdx + 1 ;
-
-		} while (hArrCmpdPose.next()) ;		// End of each pose
-
-	if (uPoses == 0)
-		return MS::kFailure ;		// nothing to alloc!
-
-	// Alloc
-	stat = dArrWts.setLength(uPoses) ;
-	stat = vArrRead.setLength(uPoses) ;
-
-	// RESET
-	hArrCmpdPose = data.inputArrayValue( aPose, &stat) ;
-
-	// Second pass, actually read in each weight...
-	unsigned uIdx ;
-	for (uIdx=0; uIdx < uPoses; ++uIdx)
-		{
-		stat = hArrCmpdPose.jumpToElement( uIdx ) ;
-		if (stat != MS::kSuccess)
-			continue ;
-		
-		MDataHandle hCmpdPose = hArrCmpdPose.inputValue(&stat) ;		// Get compound element item.
-		if (stat != MS::kSuccess)
-			continue ;
-
-		MDataHandle hPoseActive = hCmpdPose.child( aPoseActive ) ;	// See if pose is even active
-		bool bPoseActive = hPoseActive.asBool() ;
-
-		if (!bPoseActive)
-			{
-			dArrWts[uIdx] = 0.0 ;
-			// Had to remove continue here so we still get vector and stuff right for RBF so mesh doesn't wig out.
-			// I believe this is because later non-initialized vectors would have a -1.QNAN value possibly.
-			}
-		else
-			{
-			MDataHandle hPoseWt = hCmpdPose.child( aPoseWeight ) ;	// Get child weight attr.
-			dArrWts[uIdx] = hPoseWt.asDouble() ;
-			}
-
-
-
-		if (nIsolate > 0)
-			{
-			// Now if we are isolating, set any weight not at the isolate index to 0,
-			// and the weight at this index to 1.  Have to use -1 since 0 means off..so 1=first.
-			//
-			unsigned uIso = nIsolate - 1 ;
-			if (uIdx == uIso)
-				dArrWts[uIdx] = 1.0 ;
-			else
-				dArrWts[uIdx] = 0.0 ;
-			}
-			
-
-		// Read in stuff for RBF mode...kinda a hack for now.  We just use the first pose
-		// xform in each pose...ie: if 2 joints are creating a pose, we're really only using 
-		// whichever one is connected first.
-
-		// Now get proper cmp pose element...
-		MArrayDataHandle hArrCmpdPoseXForm = hCmpdPose.child( aPoseXForm ) ;	// Get cmpd array of xforms in pose
-		MDataHandle hCmpdPoseXForm  = hArrCmpdPoseXForm.inputValue(&stat) ;	// Get 0th xform element
-		// and index
-		MDataHandle hPoseXFormIdx = hCmpdPoseXForm.child( aPoseXFormIdx ) ;
-		int nMatIdx = hPoseXFormIdx.asInt() ;
-		// And in each pose, go thru each transform that generated it...
-		MDataHandle hPoseXFormWorldMatrix = hCmpdPoseXForm.child( aPoseXFormWorldMatrix ) ;	// Get poseReader matrix for this pose/xform combo
-		MMatrix matReader = hPoseXFormWorldMatrix.asMatrix();
-		// And also see which axis is used.
-		MDataHandle hPoseXFormReadAxis = hCmpdPoseXForm.child( aPoseXFormReadAxis ) ;	// Get poseReader matrix for this pose/xform combo
-		int nReadAxis = hPoseXFormReadAxis.asShort() ;
-		
-
-		// Now store vector for current and where each pose is so RBF mode can interpolate.
-		//
-		MVector vec ;
-		if (nReadAxis == 0)
-			vec = MVector(1.0, 0.0, 0.0) ;
-		else if (nReadAxis == 1)
-			vec = MVector(0.0, 1.0, 0.0) ;
-		else
-			vec = MVector(0.0, 0.0, 1.0) ;
-		vArrRead[uIdx] = vec * matReader ;		// Now get the real vector in world space based on the pose reader matrix.
-		// Kinda a hack here too, we'll keep updaing vCur.  The last pose will be the one
-		// that determines which axis and joint is being used for "current".  Under normal circumstances
-		// this is fine, since if one is using the RBF mode they will have to have separate poseDeformers
-		// for each section of the body or joint anyhow...
-		vCur = vec * matArr[ nMatIdx ] ;		
-		
-
-
-		} while (hArrCmpdPose.next()) ;		// End of each pose
-
-	return MS::kSuccess ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * normalizeWeights() - Normalizes wts if total > 1.  If less than 0, leave as is..so I guess this
- *		isn't a true normalize...but it's what I want in this case.
- *
- */
-MStatus poseDeformer::normalizeWeights(MDoubleArray &dArrWts) 
-{
-	MStatus stat ; 
-
-	unsigned u ;
-
-    unsigned uWts = dArrWts.length() ;
-	if (uWts <= 1)
-		return MS::kSuccess ;
-
-	double dTotal = 0.0 ;
-	for (u=0; u < uWts; ++u)
-		dTotal += dArrWts[u] ;			// Add up totals
-
-	
-	if (dTotal > 1.00)
-		{
-		for (u=0; u < uWts; ++u)
-			dArrWts[u] = dArrWts[u] / dTotal ;
-		}
-
-	return MS::kSuccess ;
-}
-
-
-// ---------------------------------------------------------------------------
-
-/*
- * poseDeformer::smoothStep() - Take a value from 0-1 and instead of having it be linear,
- *			make it ease out and then in from the 0 and 1 locations.
- */
-double poseDeformer::smoothStep(const double &dVal)
-{
-	// x^2*(3-2x)
-	double dRet = dVal * dVal * (3.0 - (2.0 * dVal) );
-	return dRet ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * poseDeformer::smoothGaussian() - Take a value from 0-1 and instead of having it be linear,
- *			make it ease out and then in from the 0 and 1 locations.  This has more of a longer
- *			ease than a smoothstep and so a faster falloff in the middle.
- */
-double poseDeformer::smoothGaussian(const double &dVal)
-{
-	// 1.0 - exp( (-1 * x^2 ) / (2*sigma^2) )
-	
-	double dSigma = 1.0 ;		// Must be >0.   As drops to zero, higher value one lasts longer.
-
-	double dRet = (1.0 - exp( -1.0 * (dVal*dVal) * 10.0  / (2.0 * dSigma*dSigma)  ) );	// RBF
-	return dRet ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * interpWeights() - Does a smooth weight interp based on where we are.
- *		This uses LU Factorization with my custom MatrixNN class
- */
-MStatus poseDeformer::interpWeights(MDoubleArray &dArrWts, 
-		const MVectorArray &vArrRead,
-		const MVector &vCur, const double &dRBFWidth)
-{
-	MStatus stat ;
-
-	unsigned uPoses = vArrRead.length() ;
-	if (uPoses < 2)
-		return MS::kSuccess ;
-
-
-		// Calc inverse width
-	double dInvWidth = 1.0 ;
-	if (dRBFWidth != 0)
-		dInvWidth = 1.0 / dRBFWidth ;
-
-		// And then sigma squared
-	double dSigma2 = - ( dInvWidth * dInvWidth );
-
-
-	MatrixNN matNNA ;	// Make the A matrix for Ax = b.  
-	matNNA.setDimension( uPoses ) ;		// alloc enough space for it.
-
-	unsigned i,j ;
-	for (i=0; i < uPoses; ++i)
-		{
-		for (j=0; j < uPoses; ++j)
-			{
-			// Now store how far away each pose is from each other pose.
-			// ie: for pose i=#  compare to the pose j=#.  The diagonal will be
-			// all zeros, which is why the LU factorization requires pivoting.
-			//
-			// Note: We normalize distance within 0-1 for better results.
-			//	Easy since at max a pose can be 180 degrees away, or pi-radians away.
-			//  So we just get the angle between and divide by pi to normalize.
-			//
-			double dDist = 	vArrRead[i].angle( vArrRead[j]) / 3.14159 ;
-			matNNA[i][j] = exp( dSigma2 * dDist * dDist) ;	// e^(sigma*(dDist^2)) 
-			} // end of j cols
-
-		} // end of i rows
-
-
-	// Now we've got our matrix built...make our "b" array/vector of doubles.
-	// as well as the X output weights
-	double *ptrB = NULL ;
-	double *ptrX = NULL ;
-	ptrB = new double [uPoses] ;
-	ptrX = new double [uPoses] ;
-
-	// now we count up orig weights and we use this when normalizing later.
-	// This lets us kinda fake using cones, even tho technically the values
-	// could be 1.0 for all ofB, and or the cones could all be 180.  But this
-	// way we'll smoothly ramp down if cone values fall off.  Plus by using
-	// the array wt value here for B we also handle twist on cone disabling...
-	double dTotalOrig = 0.0 ;
-	for (i=0; i < uPoses; ++i)
-		{
-		ptrB[i] = dArrWts[i] ;			// We could do 1.0 here, need to test.
-		dTotalOrig += dArrWts[i] ;
-		}
-	if (dTotalOrig > 1.0)
-		dTotalOrig = 1.0 ;
-	
-	// Now we are ready to do.  This will solve Ax=b using LU-Factorization.
-	bool bSolve = matNNA.solveLU(ptrB, ptrX) ;
-	if (!bSolve)
-		{
-		// uh-oh the matrix wasn't factorable
-		MGlobal::displayWarning(name()+MString(": poseDeformer Unable to factorize matrix for LU Decomposition.")) ;
-		for (i=0; i < uPoses; ++i)
-			dArrWts[i] = 0.0 ;
-		delete [] ptrB ;		// Dealloc before we exit!
-		delete [] ptrX ;
-		return MS::kFailure ;
-		}
-
-	// now that we've solved...we'll store the real weight...
-	//
-	double dTotal = 0.0 ;
-	for (i=0; i < uPoses; ++i)
-		{
-		double dDist = vCur.angle( vArrRead[i]) / 3.14159 ;		// Where are we relative to this pose?
-		dArrWts[i] = dArrWts[i] * exp( dSigma2 * dDist * dDist ) ;	// w_[i] * e^(sigma * |pose-pose[i]|) 
-		if (dArrWts[i] < 0.0)
-			dArrWts[i] = 0.0 ;
-		dTotal += dArrWts[i] ;
-		}
-
-	// Now renormalize to a value of what we want...
-	for (i=0; i < uPoses && dTotal != 0.0; ++i)
-		dArrWts[i] = dArrWts[i] / dTotal * dTotalOrig ;
-	
-
-	delete [] ptrB ;		// Dealloc before we exit!
-	delete [] ptrX ;
-
-
-	return MS::kSuccess ;
-}
-
-// ---------------------------------------------------------------------------
-
-// ---------------------------------------------------------------------------
-//	Math Procs
-// ---------------------------------------------------------------------------
-
-// ---------------------------------------------------------------------------
-
-/*
- * cartesianToSpherical() - Convert an XYZ value into a spherical coord.
- */
-void cartesianToSpherical(const double &x, const double &y, const double &z, 
-						double &r, double &phi, double &theta)
-{
-	r = sqrt( x*x + y*y + z*z) ;
-	phi = atan( y / x ) ;
-	theta = acos( z / (sqrt(r)) );
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * sphericalToCartesian() - Convert an spherical value into a cart coord.
- */
-void sphericalToCartesian(const double &r, const double &phi, const double &theta, 
-						double &x, double &y, double &z)
-{
-	x = r * sin(theta) * cos(phi) ;
-	y = r * sin(theta) * sin(phi) ;
-	z = r * cos(theta) ;
-}
-
-// ---------------------------------------------------------------------------
-
-
-/*
- * cartesianToCylindrical() - Convert an XYZ value into a cylindrical coord.
- */
-void cartesianToCylindrical(const double &x, const double &y, const double &z, 
-						double &r, double &theta, double &zc)
-{
-	r = sqrt( x*x + y*y) ;
-	theta = atan( y / x ) ;
-	zc = z ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * cylindricalToCartesian() - Convert an cyl value into a cart coord.
- */
-void cylindricalToCartesian(const double &r, const double &theta, const double &zc, 
-						double &x, double &y, double &z)
-{
-	x = r * cos(theta) ;
-	y = r * sin(theta) ;
-	z = zc ;
-}
-
-// ---------------------------------------------------------------------------
-
-
-/*
- * cartesianToPolar() - Convert an XY value into a polar coord.
- */
-void cartesianToPolar(const double &x, const double &y,
-						double &r, double &theta)
-{
-	r = sqrt( x*x + y*y) ;
-	theta = atan( y / x ) ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * polarToCartesian() - Convert an polar value into a cart coord.
- */
-void polarToCartesian(const double &r, const double &theta,
-						double &x, double &y)
-{
-	x = r * cos(theta) ;
-	y = r * sin(theta) ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * arclength() - Given radius and degrees apart, get arclen.
- */
-double arclength(const double &r, const double &theta)
-{
-	return (r * theta) ;
-}
-
-// ---------------------------------------------------------------------------
-
-/*
- * cartesianToSphericalUV() - x,y,z should be a normalize vector.
- */
-void cartesianToSphericalUV(const double &x, const double &y, const double &z,
-							double &u, double &v)
-{
-	// Make X go from 0-1 as we go ALL the way around.  ie: instead of just pure
-	// X being -1 to 1.  We want to change to so -1=1 on right side, 
-	// And if z > 0  then we use x as 0-1 and if <= -1 to 0
-	//
-	double dx ;
-	if (z >= 0)
-		{
-		dx = (x + 1.0) / 2.0 ;	// Convert from -1...1  to 0...1
-		}
-	else
-		{
-		dx = ((x + 1.0) / 2.0) * -1.0 ;	// Convert from 1...-1  to -1...0
-		}
-
-	u = asin( dx ) / PI + 0.5 ;
-	v = asin( y ) / PI + 0.5 ;
-
-}
-
-
-// ---------------------------------------------------------------------------
-
-/*
- * dist2D() - Computes distance/length of a 2D vector
- */
-inline double dist2D(const double &x, const double &y)
-{
-	return ( sqrt(x*x + y*y) );
-}
-
-// ---------------------------------------------------------------------------
+// ---------------------------------------------------------------------------
+// poseDeformer.cpp - C++ File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	The poseDeformer deformer plugin
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// VERSIONS:
+//	09/22/04 - comet - Initial Rev
+//	1.03 - 10/05/04 - mcomet - Fixed so does entire loop of all points even
+//				if not in membership, so that targets work and ed-mem works.
+//				Also removed MProgressWindow since seemed buggy.
+//	1.04 - 10/07/04 - mcomet - Made it so now much faster at generating poses.
+//	1.05 - 10/15/04 - mcomet - Now has new RBF interpolation mode.
+//	1.06 - 10/16/04 - mcomet - Added mirrorData node to help with mirroring.
+//	1.07 - 11/03/04 - mcomet - Now only uses membership points when creating
+//				targets, also put in missing scripts to ZIP file.
+//  1.09c - 12/01/04 - mcomet - Now has option for joint-space vs. pose-space
+//				deformation.  So that the sculpt is either tied to the joint
+//				or the reader as it is brought back up.
+//	1.10 - 01/21/05 - mcomet - Fix for wig out mesh when pose deleted.
+//	1.11 - 08/05/05 - mcomet - Now has user Scale settings.
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+
+
+// ---------------------------------------------------------------------------
+
+/*
+ * Includes
+ */
+#include <string.h>
+#include <fstream>
+#include <iostream>
+#include <math.h>
+
+#include "poseDeformer.h" 
+#include "plugin.h" 
+#include "MatrixNN.h"
+#include "MatrixN.h"
+#include "poseDeformerKernel.h"
+
+// ---------------------------------------------------------------------------
+
+/*
+ * For local testing of nodes you can use any identifier between 
+ * 0x00000000 and 0x0007ffff, but for any node that you plan to use 
+ * for more permanent purposes, you should get a universally unique id 
+ * from Alias|Wavefront Assist. You will be assigned a unique range 
+ * that you can manage on your own.
+ */
+MTypeId poseDeformer::id( ID_POSEDEFORMER );
+
+/*
+ * static attributes
+ */
+MObject	poseDeformer::aInputSettings ;		// Cmpd input settings
+MObject	poseDeformer::aBlendMode ;			// Do normal additive, or try to normalize weights if >1.0?
+MObject	poseDeformer::aIsolate ;			// Turn on a specific pose weight 100% for editing/viewing.
+MObject	poseDeformer::aRBFWidth ;			// Width of blending for Radial Basis Function/LU Factorization
+MObject	poseDeformer::aRBFRegularize ;		// Added down the RBF matrix diagonal so it always factors
+MObject	poseDeformer::aRBFKernel ;			// Falloff curve, Gaussian, or compact Wendland/SmoothStep/SmoothGaussian/Linear
+MObject	poseDeformer::aRBFFeature ;			// Compare poses by the first reader axis, or every xform's orientation?
+MObject	poseDeformer::aRBFFastKernel ;		// Build the RBF matrix with the approximate acos?
+MObject	poseDeformer::aDeformSpace ;		// Deform relative to joint space or poseReader space?
+MObject	poseDeformer::aUserScale ;			// Cmpd scale of how much to alter output by
+MObject	poseDeformer::aUserScaleX ;			// X
+MObject	poseDeformer::aUserScaleY ;			// Y
+MObject	poseDeformer::aUserScaleZ ;			// Z
+MObject	poseDeformer::aNumThreads ;			// How many threads to split the point loop into.  0=Maya default.
+MObject	poseDeformer::aParallelThreshold ;	// Min num of pts before we bother threading
+MObject	poseDeformer::aKernelMode ;			// Which SIMD path to run the delta math on.
+MObject	poseDeformer::aEvalSchedule ;		// Loop over pts then poses, or poses then pts?
+MObject	poseDeformer::aReaderMode ;			// Pose weights from connected poseReaders, or our own cone readers?
+
+
+MObject	poseDeformer::aInputData ;			// Cmpd input data
+MObject	poseDeformer::aWorldMatrix ;		// Array of world matrix's for each live skin infl object.  Matches skinCluser "matrix" attr.
+
+MObject	poseDeformer::aPose ;				// Cmpd array of poses
+MObject poseDeformer::aPoseName ;			// String for user defined name for pose
+MObject	poseDeformer::aPoseWeight ;			// Weight of the pose
+MObject	poseDeformer::aPoseActive;			// True if this pose is not currently deleted.
+MObject	poseDeformer::aPoseXForm ;			// Cmpd Array of Data of point for each xform that created this pose.
+MObject	poseDeformer::aPoseXFormStr ;		// Relative str of the given transform for this pose.  Usually 1/#posexforms when the pose was made
+MObject	poseDeformer::aPoseXFormIdx ;		// Index of which infl the data is stored for.
+MObject	poseDeformer::aPoseXFormWorldMatrix ; // World Matrix for this poseReader
+MObject poseDeformer::aPoseXFormReadAxis ;	// What axis this poseReader is using...
+MObject	poseDeformer::aPoseXFormConeAngle ;	// Cone angle for the internal reader, in degrees
+MObject	poseDeformer::aPoseXFormNumPts ;		// Num of Delta Pts
+MObject	poseDeformer::aPoseDelta ;			// Cmpd array delta points for the pose one for each pt
+MObject	poseDeformer::aPoseDeltaX ;			// What was change in X relative to this matrix?
+MObject	poseDeformer::aPoseDeltaY ;			// What was change in Y relative to this matrix?
+MObject	poseDeformer::aPoseDeltaZ ;			// What was change in Z relative to this matrix?
+
+
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+//	Main Maya Plugin Functions
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::creator() - Proc to allocated a new node
+ */
+void* poseDeformer::creator()
+{
+    return new poseDeformer();
+}
+
+// ---------------------------------------------------------------------------
+
+
+/*
+ * poseDeformerScratch::poseDeformerScratch() - constructor
+ */
+poseDeformerScratch::poseDeformerScratch()
+{
+	ptrMat = NULL ;
+	uMatAlloc = 0 ;
+	ptrCone = NULL ;
+	uConeAlloc = 0 ;
+	uXFormAlloc = 0 ;
+	uPtAlloc = 0 ;
+	uAllocs = 0 ;
+
+	evalData.ptrCache = NULL ;
+	evalData.ptrActive = NULL ;
+	evalData.uActive = 0 ;
+	evalData.ptrGroup = NULL ;
+	evalData.uGroups = 0 ;
+	evalData.nKernel = eKernelScalar ;
+	evalData.nSchedule = eScheduleTile ;
+	evalData.ptrAccX = evalData.ptrAccY = evalData.ptrAccZ = NULL ;
+	evalData.ptrTileFlags = NULL ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerScratch::~poseDeformerScratch() - Destructor
+ */
+poseDeformerScratch::~poseDeformerScratch()
+{
+	free() ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerScratch::free() - Frees any alloced memory
+ */
+void poseDeformerScratch::free(void)
+{
+	if (ptrMat != NULL)
+		delete [] ptrMat ;
+	ptrMat = NULL ;
+	uMatAlloc = 0 ;
+
+	if (ptrCone != NULL)
+		delete [] ptrCone ;
+	ptrCone = NULL ;
+	uConeAlloc = 0 ;
+
+	if (evalData.ptrActive != NULL)
+		delete [] evalData.ptrActive ;
+	if (evalData.ptrGroup != NULL)
+		delete [] evalData.ptrGroup ;
+	evalData.ptrActive = NULL ;
+	evalData.ptrGroup = NULL ;
+	evalData.uActive = evalData.uGroups = 0 ;
+	uXFormAlloc = 0 ;
+
+	if (evalData.ptrAccX != NULL)
+		delete [] evalData.ptrAccX ;
+	if (evalData.ptrTileFlags != NULL)
+		delete [] evalData.ptrTileFlags ;
+	evalData.ptrAccX = evalData.ptrAccY = evalData.ptrAccZ = NULL ;
+	evalData.ptrTileFlags = NULL ;
+	uPtAlloc = 0 ;
+
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerScratch::reserveMatrices() - Makes sure ptrMat holds at least uNum.
+ *		Returns false if out of memory.
+ */
+bool poseDeformerScratch::reserveMatrices(unsigned uNum)
+{
+	if (uNum <= uMatAlloc)
+		return true ;
+
+	if (ptrMat != NULL)
+		delete [] ptrMat ;
+	uMatAlloc = 0 ;
+	ptrMat = new MMatrix [uNum] ;
+	if (ptrMat == NULL)
+		return false ;
+	uMatAlloc = uNum ;
+	++uAllocs ;
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerScratch::reserveCone() - Makes sure ptrCone holds at least uNum xforms.
+ *		Returns false if out of memory.
+ */
+bool poseDeformerScratch::reserveCone(unsigned uNum)
+{
+	if (uNum <= uConeAlloc)
+		return true ;
+
+	if (ptrCone != NULL)
+		delete [] ptrCone ;
+	uConeAlloc = 0 ;
+	ptrCone = new double [uNum * 4] ;
+	if (ptrCone == NULL)
+		return false ;
+	uConeAlloc = uNum ;
+	++uAllocs ;
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerScratch::reserveXForms() - Makes sure the active xform and group lists
+ *		hold at least uNum.  Returns false if out of memory.
+ */
+bool poseDeformerScratch::reserveXForms(unsigned uNum)
+{
+	if (uNum <= uXFormAlloc)
+		return true ;
+
+	if (evalData.ptrActive != NULL)
+		delete [] evalData.ptrActive ;
+	if (evalData.ptrGroup != NULL)
+		delete [] evalData.ptrGroup ;
+	uXFormAlloc = 0 ;
+	evalData.ptrActive = new poseDeformerEvalXForm [uNum] ;
+	evalData.ptrGroup = new poseDeformerEvalGroup [uNum] ;
+	++uAllocs ;
+	if (evalData.ptrActive == NULL || evalData.ptrGroup == NULL)
+		return false ;
+	uXFormAlloc = uNum ;
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerScratch::reservePts() - Makes sure the pose major accumulators hold at
+ *		least uNum pts.  On failure they're left NULL so we fall back to tiles.
+ */
+bool poseDeformerScratch::reservePts(unsigned uNum)
+{
+	if (uNum <= uPtAlloc)
+		return true ;
+
+	if (evalData.ptrAccX != NULL)
+		delete [] evalData.ptrAccX ;
+	if (evalData.ptrTileFlags != NULL)
+		delete [] evalData.ptrTileFlags ;
+	evalData.ptrAccX = evalData.ptrAccY = evalData.ptrAccZ = NULL ;
+	evalData.ptrTileFlags = NULL ;
+	uPtAlloc = 0 ;
+	++uAllocs ;
+
+	double *ptrAcc = new double [uNum * 3] ;
+	unsigned char *ptrFlags = new unsigned char [uNum] ;
+	if (ptrAcc == NULL || ptrFlags == NULL)
+		{
+		if (ptrAcc != NULL)
+			delete [] ptrAcc ;
+		if (ptrFlags != NULL)
+			delete [] ptrFlags ;
+		return false ;
+		}
+
+	evalData.ptrAccX = ptrAcc ;
+	evalData.ptrAccY = ptrAcc + uNum ;
+	evalData.ptrAccZ = ptrAcc + (uNum * 2) ;
+	evalData.ptrTileFlags = ptrFlags ;
+	uPtAlloc = uNum ;
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::poseDeformer() - constructor
+ */
+poseDeformer::poseDeformer() 
+{
+	ptrRBFGroup = NULL ;
+	uRBFGroups = 0 ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::~poseDeformer() - Destructor
+ */
+poseDeformer::~poseDeformer()
+{
+	if (ptrRBFGroup != NULL)
+		delete [] ptrRBFGroup ;
+	ptrRBFGroup = NULL ;
+	uRBFGroups = 0 ;
+}
+
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+//	Attr, Compute and Deform Functions
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+
+
+
+/*
+ * poseDeformer::initialize() - Set up our attrs
+ *
+ * By default, attributes are: 
+ * ---------------------------
+ * readable 
+ * writable 
+ * connectable 
+ * storable 
+ * cached 
+ * not arrays 
+ * have indices that matter 
+ * do not use an array builder 
+ * not keyable 
+ * not hidden 
+ * not used as colors 
+ * not indeterminant 
+ * set to disconnect behavior kNothing 
+ *
+ */
+MStatus poseDeformer::initialize()
+{ 
+    MStatus stat;
+    
+    // local attribute initialization
+    MFnNumericAttribute nAttr ;
+    MFnMatrixAttribute mAttr ;
+    MFnCompoundAttribute cAttr ;
+    MFnEnumAttribute eAttr ;
+    MFnGenericAttribute gAttr ;
+	MFnTypedAttribute tAttr ;
+
+	// Make Attributes
+	//
+	aRBFWidth = nAttr.create("avgPoseSepRBF", "rbfw", MFnNumericData::kDouble, 45) ;
+	nAttr.setMin(0.001) ;
+	nAttr.setMax(180.0) ;
+	nAttr.setKeyable(true) ;
+
+	aRBFRegularize = nAttr.create("rbfRegularize", "rbfr", MFnNumericData::kDouble, 0.0) ;
+	nAttr.setMin(0.0) ;
+	nAttr.setSoftMax(0.1) ;
+	nAttr.setKeyable(true) ;
+
+	aRBFKernel = eAttr.create( "rbfKernel", "rbfk", eRBFGaussian );
+	eAttr.addField("Gaussian", eRBFGaussian) ;
+	eAttr.addField("Wendland", eRBFWendland) ;
+	eAttr.addField("SmoothStep", eRBFSmoothStep) ;
+	eAttr.addField("SmoothGaussian", eRBFSmoothGaussian) ;
+	eAttr.addField("Linear", eRBFLinear) ;
+
+	aRBFFeature = eAttr.create( "rbfFeature", "rbff", eFeatureReadAxis );
+	eAttr.addField("ReadAxis", eFeatureReadAxis) ;
+	eAttr.addField("Orientation", eFeatureOrientation) ;
+
+	aRBFFastKernel = nAttr.create("rbfFastKernel", "rbffk", MFnNumericData::kBoolean, false) ;
+
+	aBlendMode = eAttr.create( "blendMode", "bmod", 2 );
+	eAttr.setKeyable(true);
+	eAttr.addField("Additive", eBlendAdditive) ;
+	eAttr.addField("Normalize", eBlendNormalize) ;
+	eAttr.addField("RBF-LUFactorize", eBlendRBF) ;
+	eAttr.addField("RBF-Solved", eBlendRBFSolved) ;
+
+	aDeformSpace = eAttr.create( "deformSpace", "dspc", 0 );
+	eAttr.setKeyable(true);
+	eAttr.addField("joint-space", eSpaceJoint ) ;
+	eAttr.addField("pose-space", eSpacePose ) ;
+
+	aIsolate = nAttr.create("isolate", "iso", MFnNumericData::kInt, 0) ;
+	nAttr.setMin(0) ;
+	nAttr.setKeyable(true) ;
+
+	aUserScaleX = nAttr.create("userScaleX", "usx", MFnNumericData::kDouble, 1.0 ) ;
+	nAttr.setKeyable(true) ;
+	aUserScaleY = nAttr.create("userScaleY", "usy", MFnNumericData::kDouble, 1.0 ) ;
+	nAttr.setKeyable(true) ;
+	aUserScaleZ = nAttr.create("userScaleZ", "usz", MFnNumericData::kDouble, 1.0 ) ;
+	nAttr.setKeyable(true) ;
+
+	aNumThreads = nAttr.create("numThreads", "nthr", MFnNumericData::kInt, 0) ;
+	nAttr.setMin(0) ;
+	nAttr.setMax(MAXTHREADCHUNKS) ;
+
+	aParallelThreshold = nAttr.create("parallelThreshold", "pthr", MFnNumericData::kInt, 4096) ;
+	nAttr.setMin(0) ;
+
+	aKernelMode = eAttr.create( "kernelMode", "kmod", eKernelAuto );
+	eAttr.addField("Auto", eKernelAuto) ;
+	eAttr.addField("Scalar", eKernelScalar) ;
+	eAttr.addField("SSE4", eKernelSSE4) ;
+	eAttr.addField("AVX2", eKernelAVX2) ;
+	eAttr.addField("AVX-512", eKernelAVX512) ;
+
+	aEvalSchedule = eAttr.create( "evalSchedule", "esch", eScheduleTile );
+	eAttr.addField("Tile", eScheduleTile) ;
+	eAttr.addField("Pose-Major", eSchedulePose) ;
+
+	aReaderMode = eAttr.create( "readerMode", "rdm", eReaderExternal );
+	eAttr.setKeyable(true);
+	eAttr.addField("External", eReaderExternal) ;
+	eAttr.addField("Internal", eReaderInternal) ;
+
+	aUserScale = cAttr.create( "userScale", "uscl") ;
+    cAttr.addChild( aUserScaleX ) ;
+    cAttr.addChild( aUserScaleY ) ;
+    cAttr.addChild( aUserScaleZ ) ;
+
+
+	aInputSettings = cAttr.create( "inputSettings", "inset") ;
+    cAttr.addChild( aRBFWidth ) ;
+    cAttr.addChild( aRBFRegularize ) ;
+    cAttr.addChild( aRBFKernel ) ;
+    cAttr.addChild( aRBFFeature ) ;
+    cAttr.addChild( aRBFFastKernel ) ;
+    cAttr.addChild( aBlendMode ) ;
+    cAttr.addChild( aDeformSpace ) ;
+    cAttr.addChild( aIsolate ) ;
+    cAttr.addChild( aUserScale ) ;
+    cAttr.addChild( aNumThreads ) ;
+    cAttr.addChild( aParallelThreshold ) ;
+    cAttr.addChild( aKernelMode ) ;
+    cAttr.addChild( aEvalSchedule ) ;
+    cAttr.addChild( aReaderMode ) ;
+
+
+/*
+    aMeshIn = fnGenericAttr.create( "meshIn", "mesh", &stat );
+    fnGenericAttr.addAccept(MFnData::kNurbsSurface);
+    fnGenericAttr.addAccept(MFnData::kMesh);
+//    fnGenericAttr.addAccept(MFnData::kSubdSurface);
+*/
+
+	aWorldMatrix = mAttr.create("worldMatrix", "wm", MFnMatrixAttribute::kDouble) ;
+	mAttr.setArray(true);
+	mAttr.setUsesArrayDataBuilder(true);
+
+	aInputData = cAttr.create( "inputData", "indat") ;
+    cAttr.addChild( aWorldMatrix ) ;
+
+	MFnStringData fnStr ;
+	MObject oStr ;
+	oStr = fnStr.create("");  // Set default value.
+	aPoseName = tAttr.create("poseName", "pnm", MFnData::kString, oStr) ;
+
+	aPoseWeight = nAttr.create("poseWeight", "pwt", MFnNumericData::kDouble, 0.0) ;
+	aPoseActive = nAttr.create("poseActive", "pact", MFnNumericData::kBoolean, 1) ;
+
+	aPoseXFormStr = nAttr.create("poseXFormStr", "pxstr", MFnNumericData::kDouble, 0.0) ;
+	aPoseXFormIdx = nAttr.create("poseXFormIdx", "pxidx", MFnNumericData::kInt, -1) ;
+	aPoseXFormWorldMatrix = mAttr.create("poseXFormWorldMatrix", "pxmat", MFnMatrixAttribute::kDouble) ;
+	aPoseXFormReadAxis = eAttr.create( "poseXFormReadAxis", "pxaxi", 1) ;
+	eAttr.addField("X-Axis", 0) ;
+	eAttr.addField("Y-Axis", 1) ;
+	eAttr.addField("Z-Axis", 2) ;
+	aPoseXFormConeAngle = nAttr.create("poseXFormConeAngle", "pxcon", MFnNumericData::kDouble, 45.0) ;
+	nAttr.setMin(0.0) ;
+	nAttr.setMax(180.0) ;
+	aPoseXFormNumPts = nAttr.create("poseXFormNumPts", "pxnpt", MFnNumericData::kInt, 0) ;
+
+
+	aPoseDeltaX = nAttr.create("poseDeltaX", "pdx", MFnNumericData::kDouble, 0.0) ;
+	aPoseDeltaY = nAttr.create("poseDeltaY", "pdy", MFnNumericData::kDouble, 0.0) ;
+	aPoseDeltaZ = nAttr.create("poseDeltaZ", "pdz", MFnNumericData::kDouble, 0.0) ;
+
+	aPoseDelta = cAttr.create( "poseDelta", "pdlt") ;
+	cAttr.setArray(true) ;
+	cAttr.setUsesArrayDataBuilder(true) ;
+    cAttr.addChild( aPoseDeltaX ) ;
+    cAttr.addChild( aPoseDeltaY ) ;
+    cAttr.addChild( aPoseDeltaZ ) ;
+
+	aPoseXForm = cAttr.create( "poseXForm", "pxfm") ;
+	cAttr.setArray(true) ;
+	cAttr.setUsesArrayDataBuilder(true) ;
+	cAttr.addChild( aPoseXFormStr ) ;
+	cAttr.addChild( aPoseXFormIdx ) ;
+	cAttr.addChild( aPoseXFormWorldMatrix ) ;
+	cAttr.addChild( aPoseXFormReadAxis ) ;
+	cAttr.addChild( aPoseXFormConeAngle ) ;
+	cAttr.addChild( aPoseXFormNumPts ) ;
+	cAttr.addChild( aPoseDelta ) ;
+
+
+	aPose = cAttr.create( "pose", "pos") ;
+	cAttr.setArray(true) ;
+	cAttr.setUsesArrayDataBuilder(true) ;
+	cAttr.addChild( aPoseName ) ;
+	cAttr.addChild( aPoseWeight ) ;
+	cAttr.addChild( aPoseXForm ) ;
+	cAttr.addChild( aPoseActive ) ;
+
+
+	// Add Attrs
+	stat = addAttribute( aInputSettings );
+		MERR(stat, "Cannot add attribute aInputSettings.") ;
+	stat = addAttribute( aInputData );
+		MERR(stat, "Cannot add attribute aInputData.") ;
+	stat = addAttribute( aPose );
+		MERR(stat, "Cannot add attribute aPose.") ;
+
+	// Affect them 
+    attributeAffects( aInputSettings, outputGeom );
+    attributeAffects( aInputData, outputGeom );
+    attributeAffects( aPose, outputGeom );
+	
+	return MS::kSuccess;
+}
+
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::deform() - Main deform stuff
+ *
+ * Method: deform
+ *
+ * Description:   Deform the point with a squash algorithm
+ *
+ * Arguments:
+ *   data		: the datablock of the node
+ *   iter		: an iterator for the geometry to be deformed
+ *   m    		: matrix to transform the point into world space
+ *   multiIndex	        : the index of the geometry that we are deforming
+ *
+ */
+MStatus poseDeformer::deform( MDataBlock& data, MItGeometry& iter, const MMatrix& matWorld,	
+						unsigned int multiIndex)
+{
+    MStatus stat;
+
+
+	MMatrix invmatWorld = matWorld.inverse() ;
+
+	MDataHandle hNodeState = data.inputValue( state, &stat) ;
+	int nNodeState = hNodeState.asShort() ;
+	if (nNodeState == 1)
+		return MS::kSuccess ;
+
+    // Envelope data from the base class.
+    // The envelope is simply a scale factor.
+    //
+    MDataHandle hEnvelope = data.inputValue(envelope, &stat);
+    if (MS::kSuccess != stat)  return stat;
+    float fEnv = hEnvelope.asFloat();	
+	if (fEnv <= 0.0)			// if off...done!
+		return MS::kSuccess; 
+
+	// Get other data...
+	//
+    MDataHandle hBlendMode = data.inputValue( aBlendMode, &stat );
+    int nBlendMode = hBlendMode.asShort();	
+
+    MDataHandle hDeformSpace = data.inputValue( aDeformSpace, &stat );
+    int nDeformSpace = hDeformSpace.asShort();	
+	
+    MDataHandle hIsolate = data.inputValue( aIsolate, &stat );
+    int nIsolate = hIsolate.asInt();	
+
+	poseDeformerRBFSettings rbf ;
+    MDataHandle hRBFWidth = data.inputValue( aRBFWidth, &stat );
+    rbf.dWidth = hRBFWidth.asDouble() / 180.0 ;		// We want 0-1, but are giving user 0-180 to be nice.
+    MDataHandle hRBFReg = data.inputValue( aRBFRegularize, &stat );
+    rbf.dLambda = hRBFReg.asDouble() ;
+    MDataHandle hRBFKernel = data.inputValue( aRBFKernel, &stat );
+    rbf.nKernel = hRBFKernel.asShort() ;
+    MDataHandle hRBFFeature = data.inputValue( aRBFFeature, &stat );
+    rbf.nFeature = hRBFFeature.asShort() ;
+    MDataHandle hRBFFastKernel = data.inputValue( aRBFFastKernel, &stat );
+    rbf.bFast = hRBFFastKernel.asBool() ;
+
+    MDataHandle hUserScaleX = data.inputValue( aUserScaleX, &stat );
+    double dUserScaleX = hUserScaleX.asDouble() ;
+    MDataHandle hUserScaleY = data.inputValue( aUserScaleY, &stat );
+    double dUserScaleY = hUserScaleY.asDouble() ;
+    MDataHandle hUserScaleZ = data.inputValue( aUserScaleZ, &stat );
+    double dUserScaleZ = hUserScaleZ.asDouble() ;
+
+    MDataHandle hNumThreads = data.inputValue( aNumThreads, &stat );
+    int nNumThreads = hNumThreads.asInt() ;
+    MDataHandle hParallelThreshold = data.inputValue( aParallelThreshold, &stat );
+    int nParallelThreshold = hParallelThreshold.asInt() ;
+    MDataHandle hKernelMode = data.inputValue( aKernelMode, &stat );
+    int nKernelMode = hKernelMode.asShort() ;
+    MDataHandle hEvalSchedule = data.inputValue( aEvalSchedule, &stat );
+    int nEvalSchedule = hEvalSchedule.asShort() ;
+    MDataHandle hReaderMode = data.inputValue( aReaderMode, &stat );
+    int nReaderMode = hReaderMode.asShort() ;
+
+	// Rebuild our flat copy of the pose data only if it changed since last time.
+	if (cachePose.bDirty)
+		{
+		stat = readPoseCache(data) ;
+		if (stat != MS::kSuccess)
+			return MS::kSuccess ;
+		}
+
+	// Everything below works out of scratch, which only grows when the shape, 
+	// influence or pose counts do.  So a steady state frame allocs nothing.
+	//
+	unsigned uAllocsStart = scratch.uAllocs ;
+	unsigned uMatAllocsStart = MatrixNN::uAllocCount ;
+
+	unsigned uMat = 0 ;			// How big is array?
+    stat = readMatrixArray(data, uMat) ;
+	const MMatrix *matArr = scratch.ptrMat ;		// Array of matrices for each input influence transform.
+
+	// Make sure we had an array of matrices to read...
+	if (stat != MS::kSuccess || uMat == 0 || matArr == NULL)
+		return MS::kSuccess ;
+
+	unsigned uPoses ;
+	MDoubleArray &dArrWts = scratch.dArrWts ;
+	MVectorArray &vArrRead = scratch.vArrRead ;
+	stat = readPoseWeights(data, uPoses, dArrWts, scratch.nArrActive, nIsolate, vArrRead, 
+				scratch.nArrInfl, scratch.vArrCur, matArr, uMat ) ;
+
+	// Make sure we even had poses made...
+	if (stat != MS::kSuccess || uPoses == 0)
+		return MS::kSuccess ;
+
+	// The internal reader replaces whatever was connected to poseWeight.  RBF
+	// still needs these, interpWeights() scales its kernel row by them, only
+	// RBF-Solved works its weights out without them.
+	if (nReaderMode == eReaderInternal && nIsolate == 0 && nBlendMode != eBlendRBFSolved)
+		coneWeights(dArrWts, scratch.nArrActive, matArr, uMat, poseKernelResolve(nKernelMode)) ;
+
+	if (nBlendMode == eBlendNormalize && nIsolate == 0 )
+		{
+		normalizeWeights(dArrWts) ;
+		}
+	else if ((nBlendMode == eBlendRBF || nBlendMode == eBlendRBFSolved) && nIsolate == 0 )
+		{
+		// Each influence's, or set of influences', poses are their own RBF problem.
+		if (groupRBFPoses(dArrWts, scratch.nArrActive, vArrRead, scratch.nArrInfl, scratch.vArrCur, matArr, uMat, rbf.nFeature))
+			solveRBFGroups(dArrWts, rbf, nBlendMode, nNumThreads) ;
+		}
+
+// cout << name() << ": dArrWts="<< dArrWts <<endl ;
+
+
+	// Set up everything the point loop needs...
+	//
+	poseDeformerEvalData &evalData = scratch.evalData ;
+	evalData.ptrCache = &cachePose ;
+	evalData.matWorld = matWorld ;
+	evalData.invmatWorld = invmatWorld ;
+	evalData.nKernel = poseKernelResolve(nKernelMode) ;
+	evalData.nSchedule = nEvalSchedule ;
+
+	// In pose space the world deltas never change between frames, so make sure
+	// they're baked.  If we're out of memory we just use the full map instead.
+	//
+	if (nDeformSpace == (int)eSpacePose)
+		cachePose.bakeWorld() ;
+
+	// Fold everything that is the same for every pt into one map per contributing xform,
+	// then group them by influence so joint space does one matrix per influence.
+	//
+	double dScale[3] = { dUserScaleX, dUserScaleY, dUserScaleZ } ;
+	evalData.uActive = 0 ;
+	evalData.uGroups = 0 ;
+	if (cachePose.uXForms > 0 && scratch.reserveXForms(cachePose.uXForms))
+		{
+		evalData.uActive = buildEvalXForms(cachePose, dArrWts, matArr, uMat, nDeformSpace, dScale, evalData.ptrActive) ;
+		evalData.uGroups = buildEvalGroups(cachePose, matArr, nDeformSpace, dScale, evalData.ptrActive, evalData.uActive, evalData.ptrGroup) ;
+		}
+
+	if (evalData.uActive == 0)		// Nothing is on, so nothing moves.
+		return MS::kSuccess ;
+
+	// PASS 1 - Gather the pos, index and weighting of each point.  The Maya calls
+	// all happen here, so that the actual work below can be split across threads.
+	// Positions come over in one bulk call instead of one call per point.
+	//
+	stat = iter.allPositions( evalData.ptArrPos ) ;
+	if (stat != MS::kSuccess)
+		return stat ;
+	unsigned uPts = evalData.ptArrPos.length() ;
+	if (evalData.nArrPtIdx.length() != uPts)
+		evalData.nArrPtIdx.setLength( uPts ) ;
+	if (evalData.dArrPct.length() != uPts)
+		evalData.dArrPct.setLength( uPts ) ;
+
+	unsigned uPt = 0;
+	for ( iter.reset(); !iter.isDone() && uPt < uPts ; iter.next(), ++uPt ) 
+        {
+		unsigned uPtIdx = iter.index() ;	// Do THIS since we actually store pose data this way...
+
+#if DEBUG > 0
+		cout << "DEBUG: pt [" << uPtIdx << "/" << uPts << "]" << endl ;
+#endif
+		evalData.nArrPtIdx[uPt] = (int)uPtIdx ;
+
+		// What is user assigned weighting for this point?
+		float fWt = weightValue(data, multiIndex, uPtIdx);
+		evalData.dArrPct[uPt] = fWt * fEnv ;
+		}
+	for ( ; uPt < uPts; ++uPt)		// Shouldn't happen, but never deform pts we have no index for.
+		evalData.dArrPct[uPt] = 0.0 ;
+
+	// Pose major needs a world pos accumulator for every pt.  If we can't get it
+	// just fall back to tiles, same answer.
+	//
+	if (nEvalSchedule == (int)eSchedulePose && uPts > 0)
+		scratch.reservePts(uPts) ;
+
+	// PASS 2 - Deform.  Every point only reads shared data and writes its own
+	// slot, so splitting into chunks gives the exact same result as one loop.
+	//
+	unsigned uChunks = (nNumThreads > 0) ? (unsigned)nNumThreads : (unsigned)MThreadUtils::getNumThreads() ;
+	if (uChunks > MAXTHREADCHUNKS)
+		uChunks = MAXTHREADCHUNKS ;
+	if (uChunks > uPts)
+		uChunks = uPts ;
+
+	if (uChunks <= 1 || (int)uPts < nParallelThreshold)
+		{
+		deformPoints(&evalData, 0, uPts) ;
+		}
+	else
+		{
+		poseDeformerEvalTasks evalTasks ;
+		evalTasks.uChunks = uChunks ;
+		unsigned c ;
+		for (c=0; c < uChunks; ++c)
+			{
+			evalTasks.chunk[c].ptrData = &evalData ;
+			evalTasks.chunk[c].uStart = (unsigned)( ((unsigned long long)uPts * c) / uChunks ) ;
+			evalTasks.chunk[c].uEnd = (unsigned)( ((unsigned long long)uPts * (c+1)) / uChunks ) ;
+			}
+
+		stat = MThreadPool::init() ;
+		if (stat == MS::kSuccess)
+			{
+			MThreadPool::newParallelRegion(createEvalTasks, (void *)&evalTasks) ;
+			MThreadPool::release() ;
+			}
+		else
+			deformPoints(&evalData, 0, uPts) ;		// No pool?  Just do it ourselves.
+		}
+
+	// PASS 3 - Put the results back in one go.  Pts we skipped still hold their
+	// original pos, so they come back unchanged.
+	//
+	iter.setAllPositions( evalData.ptArrPos ) ;
+
+#if DEBUG > 0
+	if (scratch.uAllocs != uAllocsStart)
+		cout << "DEBUG: " << name() << " scratch grew " << (scratch.uAllocs - uAllocsStart) << " time(s) this deform, " << scratch.uAllocs << " total." << endl ;
+	if (MatrixNN::uAllocCount != uMatAllocsStart)
+		cout << "DEBUG: " << name() << " MatrixNN alloced " << (MatrixNN::uAllocCount - uMatAllocsStart) << " time(s) this deform, " << MatrixNN::uAllocCount << " total." << endl ;
+#else
+	(void)uAllocsStart ;
+	(void)uMatAllocsStart ;
+#endif
+
+	return MS::kSuccess ;   // if we got this far, return success.
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::buildEvalXForms() - Pre-pass done once per deform.  For each cached
+ *		xform that has a weight this time, fold the matrix it deforms in, the user
+ *		scale, and the pose weight * xform str into a single 3x3 map.  Then the per
+ *		pt work for that xform is just delta * map added on.  In pose space with 
+ *		baked world deltas the map is only user scale * pose wt.
+ *		Returns how many were stored in ptrActive.
+ */
+unsigned poseDeformer::buildEvalXForms(const poseDeformerCache &cache, const MDoubleArray &dArrWts,
+				const MMatrix *matArr, unsigned uMat, int nDeformSpace, const double dScale[3],
+				poseDeformerEvalXForm *ptrActive)
+{
+	unsigned uPoses = dArrWts.length() ;
+	unsigned uActive = 0 ;
+
+	unsigned x ;
+	for (x=0; x < cache.uXForms; ++x)
+		{
+		const poseDeformerXFormCache &xfc = cache.ptrXForm[x] ;
+
+		if (xfc.uPoseIdx >= uPoses)
+			continue ;
+		double dPoseWt = dArrWts[xfc.uPoseIdx] ;		// Get stored weight for that pose
+		if (dPoseWt == 0.0)		// If weight is zero, nothing to do anyhow...
+			continue ;
+
+			// Only joint space reads matArr, pose space uses the stored reader matrix
+			// so an influence that isn't connected any more still deforms there.
+			//
+		if (nDeformSpace == (int)eSpaceJoint && (unsigned)xfc.nMatIdx >= uMat)		// Make sure a valid index.
+			continue ;
+
+		// So...basic calc is make a ptVector which is in the given matrix space,
+		//		and mult it by the world matrix, this will put the vector into
+		//		world space.  Then tack on this world offset to the point based on weight.
+		//
+		const MMatrix *ptrMat = NULL ;
+		if (nDeformSpace == (int)eSpaceJoint)		// Joint space
+			ptrMat = &matArr[xfc.nMatIdx] ;
+		else if (nDeformSpace == (int)eSpacePose)	// Pose space
+			ptrMat = &xfc.matReader ;
+
+			// Now offset point by amount of this pose.  We base change both on actual live weight
+			//	as well as stored xform strength.  This is typically is 1/#infl that made the pose,
+			//	so that if 3 influences created this, each one would do 1/3 of the work to make the 
+			//	final pose.
+			//
+		double dWt = dPoseWt * xfc.dStr ;
+
+			// Take into acct user scale...this effectively increases or decreases
+			// the stored "offset" so that if the rig is scaling, we can dampend down
+			// or raise up as needed.  In World Space!  So it scales the columns.
+			//
+		poseDeformerEvalXForm &exf = ptrActive[uActive] ;
+		exf.uXForm = x ;
+		exf.dWt = dWt ;
+		exf.bBaked = false ;
+		exf.bDiag = false ;
+		unsigned r, c ;
+
+			// Pose space with baked deltas, matrix and str are already in there, 
+			// so all that is left is user scale * pose wt on the diagonal.
+			//
+		if (nDeformSpace == (int)eSpacePose && cache.ptrWorld != NULL)
+			{
+			exf.bBaked = true ;
+			exf.bDiag = true ;
+			for (r=0; r < 3; ++r)
+				for (c=0; c < 3; ++c)
+					exf.dMap[(r*3)+c] = (r == c) ? (dScale[c] * dPoseWt) : 0.0 ;
+			++uActive ;
+			continue ;
+			}
+
+		for (r=0; r < 3; ++r)
+			{
+			for (c=0; c < 3; ++c)
+				{
+				double dVal = (ptrMat != NULL) ? (*ptrMat)(r, c) : ((r == c) ? 1.0 : 0.0) ;
+				exf.dMap[(r*3)+c] = dVal * (dScale[c] * dWt) ;
+				}
+			}
+		++uActive ;
+		}
+
+	return uActive ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::buildEvalGroups() - Pre-pass done once per deform after buildEvalXForms().
+ *		In joint space the map is linear in the delta, so all xforms driven by the 
+ *		same influence can be summed as wt * delta in that influence's space first, 
+ *		then put thru the influence matrix just once per pt.  Sorts ptrActive by
+ *		influence (keeping the order within an influence) and fills in ptrGroup.  
+ *		Influences with only one xform, and every xform outside joint space, 
+ *		keep their own full map.  Returns how many groups.
+ */
+unsigned poseDeformer::buildEvalGroups(const poseDeformerCache &cache, const MMatrix *matArr, 
+				int nDeformSpace, const double dScale[3],
+				poseDeformerEvalXForm *ptrActive, unsigned uActive, poseDeformerEvalGroup *ptrGroup)
+{
+	unsigned a, b, r, c ;
+
+	bool bJoint = (nDeformSpace == (int)eSpaceJoint) ;
+	if (bJoint)
+		{
+		// Stable insertion sort by influence, lists are short.
+		for (a=1; a < uActive; ++a)
+			{
+			poseDeformerEvalXForm exf = ptrActive[a] ;
+			int nMatIdx = cache.ptrXForm[exf.uXForm].nMatIdx ;
+			for (b=a; b > 0 && cache.ptrXForm[ptrActive[b-1].uXForm].nMatIdx > nMatIdx; --b)
+				ptrActive[b] = ptrActive[b-1] ;
+			ptrActive[b] = exf ;
+			}
+		}
+
+	unsigned uGroups = 0 ;
+	for (a=0; a < uActive; a = b)
+		{
+		int nMatIdx = cache.ptrXForm[ptrActive[a].uXForm].nMatIdx ;
+		b = a + 1 ;
+		if (bJoint)
+			{
+			while (b < uActive && cache.ptrXForm[ptrActive[b].uXForm].nMatIdx == nMatIdx)
+				++b ;
+			}
+
+		poseDeformerEvalGroup &grp = ptrGroup[uGroups] ;
+		grp.uFirst = a ;
+		grp.uCount = b - a ;
+		grp.bFactored = (grp.uCount > 1) ;		// Not worth it for just one.
+		++uGroups ;
+
+		if (!grp.bFactored)
+			continue ;
+
+		const MMatrix &mat = matArr[nMatIdx] ;
+		for (r=0; r < 3; ++r)
+			for (c=0; c < 3; ++c)
+				grp.dMap[(r*3)+c] = mat(r, c) * dScale[c] ;
+
+		// Members now only scale their delta by their wt.
+		unsigned m ;
+		for (m=a; m < b; ++m)
+			{
+			poseDeformerEvalXForm &exf = ptrActive[m] ;
+			exf.bDiag = true ;
+			for (r=0; r < 3; ++r)
+				for (c=0; c < 3; ++c)
+					exf.dMap[(r*3)+c] = (r == c) ? exf.dWt : 0.0 ;
+			}
+		}
+
+	return uGroups ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::scanTile() - Looks at the uCount pts from uTile on.  Returns true if any
+ *		of them is weighted and has pose data, and sets bContiguous if their pt 
+ *		indices run in order and are all inside the cache, so the kernel can be 
+ *		pointed right at the cache instead of copying the deltas out first.
+ */
+bool poseDeformer::scanTile(const poseDeformerEvalData *ptrData, unsigned uTile, unsigned uCount, bool &bContiguous)
+{
+	const poseDeformerCache &cache = *(ptrData->ptrCache) ;
+
+	unsigned uFirstIdx = (unsigned)ptrData->nArrPtIdx[uTile] ;
+	bContiguous = true ;
+	bool bAnyToDo = false ;
+	unsigned k ;
+	for (k=0; k < uCount; ++k)
+		{
+		unsigned uPtIdx = (unsigned)ptrData->nArrPtIdx[uTile+k] ;
+		if (uPtIdx != uFirstIdx + k)
+			bContiguous = false ;
+		if (ptrData->dArrPct[uTile+k] > 0.0 && uPtIdx < cache.uPts)
+			bAnyToDo = true ;
+		}
+	if (uFirstIdx + uCount > cache.uPts)
+		bContiguous = false ;		// Runs off the end of the cache, so copy with zeros.
+
+	return bAnyToDo ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::accumulateXForm() - Adds active xform a's delta * map on to the uCount
+ *		world pos in dOut, for the pts from uTile on.  uCount must be <= KERNELTILE.
+ *		Sparse xforms only add on to the pts in the tile they have a delta for.
+ */
+void poseDeformer::accumulateXForm(const poseDeformerEvalData *ptrData, unsigned a, 
+				unsigned uTile, unsigned uCount, bool bContiguous,
+				double *dOutX, double *dOutY, double *dOutZ)
+{
+	const poseDeformerCache &cache = *(ptrData->ptrCache) ;
+	const poseDeformerEvalXForm &exf = ptrData->ptrActive[a] ;
+	unsigned x = exf.uXForm ;
+	unsigned uFirstIdx = (unsigned)ptrData->nArrPtIdx[uTile] ;
+	unsigned k ;
+
+	const double *dSrcX = exf.bBaked ? cache.worldX(x) : cache.deltaX(x) ;	// Baked world or raw deltas?
+	const double *dSrcY = exf.bBaked ? cache.worldY(x) : cache.deltaY(x) ;
+	const double *dSrcZ = exf.bBaked ? cache.worldZ(x) : cache.deltaZ(x) ;
+
+	if (!cache.ptrXForm[x].bDense)
+		{
+		unsigned uTmpSlot[KERNELTILE], uTmpDelta[KERNELTILE] ;		// Sparse hits in tile
+		const unsigned *uArrIdx = cache.idx(x) ;
+		unsigned uNumDeltas = cache.ptrXForm[x].uNumDeltas ;
+		unsigned uHits = 0 ;
+		if (bContiguous)
+			{
+			unsigned s ;
+			for (s=cache.findIdx(x, uFirstIdx); s < uNumDeltas && uArrIdx[s] < uFirstIdx + uCount; ++s)
+				{
+				uTmpSlot[uHits] = uArrIdx[s] - uFirstIdx ;
+				uTmpDelta[uHits] = s ;
+				++uHits ;
+				}
+			}
+		else
+			{
+			for (k=0; k < uCount; ++k)
+				{
+				unsigned uPtIdx = (unsigned)ptrData->nArrPtIdx[uTile+k] ;
+				unsigned s = cache.findIdx(x, uPtIdx) ;
+				if (s < uNumDeltas && uArrIdx[s] == uPtIdx)
+					{
+					uTmpSlot[uHits] = k ;
+					uTmpDelta[uHits] = s ;
+					++uHits ;
+					}
+				}
+			}
+		if (uHits > 0 && exf.bDiag)
+			poseKernelScatterDiag(exf.dMap, dSrcX, dSrcY, dSrcZ, uTmpDelta, uTmpSlot, uHits, dOutX, dOutY, dOutZ) ;
+		else if (uHits > 0)
+			poseKernelScatter(exf.dMap, dSrcX, dSrcY, dSrcZ, uTmpDelta, uTmpSlot, uHits, dOutX, dOutY, dOutZ) ;
+		return ;
+		}
+
+	double dTmpX[KERNELTILE], dTmpY[KERNELTILE], dTmpZ[KERNELTILE] ;			// Gathered deltas
+	const double *dX, *dY, *dZ ;
+	if (bContiguous)
+		{
+		dX = dSrcX + uFirstIdx ;
+		dY = dSrcY + uFirstIdx ;
+		dZ = dSrcZ + uFirstIdx ;
+		}
+	else
+		{
+		for (k=0; k < uCount; ++k)
+			{
+			unsigned uPtIdx = (unsigned)ptrData->nArrPtIdx[uTile+k] ;
+			if (uPtIdx < cache.uPts)
+				{
+				dTmpX[k] = dSrcX[uPtIdx] ;
+				dTmpY[k] = dSrcY[uPtIdx] ;
+				dTmpZ[k] = dSrcZ[uPtIdx] ;
+				}
+			else
+				dTmpX[k] = dTmpY[k] = dTmpZ[k] = 0.0 ;
+			}
+		dX = dTmpX ;
+		dY = dTmpY ;
+		dZ = dTmpZ ;
+		}
+
+#if DEBUG > 0
+	double dDiff = poseKernelCheck(ptrData->nKernel, exf.bDiag, exf.dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, uCount) ;
+	if (dDiff != 0.0)
+		cout << "DEBUG: " << poseKernelName(ptrData->nKernel) << " kernel off from scalar by " << dDiff << endl ;
+#endif
+	if (exf.bDiag)
+		poseKernelAccumulateDiag(ptrData->nKernel, exf.dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, uCount) ;
+	else
+		poseKernelAccumulate(ptrData->nKernel, exf.dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, uCount) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::accumulateGroup() - Adds group g on to the uCount world pos in dOut, for
+ *		the pts from uTile on.  A factored group sums its members' wt * delta in 
+ *		influence space, then puts that sum thru the influence map once.
+ */
+void poseDeformer::accumulateGroup(const poseDeformerEvalData *ptrData, unsigned g, 
+				unsigned uTile, unsigned uCount, bool bContiguous,
+				double *dOutX, double *dOutY, double *dOutZ)
+{
+	const poseDeformerEvalGroup &grp = ptrData->ptrGroup[g] ;
+	unsigned a ;
+
+	if (!grp.bFactored)
+		{
+		for (a=grp.uFirst; a < grp.uFirst+grp.uCount; ++a)
+			accumulateXForm(ptrData, a, uTile, uCount, bContiguous, dOutX, dOutY, dOutZ) ;
+		return ;
+		}
+
+	double dSumX[KERNELTILE], dSumY[KERNELTILE], dSumZ[KERNELTILE] ;		// Sum in influence space
+	unsigned k ;
+	for (k=0; k < uCount; ++k)
+		dSumX[k] = dSumY[k] = dSumZ[k] = 0.0 ;
+
+	for (a=grp.uFirst; a < grp.uFirst+grp.uCount; ++a)
+		accumulateXForm(ptrData, a, uTile, uCount, bContiguous, dSumX, dSumY, dSumZ) ;
+
+#if DEBUG > 0
+	double dDiff = poseKernelCheck(ptrData->nKernel, false, grp.dMap, dSumX, dSumY, dSumZ, dOutX, dOutY, dOutZ, uCount) ;
+	if (dDiff != 0.0)
+		cout << "DEBUG: " << poseKernelName(ptrData->nKernel) << " kernel off from scalar by " << dDiff << endl ;
+#endif
+	poseKernelAccumulate(ptrData->nKernel, grp.dMap, dSumX, dSumY, dSumZ, dOutX, dOutY, dOutZ, uCount) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::blendPoint() - Do final blending on point between what is deformed, 
+ *		and original based on Maya deformer weight and envelope, and put it back.
+ */
+void poseDeformer::blendPoint(poseDeformerEvalData *ptrData, unsigned uPt, const MPoint &ptWorld, const MPoint &ptDeformed)
+{
+	double dPct = ptrData->dArrPct[uPt] ;
+	if ( dPct <= 0.0 )	// if this pt isn't affected at all...just ignore it!
+		return ;
+	if ((unsigned)ptrData->nArrPtIdx[uPt] >= ptrData->ptrCache->uPts)
+		return ;		// No pose data for it.
+
+	MPoint ptDef = ((1.0-dPct) * ptWorld) + (dPct * ptDeformed);
+
+	ptrData->ptArrPos[uPt] = ptDef * ptrData->invmatWorld ;		// Back to local space
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::deformPoints() - The real poseDeformer algorithm.  Deforms the pts
+ *		from uStart up to (not including) uEnd in iter order.  Safe to call from 
+ *		many threads at once as long as the ranges don't overlap.  Both schedules
+ *		add the xforms on to each pt in the same order with the same kernels, so 
+ *		they give the exact same result.
+ */
+void poseDeformer::deformPoints(poseDeformerEvalData *ptrData, unsigned uStart, unsigned uEnd)
+{
+	if (ptrData->nSchedule == (int)eSchedulePose && ptrData->ptrAccX != NULL)
+		deformPointsPose(ptrData, uStart, uEnd) ;
+	else
+		deformPointsTile(ptrData, uStart, uEnd) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::deformPointsTile() - Works on tiles of KERNELTILE pts at a time.  Each 
+ *		tile starts out at its world pos, then every active xform adds its delta 
+ *		* map on to the whole tile with the SIMD kernel, then the tile is blended 
+ *		and put back.  Everything stays on the stack, but every tile reaches into 
+ *		every xform's delta block.
+ */
+void poseDeformer::deformPointsTile(poseDeformerEvalData *ptrData, unsigned uStart, unsigned uEnd)
+{
+	double dDefX[KERNELTILE], dDefY[KERNELTILE], dDefZ[KERNELTILE] ;			// Deformed world pos
+	MPoint ptArrWorld[KERNELTILE] ;		// Undeformed world pos
+
+	unsigned uTile ;
+	for (uTile=uStart; uTile < uEnd; uTile += KERNELTILE)
+		{
+		unsigned uCount = uEnd - uTile ;
+		if (uCount > KERNELTILE)
+			uCount = KERNELTILE ;
+
+		bool bContiguous ;
+		if (!scanTile(ptrData, uTile, uCount, bContiguous))
+			continue ;		// Nothing in this tile is weighted or has pose data.
+
+		unsigned k ;
+		for (k=0; k < uCount; ++k)
+			{
+			ptArrWorld[k] = ptrData->ptArrPos[uTile+k] * ptrData->matWorld ;
+			dDefX[k] = ptArrWorld[k].x ;
+			dDefY[k] = ptArrWorld[k].y ;
+			dDefZ[k] = ptArrWorld[k].z ;
+			}
+
+		// For these points...go thru each group of active xforms
+		unsigned g ;
+		for (g=0; g < ptrData->uGroups; ++g)
+			accumulateGroup(ptrData, g, uTile, uCount, bContiguous, dDefX, dDefY, dDefZ) ;
+
+		for (k=0; k < uCount; ++k)
+			blendPoint(ptrData, uTile+k, ptArrWorld[k], MPoint(dDefX[k], dDefY[k], dDefZ[k])) ;
+
+		} // end of each tile
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::deformPointsPose() - Pose major order.  First every pt in the range 
+ *		gets its world pos put in the accumulator, then each active xform streams 
+ *		its whole delta block down the range in one go, then one last pass blends
+ *		and puts every pt back.  Costs 3 doubles + 1 byte a pt, but each xform's
+ *		deltas are only walked once, in order.
+ */
+void poseDeformer::deformPointsPose(poseDeformerEvalData *ptrData, unsigned uStart, unsigned uEnd)
+{
+	double *dAccX = ptrData->ptrAccX ;
+	double *dAccY = ptrData->ptrAccY ;
+	double *dAccZ = ptrData->ptrAccZ ;
+	unsigned char *ptrTile = ptrData->ptrTileFlags ;
+
+	unsigned uTile, uCount, k ;
+
+	// Start each pt at its world pos, and remember what each tile needs.
+	for (uTile=uStart; uTile < uEnd; uTile += KERNELTILE)
+		{
+		uCount = (uEnd - uTile > KERNELTILE) ? KERNELTILE : (uEnd - uTile) ;
+
+		bool bContiguous ;
+		ptrTile[uTile] = 0 ;
+		if (!scanTile(ptrData, uTile, uCount, bContiguous))
+			continue ;
+		ptrTile[uTile] = bContiguous ? 2 : 1 ;
+
+		for (k=uTile; k < uTile+uCount; ++k)
+			{
+			MPoint ptWorld = ptrData->ptArrPos[k] * ptrData->matWorld ;
+			dAccX[k] = ptWorld.x ;
+			dAccY[k] = ptWorld.y ;
+			dAccZ[k] = ptWorld.z ;
+			}
+		}
+
+	// Now each group of xforms down the whole range.
+	unsigned g ;
+	for (g=0; g < ptrData->uGroups; ++g)
+		{
+		for (uTile=uStart; uTile < uEnd; uTile += KERNELTILE)
+			{
+			if (ptrTile[uTile] == 0)
+				continue ;
+			uCount = (uEnd - uTile > KERNELTILE) ? KERNELTILE : (uEnd - uTile) ;
+			accumulateGroup(ptrData, g, uTile, uCount, (ptrTile[uTile] == 2), dAccX+uTile, dAccY+uTile, dAccZ+uTile) ;
+			}
+		}
+
+	// Final blend, one pass.
+	for (uTile=uStart; uTile < uEnd; uTile += KERNELTILE)
+		{
+		if (ptrTile[uTile] == 0)
+			continue ;
+		uCount = (uEnd - uTile > KERNELTILE) ? KERNELTILE : (uEnd - uTile) ;
+		for (k=uTile; k < uTile+uCount; ++k)
+			{
+			MPoint ptWorld = ptrData->ptArrPos[k] * ptrData->matWorld ;
+			blendPoint(ptrData, k, ptWorld, MPoint(dAccX[k], dAccY[k], dAccZ[k])) ;
+			}
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::createEvalTasks() - Called by MThreadPool to start one task per chunk.
+ */
+void poseDeformer::createEvalTasks(void *ptrData, MThreadRootTask *ptrRoot)
+{
+	poseDeformerEvalTasks *ptrTasks = (poseDeformerEvalTasks *)ptrData ;
+
+	unsigned c ;
+	for (c=0; c < ptrTasks->uChunks; ++c)
+		MThreadPool::createTask(evalTask, (void *)&ptrTasks->chunk[c], ptrRoot) ;
+
+	MThreadPool::executeAndJoin(ptrRoot) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::evalTask() - One thread's chunk of the point loop.
+ */
+MThreadRetVal poseDeformer::evalTask(void *ptrData)
+{
+	poseDeformerEvalChunk *ptrChunk = (poseDeformerEvalChunk *)ptrData ;
+	deformPoints(ptrChunk->ptrData, ptrChunk->uStart, ptrChunk->uEnd) ;
+	return (MThreadRetVal)0 ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::setDependentsDirty() - Watch for changes to the stored pose data.
+ *		The live pose weights change every frame, but the xform str, idx, reader
+ *		matrices and deltas only change when poses are edited, so only those
+ *		flag our pose cache to be rebuilt on the next deform.
+ */
+MStatus poseDeformer::setDependentsDirty(const MPlug& plugBeingDirtied, MPlugArray& affectedPlugs)
+{
+	MObject oAttr = plugBeingDirtied.attribute() ;
+
+	if (oAttr == aPose || oAttr == aPoseXForm ||
+		oAttr == aPoseXFormStr || oAttr == aPoseXFormIdx ||
+		oAttr == aPoseXFormWorldMatrix || oAttr == aPoseXFormReadAxis || oAttr == aPoseXFormConeAngle ||
+		oAttr == aPoseDelta || oAttr == aPoseDeltaX || oAttr == aPoseDeltaY || oAttr == aPoseDeltaZ)
+		{
+		cachePose.bDirty = true ;
+		}
+
+	return MPxDeformerNode::setDependentsDirty(plugBeingDirtied, affectedPlugs) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::readPoseCache() - Reads the static data of every pose xform into 
+ *		the flat cachePose arrays.  First pass counts the xforms that actually 
+ *		contribute, how many non zero deltas each has, and the highest point index 
+ *		stored.  Then we decide which xforms to keep dense or sparse, and the second 
+ *		pass fills it in.  Exact zero deltas are never stored sparse, since they 
+ *		don't move anything.
+ */
+MStatus poseDeformer::readPoseCache(MDataBlock& data)
+{
+	MStatus stat ;
+
+	cachePose.free() ;
+
+	unsigned uXForms = 0 ;		// How many contributing xforms?
+	unsigned uPts = 0 ;			// How many pts does the biggest delta array need?
+	MIntArray nArrNumDeltas ;	// Non zero deltas in each contributing xform
+
+	unsigned uPass ;
+	for (uPass=0; uPass < 2; ++uPass)
+		{
+		if (uPass == 1)
+			{
+			if (uXForms == 0 || uPts == 0)
+				break ;			// No real data, we're done.
+
+			// Figure out how much room we need.  Sparse costs an index per delta and
+			// scattered access, so only worth it when under half the pts moved.
+			unsigned uNumDeltas = 0 ;
+			unsigned uNumIdx = 0 ;
+			unsigned x ;
+			for (x=0; x < uXForms; ++x)
+				{
+				unsigned uNonZero = (unsigned)nArrNumDeltas[x] ;
+				if (uNonZero * 2 >= uPts)
+					uNumDeltas += uPts * 3 ;
+				else
+					{
+					uNumDeltas += uNonZero * 3 ;
+					uNumIdx += uNonZero ;
+					}
+				}
+
+			if (!cachePose.alloc(uXForms, uPts, uNumDeltas, uNumIdx))
+				return MS::kFailure ;		// out of memory.
+
+			for (x=0; x < uXForms; ++x)
+				{
+				unsigned uNonZero = (unsigned)nArrNumDeltas[x] ;
+				cachePose.ptrXForm[x].bDense = (uNonZero * 2 >= uPts) ;
+				cachePose.ptrXForm[x].uNumDeltas = cachePose.ptrXForm[x].bDense ? uPts : uNonZero ;
+				}
+			if (!cachePose.layout())
+				{
+				cachePose.free() ;
+				return MS::kFailure ;
+				}
+			}
+
+		unsigned x = 0 ;		// Current xform in cache
+
+		// Get handle to main pose cmpd array...
+		MArrayDataHandle hArrCmpdPose = data.inputArrayValue( aPose, &stat) ;
+		if (stat != MS::kSuccess)
+			return stat ;
+
+		do
+			{
+			MDataHandle hCmpdPose = hArrCmpdPose.inputValue(&stat) ;		// Get compound element item.
+			if (stat != MS::kSuccess)
+				continue ;
+
+			unsigned uPoseIdx = hArrCmpdPose.elementIndex(&stat) ;		// What index'd pose are we looking at?
+
+			// And in each pose, go thru each transform that generated it...
+			MArrayDataHandle hArrCmpdPoseXForm = hCmpdPose.child( aPoseXForm ) ;	// Get cmpd array of xforms in pose
+			do
+				{
+				MDataHandle hCmpdPoseXForm  = hArrCmpdPoseXForm.inputValue(&stat) ;	// Get xform element
+				if (stat != MS::kSuccess)
+					continue ;
+
+				double dPoseXFormStr = hCmpdPoseXForm.child( aPoseXFormStr ).asDouble() ;
+				if (dPoseXFormStr == 0.0)		// If weight is zero, it never contributes.
+					continue ;
+
+				int nMatIdx = hCmpdPoseXForm.child( aPoseXFormIdx ).asInt() ;
+				if (nMatIdx < 0)		// Make sure a valid index.
+					continue ;
+
+				if (uPass == 1)
+					{
+					poseDeformerXFormCache &xfc = cachePose.ptrXForm[x] ;
+					xfc.uPoseIdx = uPoseIdx ;
+					xfc.dStr = dPoseXFormStr ;
+					xfc.nMatIdx = nMatIdx ;
+					xfc.matReader = hCmpdPoseXForm.child( aPoseXFormWorldMatrix ).asMatrix() ;
+					xfc.nReadAxis = hCmpdPoseXForm.child( aPoseXFormReadAxis ).asShort() ;
+
+					// Reader axis in world space and the cone, for the internal reader.
+					MVector vRead = readAxis(xfc.nReadAxis) * xfc.matReader ;
+					double dLen = vRead.length() ;
+					if (dLen != 0.0)
+						vRead *= 1.0 / dLen ;
+					double dCone = hCmpdPoseXForm.child( aPoseXFormConeAngle ).asDouble() * PI / 180.0 ;
+					if (dCone < 1e-6)
+						dCone = 1e-6 ;		// Then it's only on right on the axis.
+					cachePose.ptrCone[x] = vRead.x ;
+					cachePose.ptrCone[uXForms + x] = vRead.y ;
+					cachePose.ptrCone[uXForms*2 + x] = vRead.z ;
+					cachePose.ptrCone[uXForms*3 + x] = 1.0 / dCone ;
+					MQuaternion quatReader = MTransformationMatrix(xfc.matReader).rotation() ;
+					xfc.dQuat[0] = quatReader.x ;
+					xfc.dQuat[1] = quatReader.y ;
+					xfc.dQuat[2] = quatReader.z ;
+					xfc.dQuat[3] = quatReader.w ;
+					}
+
+				// And go thru each stored delta.  Array handles walk in increasing
+				// logical index order, so sparse lists come out sorted.
+				MArrayDataHandle hArrCmpdPoseDelta = hCmpdPoseXForm.child( aPoseDelta ) ;	// Get delta cmpd array in pose
+				unsigned uNonZero = 0 ;
+				do
+					{
+					unsigned uPtIdx = hArrCmpdPoseDelta.elementIndex(&stat) ;
+					if (stat != MS::kSuccess)
+						continue ;
+
+					MDataHandle hCmpdPoseDelta = hArrCmpdPoseDelta.inputValue(&stat) ;	// Get cmpd element of delta data
+					if (stat != MS::kSuccess)
+						continue ;
+
+					double dDeltaX = hCmpdPoseDelta.child( aPoseDeltaX ).asDouble() ;
+					double dDeltaY = hCmpdPoseDelta.child( aPoseDeltaY ).asDouble() ;
+					double dDeltaZ = hCmpdPoseDelta.child( aPoseDeltaZ ).asDouble() ;
+					if (dDeltaX == 0.0 && dDeltaY == 0.0 && dDeltaZ == 0.0)
+						continue ;		// Didn't move, nothing to store.
+
+					if (uPass == 0)
+						{
+						if (uPtIdx >= uPts)
+							uPts = uPtIdx + 1 ;
+						++uNonZero ;
+						continue ;
+						}
+
+					const poseDeformerXFormCache &xfc = cachePose.ptrXForm[x] ;
+					unsigned uSlot = uPtIdx ;
+					if (!xfc.bDense)
+						{
+						if (uNonZero >= xfc.uNumDeltas)
+							continue ;		// Shouldn't happen, data matches pass 0.
+						uSlot = uNonZero ;
+						cachePose.idx(x)[uSlot] = uPtIdx ;
+						}
+					cachePose.deltaX(x)[uSlot] = dDeltaX ;
+					cachePose.deltaY(x)[uSlot] = dDeltaY ;
+					cachePose.deltaZ(x)[uSlot] = dDeltaZ ;
+					++uNonZero ;
+
+					} while (hArrCmpdPoseDelta.next()) ;
+
+				if (uPass == 0)
+					nArrNumDeltas.append( (int)uNonZero ) ;
+				++x ;
+
+				} while (hArrCmpdPoseXForm.next()) ;	// Go thru each XForm in pose
+
+			} while (hArrCmpdPose.next()) ;		// End of each pose
+
+		if (uPass == 0)
+			uXForms = x ;
+
+		} // end of each pass
+
+	cachePose.bDirty = false ;
+
+	return MS::kSuccess ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::readMatrixArray() - Reads in the matrix array of data of all infl matrices
+ *		into scratch.ptrMat, and sets uMat to how many.  Unconnected ones are identity.
+ */
+MStatus poseDeformer::readMatrixArray(MDataBlock& data, unsigned &uMat)
+{
+	MStatus stat ;
+	
+	uMat = 0 ;
+
+	MArrayDataHandle hArrWorldMatrix = data.inputArrayValue( aWorldMatrix, &stat) ;
+		MERR(stat, name()+MString(": Cannot obtain worldMatrix array data handle.")) ;
+	
+	// First pass, go thru all of the entries and see what highed logical index is..
+	do
+		{
+		unsigned uIdx = hArrWorldMatrix.elementIndex(&stat) ;
+		if (stat != MS::kSuccess)
+			continue ;
+		if (uIdx >= uMat)
+			uMat = uIdx + 1 ;
+		} while (hArrWorldMatrix.next()) ;
+
+	// Make sure there is room
+	if (uMat == 0)
+		return MS::kFailure ;		// nothing to alloc!
+	if (!scratch.reserveMatrices(uMat))
+		return MS::kFailure ;		// out of memory.
+	MMatrix *matPtr = scratch.ptrMat ;
+
+		// RESET
+	hArrWorldMatrix = data.inputArrayValue( aWorldMatrix, &stat) ;
+
+	// Second pass, actually read in each matrix...
+	unsigned uIdx ;
+	for (uIdx=0; uIdx < uMat; ++uIdx)
+		{
+		matPtr[uIdx] = MMatrix::identity ;		// Scratch holds last frame's, so reset.
+
+		stat = hArrWorldMatrix.jumpToElement( uIdx ) ;
+		if (stat != MS::kSuccess)
+			continue ;
+		MDataHandle hEleWorldMatrix = hArrWorldMatrix.inputValue(&stat) ;
+		if (stat != MS::kSuccess)
+			continue ;
+
+			// Store it in the array!
+		matPtr[uIdx] = hEleWorldMatrix.asMatrix();	
+
+		}
+
+	return MS::kSuccess ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * readPoseWeights()  - Reads weights for all the poses in.  matArr is the uMat
+ *		influence matrices from readMatrixArray(), a pose whose first xform 
+ *		index is past them keeps nArrInfl -1 so the RBF modes leave it out.
+ */
+MStatus poseDeformer::readPoseWeights(MDataBlock& data, 
+			unsigned &uPoses, MDoubleArray &dArrWts, MIntArray &nArrActive, int nIsolate,
+			MVectorArray &vArrRead, MIntArray &nArrInfl, MVectorArray &vArrCur, const MMatrix *matArr, unsigned uMat )
+{
+	MStatus stat ;
+    uPoses = 0 ;
+
+	// Get handle to main pose cmpd array...
+	MArrayDataHandle hArrCmpdPose = data.inputArrayValue( aPose, &stat) ;
+	if (stat != MS::kSuccess)
+		return stat ;
+
+	// Pass 1 see how many
+	do
+		{
+		unsigned uIdx = hArrCmpdPose.elementIndex() ;
+		if (stat != MS::kSuccess)
+			continue ;
+		if (uIdx >= uPoses)
+			uPoses = uIdx + 1 ;
+
+		} while (hArrCmpdPose.next()) ;		// End of each pose
+
+	if (uPoses == 0)
+		return MS::kFailure ;		// nothing to alloc!
+
+	// Alloc, the arrays live in scratch so this is a no-op unless the pose count changed.
+	if (dArrWts.length() != uPoses)
+		stat = dArrWts.setLength(uPoses) ;
+	if (vArrRead.length() != uPoses)
+		stat = vArrRead.setLength(uPoses) ;
+	if (nArrActive.length() != uPoses)
+		stat = nArrActive.setLength(uPoses) ;
+	if (nArrInfl.length() != uPoses)
+		stat = nArrInfl.setLength(uPoses) ;
+	if (vArrCur.length() != uPoses)
+		stat = vArrCur.setLength(uPoses) ;
+
+	// RESET
+	hArrCmpdPose = data.inputArrayValue( aPose, &stat) ;
+
+	// Second pass, actually read in each weight...
+	unsigned uIdx ;
+	for (uIdx=0; uIdx < uPoses; ++uIdx)
+		{
+		dArrWts[uIdx] = 0.0 ;				// Scratch holds last frame's, so clear first.
+		vArrRead[uIdx] = MVector(0.0, 0.0, 0.0) ;
+		nArrActive[uIdx] = 0 ;
+		nArrInfl[uIdx] = -1 ;
+		vArrCur[uIdx] = MVector(0.0, 0.0, 0.0) ;
+
+		stat = hArrCmpdPose.jumpToElement( uIdx ) ;
+		if (stat != MS::kSuccess)
+			continue ;
+		
+		MDataHandle hCmpdPose = hArrCmpdPose.inputValue(&stat) ;		// Get compound element item.
+		if (stat != MS::kSuccess)
+			continue ;
+
+		MDataHandle hPoseActive = hCmpdPose.child( aPoseActive ) ;	// See if pose is even active
+		bool bPoseActive = hPoseActive.asBool() ;
+		nArrActive[uIdx] = bPoseActive ? 1 : 0 ;
+
+		if (!bPoseActive)
+			{
+			dArrWts[uIdx] = 0.0 ;
+			// Had to remove continue here so we still get vector and stuff right for RBF so mesh doesn't wig out.
+			// I believe this is because later non-initialized vectors would have a -1.QNAN value possibly.
+			}
+		else
+			{
+			MDataHandle hPoseWt = hCmpdPose.child( aPoseWeight ) ;	// Get child weight attr.
+			dArrWts[uIdx] = hPoseWt.asDouble() ;
+			}
+
+
+
+		if (nIsolate > 0)
+			{
+			// Now if we are isolating, set any weight not at the isolate index to 0,
+			// and the weight at this index to 1.  Have to use -1 since 0 means off..so 1=first.
+			//
+			unsigned uIso = nIsolate - 1 ;
+			if (uIdx == uIso)
+				dArrWts[uIdx] = 1.0 ;
+			else
+				dArrWts[uIdx] = 0.0 ;
+			}
+			
+
+		// Read in stuff for RBF mode...kinda a hack for now.  We just use the first pose
+		// xform in each pose...ie: if 2 joints are creating a pose, we're really only using 
+		// whichever one is connected first.  That's the ReadAxis feature, the Orientation
+		// feature uses every xform, straight from cachePose, see groupRBFPoses().
+
+		// Now get proper cmp pose element...
+		MArrayDataHandle hArrCmpdPoseXForm = hCmpdPose.child( aPoseXForm ) ;	// Get cmpd array of xforms in pose
+		MDataHandle hCmpdPoseXForm  = hArrCmpdPoseXForm.inputValue(&stat) ;	// Get 0th xform element
+		// and index
+		MDataHandle hPoseXFormIdx = hCmpdPoseXForm.child( aPoseXFormIdx ) ;
+		int nMatIdx = hPoseXFormIdx.asInt() ;
+		// And in each pose, go thru each transform that generated it...
+		MDataHandle hPoseXFormWorldMatrix = hCmpdPoseXForm.child( aPoseXFormWorldMatrix ) ;	// Get poseReader matrix for this pose/xform combo
+		MMatrix matReader = hPoseXFormWorldMatrix.asMatrix();
+		// And also see which axis is used.
+		MDataHandle hPoseXFormReadAxis = hCmpdPoseXForm.child( aPoseXFormReadAxis ) ;	// Get poseReader matrix for this pose/xform combo
+		int nReadAxis = hPoseXFormReadAxis.asShort() ;
+		
+
+		// Now store vector for current and where each pose is so RBF mode can interpolate.
+		//
+		MVector vec = readAxis(nReadAxis) ;
+		vArrRead[uIdx] = vec * matReader ;		// Now get the real vector in world space based on the pose reader matrix.
+		// And where that same axis of the influence is now.  The RBF modes split the
+		// poses up by influence, and in each group the last pose's axis is the one used
+		// for "current", see groupRBFPoses().  An index past the influences we
+		// have (-1 if the xform isn't hooked up) leaves the pose out of them.
+		if (nMatIdx < 0 || (unsigned)nMatIdx >= uMat)
+			continue ;
+		nArrInfl[uIdx] = nMatIdx ;
+		vArrCur[uIdx] = vec * matArr[ nMatIdx ] ;		
+		
+
+
+		} while (hArrCmpdPose.next()) ;		// End of each pose
+
+	return MS::kSuccess ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * normalizeWeights() - Normalizes wts if total > 1.  If less than 0, leave as is..so I guess this
+ *		isn't a true normalize...but it's what I want in this case.
+ *
+ */
+MStatus poseDeformer::normalizeWeights(MDoubleArray &dArrWts) 
+{
+	MStatus stat ; 
+
+	unsigned u ;
+
+    unsigned uWts = dArrWts.length() ;
+	if (uWts <= 1)
+		return MS::kSuccess ;
+
+	double dTotal = 0.0 ;
+	for (u=0; u < uWts; ++u)
+		dTotal += dArrWts[u] ;			// Add up totals
+
+	
+	if (dTotal > 1.00)
+		{
+		for (u=0; u < uWts; ++u)
+			dArrWts[u] = dArrWts[u] / dTotal ;
+		}
+
+	return MS::kSuccess ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::readAxis() - Unit vector for a poseXFormReadAxis value.
+ */
+MVector poseDeformer::readAxis(int nReadAxis)
+{
+	if (nReadAxis == 0)
+		return MVector(1.0, 0.0, 0.0) ;
+	else if (nReadAxis == 1)
+		return MVector(0.0, 1.0, 0.0) ;
+	return MVector(0.0, 0.0, 1.0) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::coneWeights() - The internal poseReader, so the pose weights don't
+ *		need a poseReader node per xform wired into poseWeight.  Each xform's 
+ *		reader axis and cone are already in cachePose, so this only finds 
+ *		where each axis is now, then poseKernelCone() weights every xform in
+ *		one pass.  A pose's weight is the weights of its xforms multiplied, 
+ *		ie: every joint that made it has to be back in its cone.  Inactive 
+ *		poses and poses with no xforms get 0.
+ */
+void poseDeformer::coneWeights(MDoubleArray &dArrWts, const MIntArray &nArrActive, const MMatrix *matArr, unsigned uMat, int nKernel)
+{
+	unsigned uPoses = dArrWts.length() ;
+	unsigned uXForms = cachePose.uXForms ;
+	unsigned i, x ;
+
+	for (i=0; i < uPoses; ++i)
+		dArrWts[i] = 0.0 ;
+	if (uXForms == 0 || !scratch.reserveCone(uXForms))
+		return ;
+
+	// Where each reader axis is now, same SoA layout as cachePose.ptrCone.
+	double *dCur = scratch.ptrCone ;
+	for (x=0; x < uXForms; ++x)
+		{
+		const poseDeformerXFormCache &xfc = cachePose.ptrXForm[x] ;
+		MVector vCur(0.0, 0.0, 0.0) ;
+		if ((unsigned)xfc.nMatIdx < uMat)
+			vCur = readAxis(xfc.nReadAxis) * matArr[ xfc.nMatIdx ] ;
+		double dLen = vCur.length() ;
+		if (dLen != 0.0)
+			vCur *= 1.0 / dLen ;
+		dCur[x] = vCur.x ;
+		dCur[uXForms + x] = vCur.y ;
+		dCur[uXForms*2 + x] = vCur.z ;
+		}
+
+	double *dWt = dCur + uXForms*3 ;
+	poseKernelCone(nKernel, cachePose.ptrCone, dCur, uXForms, cachePose.coneInv(), dWt, uXForms) ;
+
+	// Xforms are in pose order, so each pose's are all together.
+	x = 0 ;
+	while (x < uXForms)
+		{
+		unsigned uPoseIdx = cachePose.ptrXForm[x].uPoseIdx ;
+		double dPoseWt = 1.0 ;
+		for ( ; x < uXForms && cachePose.ptrXForm[x].uPoseIdx == uPoseIdx; ++x)
+			{
+			if ((unsigned)cachePose.ptrXForm[x].nMatIdx >= uMat)
+				dPoseWt = 0.0 ;		// Influence isn't there.
+			dPoseWt *= dWt[x] ;
+			}
+		if (uPoseIdx < uPoses && nArrActive[uPoseIdx] != 0)
+			dArrWts[uPoseIdx] = dPoseWt ;
+		}
+}
+
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::smoothStep() - Take a value from 0-1 and instead of having it be linear,
+ *			make it ease out and then in from the 0 and 1 locations.
+ */
+double poseDeformer::smoothStep(const double &dVal)
+{
+	// x^2*(3-2x)
+	double dRet = dVal * dVal * (3.0 - (2.0 * dVal) );
+	return dRet ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::smoothGaussian() - Take a value from 0-1 and instead of having it be linear,
+ *			make it ease out and then in from the 0 and 1 locations.  This has more of a longer
+ *			ease than a smoothstep and so a faster falloff in the middle.
+ */
+double poseDeformer::smoothGaussian(const double &dVal)
+{
+	// 1.0 - exp( (-1 * x^2 ) / (2*sigma^2) )
+	
+	double dSigma = 1.0 ;		// Must be >0.   As drops to zero, higher value one lasts longer.
+
+	double dRet = (1.0 - exp( -1.0 * (dVal*dVal) * 10.0  / (2.0 * dSigma*dSigma)  ) );	// RBF
+	return dRet ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::rbfSigma2() - The -(1/width)^2 the Gaussian RBF kernel uses.
+ */
+double poseDeformer::rbfSigma2(const double &dRBFWidth)
+{
+		// Calc inverse width
+	double dInvWidth = 1.0 ;
+	if (dRBFWidth != 0)
+		dInvWidth = 1.0 / dRBFWidth ;
+
+		// And then sigma squared
+	return - ( dInvWidth * dInvWidth );
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::rbfParam() - What rbfKernel() needs for these settings, the 
+ *		Gaussian's -(1/width)^2 or 1/support radius for the compact kernels.
+ */
+double poseDeformer::rbfParam(const poseDeformerRBFSettings &rbf)
+{
+	if (rbf.nKernel == (int)eRBFGaussian)
+		return rbfSigma2(rbf.dWidth) ;
+
+	double dSupport = RBFSUPPORT ;
+	if (rbf.dWidth != 0)
+		dSupport = rbf.dWidth * RBFSUPPORT ;
+	return 1.0 / dSupport ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::rbfKernel() - phi(dDist) for a normalized 0-1 distance, exactly.  
+ *		Every kernel but the Gaussian is zero once r = dDist/support reaches 1.
+ *		Wendland is the C2 (1-r)^4 (4r+1), close to the Gaussian of the same 
+ *		width inside that, but only poses within the support of each other 
+ *		ever see each other.  SmoothStep and SmoothGaussian are the old 
+ *		smoothStep() and smoothGaussian() ease curves run backwards over the 
+ *		support, Linear is just 1-r.  Only the Gaussian and Wendland are 
+ *		positive definite, the others can need the LU fallback or rbfRegularize.
+ */
+double poseDeformer::rbfKernel(int nKernel, double dParam, double dDist)
+{
+	if (nKernel == (int)eRBFGaussian)
+		return exp( dParam * dDist * dDist) ;	// e^(sigma*(dDist^2)) 
+
+	double dR = dDist * dParam ;
+	if (dR >= 1.0)
+		return 0.0 ;
+	if (dR < 0.0)
+		dR = 0.0 ;
+
+	double dT = 1.0 - dR ;
+	switch (nKernel)
+		{
+		case eRBFSmoothStep:
+			return 1.0 - smoothStep(dR) ;
+		case eRBFSmoothGaussian:
+			return 1.0 - smoothGaussian(dR) / smoothGaussian(1.0) ;		// So it still reaches 0 at the support
+		case eRBFLinear:
+			return dT ;
+		}
+
+	dT = dT * dT ;
+	return dT * dT * (4.0 * dR + 1.0) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::buildRBFLUT() - Samples rbfKernel() into lut for these settings.
+ *		The compact kernels are sampled out to their support, the Gaussian
+ *		out to RBFGAUSSRANGE widths, and neither past the 0-1 distances 
+ *		there are.  Interpolating the Gaussian over 4096 intervals that way is
+ *		off by under 6e-7 wherever the width is.  lut.bValid is left false 
+ *		if out of memory.
+ */
+void poseDeformer::buildRBFLUT(poseDeformerRBFLUT &lut, const poseDeformerRBFSettings &rbf)
+{
+	if (!lut.alloc())
+		return ;		// out of memory.
+
+	double dParam = rbfParam(rbf) ;
+	double dRange ;
+	if (rbf.nKernel == (int)eRBFGaussian)
+		dRange = RBFGAUSSRANGE * sqrt( -1.0 / dParam) ;
+	else
+		dRange = 1.0 / dParam ;
+	if (dRange > 1.001)
+		dRange = 1.001 ;	// angle/3.14159 can go a hair over 1
+
+	lut.dScale = (double)RBFLUTSIZE / dRange ;
+	unsigned i ;
+	for (i=0; i <= RBFLUTSIZE; ++i)
+		lut.ptrTable[i] = rbfKernel(rbf.nKernel, dParam, (double)i / lut.dScale) ;
+	lut.ptrTable[RBFLUTSIZE+1] = lut.ptrTable[RBFLUTSIZE] ;
+
+	lut.nKernel = rbf.nKernel ;
+	lut.dWidth = rbf.dWidth ;
+	lut.bValid = true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::rbfPhi() - phi(dDist) for one distance, from rbf.ptrLUT when 
+ *		there is one, so the entries filled one by one match rbfKernelArray().
+ */
+double poseDeformer::rbfPhi(const poseDeformerRBFSettings &rbf, double dParam, double dDist)
+{
+	if (rbf.ptrLUT != NULL)
+		return rbf.ptrLUT->lookup(dDist) ;
+	return rbfKernel(rbf.nKernel, dParam, dDist) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::rbfKernelArray() - dVal[j] = phi(dVal[j]) for uCount distances, in place.
+ *		Read out of rbf.ptrLUT with poseKernelLookup() when there is one, so 
+ *		whichever kernel it is there's no exp or branching per entry.
+ */
+void poseDeformer::rbfKernelArray(const poseDeformerRBFSettings &rbf, double dParam, double *dVal, unsigned uCount)
+{
+	if (rbf.ptrLUT != NULL)
+		{
+		const poseDeformerRBFLUT &lut = *rbf.ptrLUT ;
+		poseKernelLookup(poseKernelResolve(eKernelAuto), lut.ptrTable, RBFLUTSIZE, lut.dScale, dVal, uCount) ;
+		return ;
+		}
+
+	unsigned j ;
+	for (j=0; j < uCount; ++j)
+		dVal[j] = rbfKernel(rbf.nKernel, dParam, dVal[j]) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::rbfDistRow() - dDist[j] = normalized 0-1 distance from member nFrom,
+ *		or from where the group is now if nFrom < 0, to members uFirst and up.
+ *		ReadAxis is the angle between the reader vectors.  Orientation goes thru 
+ *		poseKernelQuatDist() over the group's packed features, so every xform 
+ *		of a multi joint pose counts.  With rbf.bFast both use the SIMD acos 
+ *		approximation, ReadAxis over the unit vectors in grp.ptrUnit.
+ */
+void poseDeformer::rbfDistRow(poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf, int nFrom, unsigned uFirst, double *dDist)
+{
+	const MVectorArray &vArrRead = grp.vArrRead ;
+	unsigned uPoses = vArrRead.length() ;
+	if (uFirst >= uPoses)
+		return ;
+	int nKernel = poseKernelResolve(eKernelAuto) ;
+	unsigned j, r ;
+
+	if (grp.uSlots == 0 && rbf.bFast)
+		{
+		double dDir[3] ;
+		for (r=0; r < 3; ++r)
+			dDir[r] = (nFrom < 0) ? grp.ptrCurUnit[r] : grp.ptrUnit[r*uPoses + nFrom] ;
+		poseKernelDirDot(nKernel, dDir, grp.ptrUnit + uFirst, uPoses, dDist + uFirst, uPoses - uFirst) ;
+		poseKernelFastAcos(nKernel, 1.0 / 3.14159, dDist + uFirst, uPoses - uFirst) ;
+		return ;
+		}
+
+	if (grp.uSlots == 0)
+		{
+		// Note: We normalize distance within 0-1 for better results.
+		//	Easy since at max a pose can be 180 degrees away, or pi-radians away.
+		//  So we just get the angle between and divide by pi to normalize.
+		//
+		const MVector &vFrom = (nFrom < 0) ? grp.vCur : vArrRead[nFrom] ;
+		for (j=uFirst; j < uPoses; ++j)
+			dDist[j] = vFrom.angle( vArrRead[j]) / 3.14159 ;
+		return ;
+		}
+
+	const double *dQuery = grp.ptrCur ;
+	if (nFrom >= 0)
+		{
+		unsigned uRows = 4 * grp.uSlots ;
+		for (r=0; r < uRows; ++r)
+			grp.ptrQuery[r] = grp.ptrFeat[r*uPoses + nFrom] ;
+		dQuery = grp.ptrQuery ;
+		}
+
+	poseKernelQuatDist(nKernel, dQuery, grp.uSlots, grp.ptrFeat + uFirst, uPoses, dDist + uFirst, uPoses - uFirst, rbf.bFast) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::fillRBFMatrix() - Builds the RBF kernel matrix between every pair
+ *		of poses, with dLambda added down the diagonal (Tikhonov regularization).
+ *		phi only depends on the distance, so A is symmetric and only the upper
+ *		triangle is worked out, each row then copied down its column.
+ */
+void poseDeformer::fillRBFMatrix(MatrixNN &matNNA, poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf)
+{
+	unsigned uPoses = grp.vArrRead.length() ;
+	double dParam = rbfParam(rbf) ;
+
+	unsigned i,j ;
+	for (i=0; i < uPoses; ++i)
+		{
+		// Now store how far away each pose is from each other pose.
+		// ie: for pose i=#  compare to the pose j=#.  The diagonal will be
+		// all zeros, which is why the LU factorization requires pivoting.
+		// The distances go right in the row, then become phi in place.
+		//
+		double *dRow = matNNA[i] ;
+		rbfDistRow(grp, rbf, (int)i, i, dRow) ;
+		rbfKernelArray(rbf, dParam, dRow + i, uPoses - i) ;
+		for (j=i+1; j < uPoses; ++j)
+			matNNA[j][i] = dRow[j] ;
+
+		matNNA[i][i] = matNNA[i][i] + rbf.dLambda ;
+
+		} // end of i rows
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::fillRBFSparse() - Same matrix as fillRBFMatrix() for the Wendland
+ *		kernel, but only the pairs of poses within the support of each other are
+ *		set into grp.cacheRBF.matSky.  For ReadAxis they are found via indexRead 
+ *		and then a cheap dot product test against the cos of the support angle.
+ *		The Orientation feature has no index, so each pose's distance row is 
+ *		worked out and kept for the pairs inside the support.  Returns false if 
+ *		out of memory.
+ */
+bool poseDeformer::fillRBFSparse(poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf)
+{
+	const MVectorArray &vArrRead = grp.vArrRead ;
+	poseDeformerRBFIndex &indexRead = grp.cacheRBF.indexRead ;
+	MatrixSkyline &matSky = grp.cacheRBF.matSky ;
+	bool bOrient = (grp.uSlots > 0) ;
+
+	unsigned uPoses = vArrRead.length() ;
+	double dParam = rbfParam(rbf) ;
+
+	double dCosSupport = -2.0 ;			// Support past 180 degrees means every pose.
+	if (dParam > 1.0)
+		dCosSupport = cos( 3.14159 / dParam ) ;
+
+	double *dUnit = NULL ;				// Unit reader vectors for ReadAxis
+	double *dDist = NULL ;				// One distance row for Orientation
+	if (bOrient)
+		dDist = new double [uPoses] ;
+	else
+		dUnit = new double [uPoses * 3] ;
+	unsigned *uNbrStart = new unsigned [uPoses + 1] ;
+	if ((dUnit == NULL && dDist == NULL) || uNbrStart == NULL)
+		{
+		if (dUnit != NULL)
+			delete [] dUnit ;
+		if (dDist != NULL)
+			delete [] dDist ;
+		if (uNbrStart != NULL)
+			delete [] uNbrStart ;
+		return false ;
+		}
+
+	unsigned i, j, k ;
+	for (i=0; i < uPoses && !bOrient; ++i)
+		{
+		MVector vUnit = vArrRead[i] ;
+		double dLen = vUnit.length() ;
+		if (dLen != 0.0)
+			vUnit *= 1.0 / dLen ;
+		dUnit[i*3+0] = vUnit.x ;
+		dUnit[i*3+1] = vUnit.y ;
+		dUnit[i*3+2] = vUnit.z ;
+		}
+
+	// Count the neighbours first, then fill them in.
+	unsigned uNbrs = 0 ;
+	unsigned *uNbr = NULL ;
+	double *dNbrDist = NULL ;			// Distance to each neighbour, Orientation only
+	int nPass ;
+	for (nPass=0; nPass < 2; ++nPass)
+		{
+		uNbrs = 0 ;
+		for (i=0; i < uPoses; ++i)
+			{
+			uNbrStart[i] = uNbrs ;
+			if (bOrient)
+				{
+				rbfDistRow(grp, rbf, (int)i, 0, dDist) ;
+				for (j=0; j < uPoses; ++j)
+					{
+					if (j == i || dDist[j] * dParam >= 1.0)		// Same test rbfKernel() makes
+						continue ;
+					if (uNbr != NULL)
+						{
+						uNbr[uNbrs] = j ;
+						dNbrDist[uNbrs] = dDist[j] ;
+						}
+					++uNbrs ;
+					}
+				continue ;
+				}
+
+			const double *dA = dUnit + i*3 ;
+			unsigned uHits = indexRead.query(vArrRead[i]) ;
+			for (k=0; k < uHits; ++k)
+				{
+				j = indexRead.ptrHits[k] ;
+				const double *dB = dUnit + j*3 ;
+				if (j == i || dA[0]*dB[0] + dA[1]*dB[1] + dA[2]*dB[2] <= dCosSupport)
+					continue ;
+				if (uNbr != NULL)
+					uNbr[uNbrs] = j ;
+				++uNbrs ;
+				}
+			}
+		uNbrStart[uPoses] = uNbrs ;
+
+		if (nPass == 0 && uNbrs > 0)
+			{
+			uNbr = new unsigned [uNbrs] ;
+			if (uNbr == NULL)
+				break ;
+			if (bOrient)
+				{
+				dNbrDist = new double [uNbrs] ;
+				if (dNbrDist == NULL)
+					break ;
+				}
+			}
+		}
+
+	bool bOk = (uNbrs == 0 || (uNbr != NULL && (!bOrient || dNbrDist != NULL))) ;
+	if (bOk)
+		bOk = matSky.setPattern(uPoses, uNbrStart, uNbr) ;
+
+	if (bOk)
+		{
+		for (i=0; i < uPoses; ++i)
+			{
+			matSky.set(i, i, 1.0 + rbf.dLambda) ;		// phi(0) is 1
+			for (k=uNbrStart[i]; k < uNbrStart[i+1]; ++k)
+				{
+				j = uNbr[k] ;
+				if (j < i)
+					continue ;		// Already set from the other side.
+				double dPairDist = bOrient ? dNbrDist[k] : vArrRead[i].angle( vArrRead[j]) / 3.14159 ;
+				matSky.set(i, j, rbfPhi(rbf, dParam, dPairDist)) ;
+				}
+			}
+		}
+
+	if (dUnit != NULL)
+		delete [] dUnit ;
+	if (dDist != NULL)
+		delete [] dDist ;
+	delete [] uNbrStart ;
+	if (uNbr != NULL)
+		delete [] uNbr ;
+	if (dNbrDist != NULL)
+		delete [] dNbrDist ;
+	return bOk ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::updateRBFCache() - Makes sure grp.cacheRBF holds the factored RBF 
+ *		matrix for the group's reader vectors or features and these settings.  
+ *		The A matrix only depends on those, which hardly ever change, so it is only rebuilt
+ *		and factored when they do.  It's symmetric positive definite, so LDL^T
+ *		is tried first, then LU if that fails (ie: two poses on top of each 
+ *		other with no regularization).
+ *
+ *		Big Wendland pose sets go in matSky instead, with ReadAxis readers bucketed
+ *		in indexRead, unless the support is so wide the envelope is over half
+ *		the dense triangle, where the blocked dense factorization is faster.
+ *		There's no LU to fall back to there, it needs rbfRegularize if two 
+ *		poses coincide.  Check grp.cacheRBF.factored() after.
+ */
+MStatus poseDeformer::updateRBFCache(poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf)
+{
+	const MVectorArray &vArrRead = grp.vArrRead ;
+	poseDeformerRBFCache &cacheRBF = grp.cacheRBF ;
+	if (cacheRBF.isCurrent(vArrRead, grp.ptrFeat, grp.featLength(), rbf))
+		return MS::kSuccess ;
+
+	unsigned uPoses = vArrRead.length() ;
+	bool bSparse = false ;
+	if (rbf.nKernel == (int)eRBFWendland && uPoses > MATRIXN_MAX)
+		{
+		double dSupport = 3.14159 / rbfParam(rbf) ;		// In radians
+		if ((grp.uSlots == 0 && !cacheRBF.indexRead.build(vArrRead, dSupport)) || 
+			!fillRBFSparse(grp, rbf))
+			{
+			cacheRBF.free() ;
+			return MS::kFailure ;		// out of memory.
+			}
+		bSparse = (cacheRBF.matSky.uEnvelope <= uPoses * (uPoses + 1) / 4) ;
+		}
+
+	if (!cacheRBF.alloc(uPoses, bSparse))
+		return MS::kFailure ;		// out of memory.
+	MatrixNNFactor &facA = cacheRBF.facA ;
+	MatrixNN &matNNA = facA.matFac ;	// Make the A matrix for Ax = b.  
+
+	if (bSparse)
+		cacheRBF.matSky.factorizeLDLT() ;
+	else if (uPoses <= MATRIXN_MAX)
+		{
+		fillRBFMatrix(matNNA, grp, rbf) ;
+		facA.factorizeFixed() ;		// Most rigs, fixed size loops in place.
+		}
+	else
+		{
+		fillRBFMatrix(matNNA, grp, rbf) ;
+		if (!facA.factorizeLDLT())
+			{
+			fillRBFMatrix(matNNA, grp, rbf) ;		// LDL^T wrote over it.
+			facA.factorizeLU() ;
+			}
+		}
+	cacheRBF.setKey(vArrRead, grp.ptrFeat, grp.featLength(), rbf) ;
+
+	if (!cacheRBF.factored())		// uh-oh the matrix wasn't factorable, only say so once.
+		grp.bWarn = true ;			// We may be on a worker thread, so solveRBFGroups() says it.
+
+	return MS::kSuccess ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::rbfKernelRow() - dRow[j] = phi(where the group is now, pose j) for 
+ *		every pose, with the same kernel, exact or fast, the matrix was built 
+ *		with, so the weights still hit 1 and 0 right on the poses.  When the 
+ *		ReadAxis Wendland matrix is sparse, phi is only worked out for the poses 
+ *		indexRead says can be inside the support, the rest are 0 without ever 
+ *		taking the angle.
+ */
+void poseDeformer::rbfKernelRow(poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf, double *dRow)
+{
+	const MVectorArray &vArrRead = grp.vArrRead ;
+	const MVector &vCur = grp.vCur ;
+	unsigned uPoses = vArrRead.length() ;
+	double dParam = rbfParam(rbf) ;
+	unsigned j ;
+
+	if (!grp.cacheRBF.bSparse || grp.uSlots > 0)
+		{
+		rbfDistRow(grp, rbf, -1, 0, dRow) ;		// Distances first, then phi in place.
+		rbfKernelArray(rbf, dParam, dRow, uPoses) ;
+		return ;
+		}
+
+	for (j=0; j < uPoses; ++j)
+		dRow[j] = 0.0 ;
+
+	poseDeformerRBFIndex &indexRead = grp.cacheRBF.indexRead ;
+	unsigned uHits = indexRead.query(vCur) ;
+	unsigned h ;
+	for (h=0; h < uHits; ++h)
+		{
+		j = indexRead.ptrHits[h] ;
+		double dDist = vCur.angle( vArrRead[j]) / 3.14159 ;
+		dRow[j] = rbfPhi(rbf, dParam, dDist) ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::solvedWeights() - Real RBF interpolation.  Each pose i gets the weight
+ *		f_i(vCur) = sum_j C[i][j] * phi(vCur, pose j), where the coefficients C 
+ *		solve A C = I so that f_i is exactly 1 at pose i and 0 at every other pose.
+ *		C is solved once with the cached factorization, after that each frame is
+ *		just the kernel row and one dot product per pose.  Inactive poses and
+ *		negative results get 0.
+ *
+ *		A dense C would undo the point of the sparse Wendland matrix, but A is
+ *		symmetric so the weights are also just A^-1 times the kernel row.  
+ *		There that is one sparse solve per frame instead.
+ */
+MStatus poseDeformer::solvedWeights(poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf)
+{
+	MStatus stat ;
+	MDoubleArray &dArrWts = grp.dArrWts ;
+	const MVectorArray &vArrRead = grp.vArrRead ;
+	const MIntArray &nArrActive = grp.nArrActive ;
+	poseDeformerRBFCache &cacheRBF = grp.cacheRBF ;
+
+	unsigned uPoses = vArrRead.length() ;
+	if (uPoses < 2)
+		return MS::kSuccess ;
+
+	stat = updateRBFCache(grp, rbf) ;
+	if (stat != MS::kSuccess)
+		return stat ;		// out of memory.
+
+	unsigned i, j ;
+	if (cacheRBF.bSparse ? !cacheRBF.matSky.bFactored : !cacheRBF.buildCoef())
+		{
+		for (i=0; i < uPoses; ++i)
+			dArrWts[i] = 0.0 ;
+		return MS::kFailure ;
+		}
+
+	// Kernel row, how close are we to each pose.
+	double *dRow = cacheRBF.ptrWork ;
+	rbfKernelRow(grp, rbf, dRow) ;
+
+	if (cacheRBF.bSparse)
+		cacheRBF.matSky.solve(dRow, dRow) ;		// Now the weights, in place.
+
+	for (i=0; i < uPoses; ++i)
+		{
+		double dWt = 0.0 ;
+		if (nArrActive[i] != 0)
+			{
+			if (cacheRBF.bSparse)
+				dWt = dRow[i] ;
+			else
+				{
+				const double *dCoef = cacheRBF.matCoef[i] ;
+				for (j=0; j < uPoses; ++j)
+					dWt += dCoef[j] * dRow[j] ;
+				}
+			}
+		if (dWt < 0.0)
+			dWt = 0.0 ;
+		dArrWts[i] = dWt ;
+		}
+
+	return MS::kSuccess ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * interpWeights() - Does a smooth weight interp based on where we are.
+ *		This uses LU Factorization with my custom MatrixNN class
+ */
+MStatus poseDeformer::interpWeights(poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf)
+{
+	MStatus stat ;
+	MDoubleArray &dArrWts = grp.dArrWts ;
+	const MVectorArray &vArrRead = grp.vArrRead ;
+	poseDeformerRBFCache &cacheRBF = grp.cacheRBF ;
+
+	unsigned uPoses = vArrRead.length() ;
+	if (uPoses < 2)
+		return MS::kSuccess ;
+
+	stat = updateRBFCache(grp, rbf) ;
+	if (stat != MS::kSuccess)
+		return stat ;		// out of memory.
+
+	unsigned i ;
+	if (!cacheRBF.factored())
+		{
+		for (i=0; i < uPoses; ++i)
+			dArrWts[i] = 0.0 ;
+		return MS::kFailure ;
+		}
+
+	// now we count up orig weights and we use this when normalizing later.
+	// This lets us kinda fake using cones, even tho technically the values
+	// could be 1.0 for all ofB, and or the cones could all be 180.  But this
+	// way we'll smoothly ramp down if cone values fall off.  Plus by using
+	// the array wt value here for B we also handle twist on cone disabling...
+	double dTotalOrig = 0.0 ;
+	for (i=0; i < uPoses; ++i)
+		dTotalOrig += dArrWts[i] ;
+	if (dTotalOrig > 1.0)
+		dTotalOrig = 1.0 ;
+	
+	// Now store the real weight.  Nothing here needs the solved x, so there
+	// is no per frame solve, just this O(N) pass.
+	//
+	double *dRow = cacheRBF.ptrWork ;		// Where are we relative to each pose?
+	rbfKernelRow(grp, rbf, dRow) ;
+
+	double dTotal = 0.0 ;
+	for (i=0; i < uPoses; ++i)
+		{
+		dArrWts[i] = dArrWts[i] * dRow[i] ;	// w_[i] * phi(|pose-pose[i]|) 
+		if (dArrWts[i] < 0.0)
+			dArrWts[i] = 0.0 ;
+		dTotal += dArrWts[i] ;
+		}
+
+	// Now renormalize to a value of what we want...
+	for (i=0; i < uPoses && dTotal != 0.0; ++i)
+		dArrWts[i] = dArrWts[i] / dTotal * dTotalOrig ;
+	
+
+
+
+	return MS::kSuccess ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::compareRBFKey() - Compares two sorted influence lists like strings,
+ *		<0, 0 or >0.  A shorter list that matches the start of a longer one is
+ *		the smaller.
+ */
+int poseDeformer::compareRBFKey(const MIntArray &nArrA, unsigned uStartA, unsigned uEndA,
+		const MIntArray &nArrB, unsigned uStartB, unsigned uEndB)
+{
+	for ( ; uStartA < uEndA && uStartB < uEndB; ++uStartA, ++uStartB)
+		{
+		if (nArrA[uStartA] != nArrB[uStartB])
+			return (nArrA[uStartA] < nArrB[uStartB]) ? -1 : 1 ;
+		}
+	if (uStartA < uEndA)
+		return 1 ;
+	if (uStartB < uEndB)
+		return -1 ;
+	return 0 ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::buildRBFKeys() - Works out which influences each pose is read from, 
+ *		into scratch.nArrKey, with pose i's from nArrKeyStart[i] up to 
+ *		nArrKeyStart[i+1].  ReadAxis is just the first xform's influence from
+ *		readPoseWeights().  Orientation is every contributing xform in cachePose, 
+ *		sorted by influence so the same joints in a different connection order 
+ *		still land in the same group, along with which xform each one is.
+ */
+void poseDeformer::buildRBFKeys(const MIntArray &nArrInfl, int nFeature)
+{
+	MIntArray &nArrKeyStart = scratch.nArrKeyStart ;
+	MIntArray &nArrKey = scratch.nArrKey ;
+	MIntArray &nArrKeyXForm = scratch.nArrKeyXForm ;
+	bool bOrient = (nFeature == (int)eFeatureOrientation) ;
+
+	unsigned uPoses = nArrInfl.length() ;
+	unsigned uKeys = bOrient ? cachePose.uXForms : uPoses ;
+	if (nArrKeyStart.length() != uPoses + 1)
+		nArrKeyStart.setLength(uPoses + 1) ;
+	if (nArrKey.length() < uKeys)
+		{
+		nArrKey.setLength(uKeys) ;
+		nArrKeyXForm.setLength(uKeys) ;
+		}
+
+	unsigned uKey = 0 ;
+	unsigned i, x = 0 ;
+	for (i=0; i < uPoses; ++i)
+		{
+		nArrKeyStart[i] = (int)uKey ;
+
+		if (!bOrient)
+			{
+			if (nArrInfl[i] >= 0)
+				{
+				nArrKey[uKey] = nArrInfl[i] ;
+				nArrKeyXForm[uKey] = -1 ;
+				++uKey ;
+				}
+			continue ;
+			}
+
+		// cachePose is in pose order, so this pose's xforms are the next ones.
+		for ( ; x < cachePose.uXForms && cachePose.ptrXForm[x].uPoseIdx <= i; ++x)
+			{
+			if (cachePose.ptrXForm[x].uPoseIdx < i)
+				continue ;		// Shouldn't happen.
+			int nInfl = cachePose.ptrXForm[x].nMatIdx ;
+			unsigned k = uKey ;
+			while (k > (unsigned)nArrKeyStart[i] && nArrKey[k-1] > nInfl)	// Insert in order, there's only a few.
+				{
+				nArrKey[k] = nArrKey[k-1] ;
+				nArrKeyXForm[k] = nArrKeyXForm[k-1] ;
+				--k ;
+				}
+			nArrKey[k] = nInfl ;
+			nArrKeyXForm[k] = (int)x ;
+			++uKey ;
+			}
+		}
+	nArrKeyStart[uPoses] = (int)uKey ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::groupRBFPoses() - Splits the poses up by the influences their readers
+ *		are on, one ptrRBFGroup entry per different set, and copies each group's
+ *		members in.  For ReadAxis that is just the first xform's influence, for
+ *		Orientation it's all of them, so a two joint pose is its own problem 
+ *		with both joints' rotations in its feature.  Groups are kept in 
+ *		increasing influence order so each one lands in the same spot, and 
+ *		keeps its cache, from frame to frame.  The last pose in a group says 
+ *		which axis of the influence is "current", same as the whole node used
+ *		to.  Poses with no xform to read from don't go in any group, and nor
+ *		do ReadAxis poses whose influence index is past the ones we have.
+ *		They keep the weight they came in with.  Returns false if there's 
+ *		nothing to solve.
+ */
+bool poseDeformer::groupRBFPoses(const MDoubleArray &dArrWts, const MIntArray &nArrActive, 
+		const MVectorArray &vArrRead, const MIntArray &nArrInfl, const MVectorArray &vArrCur,
+		const MMatrix *matArr, unsigned uMat, int nFeature)
+{
+	unsigned uPoses = nArrInfl.length() ;
+	bool bOrient = (nFeature == (int)eFeatureOrientation) ;
+	unsigned i, g, k, c ;
+
+	buildRBFKeys(nArrInfl, nFeature) ;
+	const MIntArray &nArrKeyStart = scratch.nArrKeyStart ;
+	const MIntArray &nArrKey = scratch.nArrKey ;
+	const MIntArray &nArrKeyXForm = scratch.nArrKeyXForm ;
+
+	// Count the different keys, smallest first.  There's only ever a 
+	// handful, so just look for the next bigger one each time.  The second
+	// pass hands them out once ptrRBFGroup is the right size.
+	unsigned uGroups = 0 ;
+	int nPass ;
+	for (nPass=0; nPass < 2; ++nPass)
+		{
+		uGroups = 0 ;
+		int nLast = -1 ;		// Pose holding the last key found
+		for (;;)
+			{
+			int nNext = -1 ;
+			for (i=0; i < uPoses; ++i)
+				{
+				unsigned uStart = (unsigned)nArrKeyStart[i] ;
+				unsigned uEnd = (unsigned)nArrKeyStart[i+1] ;
+				if (uStart == uEnd)
+					continue ;
+				if (nLast >= 0 && compareRBFKey(nArrKey, uStart, uEnd, nArrKey, nArrKeyStart[nLast], nArrKeyStart[nLast+1]) <= 0)
+					continue ;
+				if (nNext < 0 || compareRBFKey(nArrKey, uStart, uEnd, nArrKey, nArrKeyStart[nNext], nArrKeyStart[nNext+1]) < 0)
+					nNext = (int)i ;
+				}
+			if (nNext < 0)
+				break ;
+			if (nPass == 1)
+				{
+				MIntArray &nArrGrpInfl = ptrRBFGroup[uGroups].nArrInfl ;
+				unsigned uStart = (unsigned)nArrKeyStart[nNext] ;
+				unsigned uLen = (unsigned)nArrKeyStart[nNext+1] - uStart ;
+				if (nArrGrpInfl.length() != uLen)
+					nArrGrpInfl.setLength(uLen) ;
+				for (k=0; k < uLen; ++k)
+					nArrGrpInfl[k] = nArrKey[uStart + k] ;
+				}
+			++uGroups ;
+			nLast = nNext ;
+			}
+
+		if (nPass == 0 && uGroups != uRBFGroups)
+			{
+			// Influences were added or removed, so every group starts over.
+			if (ptrRBFGroup != NULL)
+				delete [] ptrRBFGroup ;
+			ptrRBFGroup = NULL ;
+			uRBFGroups = 0 ;
+			if (uGroups == 0)
+				return false ;
+			ptrRBFGroup = new poseDeformerRBFGroup [uGroups] ;
+			if (ptrRBFGroup == NULL)
+				return false ;
+			uRBFGroups = uGroups ;
+			++scratch.uAllocs ;
+			}
+		}
+	if (uRBFGroups == 0)
+		return false ;
+
+	for (g=0; g < uRBFGroups; ++g)
+		{
+		poseDeformerRBFGroup &grp = ptrRBFGroup[g] ;
+		const MIntArray &nArrGrpInfl = grp.nArrInfl ;
+		unsigned uSlots = nArrGrpInfl.length() ;
+
+		unsigned uCount = 0 ;
+		for (i=0; i < uPoses; ++i)
+			{
+			if (compareRBFKey(nArrKey, nArrKeyStart[i], nArrKeyStart[i+1], nArrGrpInfl, 0, uSlots) == 0)
+				++uCount ;
+			}
+
+		if (grp.nArrPose.length() != uCount)
+			{
+			grp.nArrPose.setLength(uCount) ;
+			grp.vArrRead.setLength(uCount) ;
+			grp.dArrWts.setLength(uCount) ;
+			grp.nArrActive.setLength(uCount) ;
+			}
+
+		unsigned uFeatAlloc = grp.uFeatAlloc ;
+		if (!grp.allocFeat(bOrient ? uSlots : 0, uCount))
+			return false ;		// out of memory.
+		if (grp.uFeatAlloc != uFeatAlloc)
+			++scratch.uAllocs ;
+
+		unsigned m = 0 ;
+		for (i=0; i < uPoses; ++i)
+			{
+			if (compareRBFKey(nArrKey, nArrKeyStart[i], nArrKeyStart[i+1], nArrGrpInfl, 0, uSlots) != 0)
+				continue ;
+			grp.nArrPose[m] = (int)i ;
+			grp.vArrRead[m] = vArrRead[i] ;
+			grp.dArrWts[m] = dArrWts[i] ;
+			grp.nArrActive[m] = nArrActive[i] ;
+			MVector vUnit = vArrRead[i] ;
+			double dLen = vUnit.length() ;
+			if (dLen != 0.0)
+				vUnit *= 1.0 / dLen ;
+			grp.ptrUnit[m] = vUnit.x ;
+			grp.ptrUnit[uCount + m] = vUnit.y ;
+			grp.ptrUnit[2*uCount + m] = vUnit.z ;
+			for (k=0; k < grp.uSlots; ++k)
+				{
+				const double *dQuat = cachePose.ptrXForm[ nArrKeyXForm[nArrKeyStart[i] + k] ].dQuat ;
+				for (c=0; c < 4; ++c)
+					grp.ptrFeat[(k*4 + c)*uCount + m] = dQuat[c] ;
+				}
+			++m ;
+			}
+
+		// Every member reads the same influence, but each can use its own
+		// axis of it.  The last member's is the one that counts as current.
+		if (m > 0)
+			grp.vCur = vArrCur[ grp.nArrPose[m-1] ] ;
+		MVector vCurUnit = grp.vCur ;
+		double dCurLen = vCurUnit.length() ;
+		if (dCurLen != 0.0)
+			vCurUnit *= 1.0 / dCurLen ;
+		grp.ptrCurUnit[0] = vCurUnit.x ;
+		grp.ptrCurUnit[1] = vCurUnit.y ;
+		grp.ptrCurUnit[2] = vCurUnit.z ;
+
+		// And where each of the influences is now.
+		for (k=0; k < grp.uSlots; ++k)
+			{
+			MQuaternion quatCur ;		// Identity if the influence isn't there.
+			unsigned uInfl = (unsigned)nArrGrpInfl[k] ;
+			if (uInfl < uMat)
+				quatCur = MTransformationMatrix(matArr[uInfl]).rotation() ;
+			grp.ptrCur[k*4+0] = quatCur.x ;
+			grp.ptrCur[k*4+1] = quatCur.y ;
+			grp.ptrCur[k*4+2] = quatCur.z ;
+			grp.ptrCur[k*4+3] = quatCur.w ;
+			}
+
+		grp.bWarn = false ;
+		}
+
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::solveRBFGroups() - Solves every group's RBF weights and puts them
+ *		back in dArrWts.  Groups don't share anything, so when there is more 
+ *		than one and either one has to be rebuilt, or there are enough poses
+ *		for the per frame work to matter, they're spread over the thread pool.  
+ *		Same answer either way.
+ */
+void poseDeformer::solveRBFGroups(MDoubleArray &dArrWts, const poseDeformerRBFSettings &rbf, int nBlendMode, int nNumThreads)
+{
+	unsigned g, m ;
+
+	// Refill the falloff table if the kernel or width moved, then every 
+	// group reads phi out of it.  Without one it's just done exactly.
+	if (!lutRBF.isCurrent(rbf.nKernel, rbf.dWidth))
+		buildRBFLUT(lutRBF, rbf) ;
+	poseDeformerRBFSettings rbfNow = rbf ;
+	rbfNow.ptrLUT = lutRBF.bValid ? &lutRBF : NULL ;
+
+	unsigned uChunks = (nNumThreads > 0) ? (unsigned)nNumThreads : (unsigned)MThreadUtils::getNumThreads() ;
+	if (uChunks > MAXTHREADCHUNKS)
+		uChunks = MAXTHREADCHUNKS ;
+	if (uChunks > uRBFGroups)
+		uChunks = uRBFGroups ;
+
+	bool bParallel = false ;
+	if (uChunks > 1)
+		{
+		bParallel = (dArrWts.length() >= RBFPARALLELPOSES) ;
+		for (g=0; g < uRBFGroups && !bParallel; ++g)
+			{
+			const poseDeformerRBFGroup &grp = ptrRBFGroup[g] ;
+			if (grp.vArrRead.length() >= 2 && !grp.cacheRBF.isCurrent(grp.vArrRead, grp.ptrFeat, grp.featLength(), rbf))
+				bParallel = true ;
+			}
+		}
+
+	if (bParallel)
+		{
+		poseKernelDetect() ;		// So the threads only ever read the remembered answer.
+
+		poseDeformerRBFTasks rbfTasks ;
+		rbfTasks.uChunks = uChunks ;
+		unsigned c ;
+		for (c=0; c < uChunks; ++c)
+			{
+			poseDeformerRBFChunk &chunk = rbfTasks.chunk[c] ;
+			chunk.ptrGroup = ptrRBFGroup ;
+			chunk.uGroups = uRBFGroups ;
+			chunk.uFirst = c ;
+			chunk.uStep = uChunks ;
+			chunk.ptrRBF = &rbfNow ;
+			chunk.nBlendMode = nBlendMode ;
+			}
+
+		MStatus stat = MThreadPool::init() ;
+		if (stat == MS::kSuccess)
+			{
+			MThreadPool::newParallelRegion(createRBFTasks, (void *)&rbfTasks) ;
+			MThreadPool::release() ;
+			}
+		else
+			bParallel = false ;		// No pool?  Just do it ourselves.
+		}
+
+	if (!bParallel)
+		{
+		for (g=0; g < uRBFGroups; ++g)
+			solveRBFGroup(ptrRBFGroup[g], rbfNow, nBlendMode) ;
+		}
+
+	for (g=0; g < uRBFGroups; ++g)
+		{
+		poseDeformerRBFGroup &grp = ptrRBFGroup[g] ;
+		for (m=0; m < grp.nArrPose.length(); ++m)
+			dArrWts[ grp.nArrPose[m] ] = grp.dArrWts[m] ;
+
+		if (grp.bWarn)		// uh-oh the matrix wasn't factorable, only say so once.
+			{
+			MString strIdx ;
+			for (m=0; m < grp.nArrInfl.length(); ++m)
+				{
+				if (m > 0)
+					strIdx += ", " ;
+				strIdx += grp.nArrInfl[m] ;
+				}
+			MGlobal::displayWarning(name()+MString(": poseDeformer Unable to factorize RBF matrix for the poses on influence ")+strIdx+MString(".  Try raising rbfRegularize.")) ;
+			grp.bWarn = false ;
+			}
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::solveRBFGroup() - One group's weights, for whichever RBF mode.
+ */
+void poseDeformer::solveRBFGroup(poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf, int nBlendMode)
+{
+	if (nBlendMode == (int)eBlendRBFSolved)
+		solvedWeights(grp, rbf) ;
+	else
+		interpWeights(grp, rbf) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::createRBFTasks() - Called by MThreadPool to start one task per RBF chunk.
+ */
+void poseDeformer::createRBFTasks(void *ptrData, MThreadRootTask *ptrRoot)
+{
+	poseDeformerRBFTasks *ptrTasks = (poseDeformerRBFTasks *)ptrData ;
+
+	unsigned c ;
+	for (c=0; c < ptrTasks->uChunks; ++c)
+		MThreadPool::createTask(rbfTask, (void *)&ptrTasks->chunk[c], ptrRoot) ;
+
+	MThreadPool::executeAndJoin(ptrRoot) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformer::rbfTask() - One thread's share of the RBF groups.
+ */
+MThreadRetVal poseDeformer::rbfTask(void *ptrData)
+{
+	poseDeformerRBFChunk *ptrChunk = (poseDeformerRBFChunk *)ptrData ;
+
+	unsigned g ;
+	for (g=ptrChunk->uFirst; g < ptrChunk->uGroups; g += ptrChunk->uStep)
+		solveRBFGroup(ptrChunk->ptrGroup[g], *ptrChunk->ptrRBF, ptrChunk->nBlendMode) ;
+
+	return (MThreadRetVal)0 ;
+}
+
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+//	Math Procs
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+
+/*
+ * cartesianToSpherical() - Convert an XYZ value into a spherical coord.
+ */
+void cartesianToSpherical(const double &x, const double &y, const double &z, 
+						double &r, double &phi, double &theta)
+{
+	r = sqrt( x*x + y*y + z*z) ;
+	phi = atan( y / x ) ;
+	theta = acos( z / (sqrt(r)) );
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * sphericalToCartesian() - Convert an spherical value into a cart coord.
+ */
+void sphericalToCartesian(const double &r, const double &phi, const double &theta, 
+						double &x, double &y, double &z)
+{
+	x = r * sin(theta) * cos(phi) ;
+	y = r * sin(theta) * sin(phi) ;
+	z = r * cos(theta) ;
+}
+
+// ---------------------------------------------------------------------------
+
+
+/*
+ * cartesianToCylindrical() - Convert an XYZ value into a cylindrical coord.
+ */
+void cartesianToCylindrical(const double &x, const double &y, const double &z, 
+						double &r, double &theta, double &zc)
+{
+	r = sqrt( x*x + y*y) ;
+	theta = atan( y / x ) ;
+	zc = z ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * cylindricalToCartesian() - Convert an cyl value into a cart coord.
+ */
+void cylindricalToCartesian(const double &r, const double &theta, const double &zc, 
+						double &x, double &y, double &z)
+{
+	x = r * cos(theta) ;
+	y = r * sin(theta) ;
+	z = zc ;
+}
+
+// ---------------------------------------------------------------------------
+
+
+/*
+ * cartesianToPolar() - Convert an XY value into a polar coord.
+ */
+void cartesianToPolar(const double &x, const double &y,
+						double &r, double &theta)
+{
+	r = sqrt( x*x + y*y) ;
+	theta = atan( y / x ) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * polarToCartesian() - Convert an polar value into a cart coord.
+ */
+void polarToCartesian(const double &r, const double &theta,
+						double &x, double &y)
+{
+	x = r * cos(theta) ;
+	y = r * sin(theta) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * arclength() - Given radius and degrees apart, get arclen.
+ */
+double arclength(const double &r, const double &theta)
+{
+	return (r * theta) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * cartesianToSphericalUV() - x,y,z should be a normalize vector.
+ */
+void cartesianToSphericalUV(const double &x, const double &y, const double &z,
+							double &u, double &v)
+{
+	// Make X go from 0-1 as we go ALL the way around.  ie: instead of just pure
+	// X being -1 to 1.  We want to change to so -1=1 on right side, 
+	// And if z > 0  then we use x as 0-1 and if <= -1 to 0
+	//
+	double dx ;
+	if (z >= 0)
+		{
+		dx = (x + 1.0) / 2.0 ;	// Convert from -1...1  to 0...1
+		}
+	else
+		{
+		dx = ((x + 1.0) / 2.0) * -1.0 ;	// Convert from 1...-1  to -1...0
+		}
+
+	u = asin( dx ) / PI + 0.5 ;
+	v = asin( y ) / PI + 0.5 ;
+
+}
+
+
+// ---------------------------------------------------------------------------
+
+/*
+ * dist2D() - Computes distance/length of a 2D vector
+ */
+inline double dist2D(const double &x, const double &y)
+{
+	return ( sqrt(x*x + y*y) );
+}
+
+// ---------------------------------------------------------------------------
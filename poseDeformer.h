@@ -1,201 +1,426 @@
-// ---------------------------------------------------------------------------
-// poseDeformer.h - C++ File
-// Copyright 2004 Michael B. Comet
-// ---------------------------------------------------------------------------
-//
-// DESCRIPTION:
-//	The poseDeformer deformer plugin definition header file
-//
-// AUTHOR:
-//	Michel B. Comet - comet@comet-cartoons.com
-//
-// VERSIONS:
-//	09/22/04 - comet - Initial Rev
-//	1.03 - 10/05/04 - mcomet - Fixed so does entire loop of all points even
-//				if not in membership, so that targets work and ed-mem works.
-//				Also removed MProgressWindow since seemed buggy.
-//	1.04 - 10/07/04 - mcomet - Made it so now much faster at generating poses.
-//	1.05 - 10/15/04 - mcomet - Now has new RBF interpolation mode.
-//	1.06 - 10/16/04 - mcomet - Added mirrorData node to help with mirroring.
-//	1.07 - 11/03/04 - mcomet - Now only uses membership points when creating
-//				targets, also put in missing scripts to ZIP file.
-//  1.09c - 12/01/04 - mcomet - Now has option for joint-space vs. pose-space
-//				deformation.  So that the sculpt is either tied to the joint
-//				or the reader as it is brought back up.
-//	1.10 - 01/21/05 - mcomet - Fix for wig out mesh when pose deleted.
-//	1.11 - 08/05/05 - mcomet - Now has user Scale settings.
-//
-// ---------------------------------------------------------------------------
-//
-//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
-//  Copyright 2004 Michael B. Comet
-//
-//   This program is free software; you can redistribute it and/or modify
-//   it under the terms of the GNU General Public License as published by
-//   the Free Software Foundation; either version 2 of the License, or
-//   (at your option) any later version.
-//
-//   This program is distributed in the hope that it will be useful,
-//   but WITHOUT ANY WARRANTY; without even the implied warranty of
-//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-//   GNU General Public License for more details.
-//
-//   You should have received a copy of the GNU General Public License
-//   along with this program; if not, write to the Free Software
-//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
-//
-//   For information on poseDeformer contact:
-//			Michael B. Comet - comet@comet-cartoons.com
-//			or visit http://www.comet-cartooons.com/toons/
-//
-// --------------------------------------------------------------------------
-
-
-/*
- * Includes
- */ 
-#include <maya/MPxDeformerNode.h> 
-#include <maya/MGlobal.h> 
-#include <maya/MTypeId.h> 
-#include <maya/MStatus.h>
-#include <maya/MDataBlock.h>
-#include <maya/MDataHandle.h>
-#include <maya/MPlug.h>
-#include <maya/MPlugArray.h>
-
-#include <maya/MFnNumericAttribute.h>
-#include <maya/MFnMatrixAttribute.h>
-#include <maya/MFnMatrixData.h>
-#include <maya/MFnCompoundAttribute.h>
-#include <maya/MFnEnumAttribute.h>
-#include <maya/MFnGenericAttribute.h>
-#include <maya/MFnTypedAttribute.h>
-
-#include <maya/MFnStringData.h>
-#include <maya/MString.h> 
-
-#include <maya/MPoint.h>
-#include <maya/MPointArray.h>
-#include <maya/MVector.h>
-#include <maya/MVectorArray.h>
-#include <maya/MMatrix.h>
-#include <maya/MTransformationMatrix.h>
-#include <maya/MItGeometry.h>
-
-#include <maya/MDagPath.h>
-#include <maya/MFnDagNode.h>
-#include <maya/MFnDependencyNode.h>
-
-#include <maya/MFnMesh.h>
-#include <maya/MFnNurbsSurface.h>
-
-
-// ---------------------------------------------------------------------------
-
-typedef enum { eBlendAdditive, eBlendNormalize, eBlendRBF } EBLENDMODE ;
-typedef enum { eSpaceJoint, eSpacePose} eSPACEMODE ;
-
-// ---------------------------------------------------------------------------
-
-
-/*
- * poseDeformer - Class Definition
- */
-class poseDeformer : public MPxDeformerNode
-{
-public:
-	poseDeformer();
-	virtual	~poseDeformer();
-
-    static  void*	creator();
-	static  MStatus	initialize();
-
-	// deformation function
-	//
-	virtual MStatus	deform(MDataBlock& block,
-			   MItGeometry& 	iter,
-			   const MMatrix& 	mat,
-			   unsigned int		multiIndex);
-
-public:
-	static  MTypeId		id;
-
-public:
-	// Local functions
-
-public:
-	// local node attributes
-	static MObject		aInputSettings ;		// Cmpd input settings
-	static MObject		aBlendMode ;			// Do normal additive, or try to normalize weights if >1.0?
-	static MObject		aIsolate ;				// Turn on a specific pose weight 100% for editing/viewing.
-	static MObject		aRBFWidth ;				// Width of blending for Radial Basis Function/LU Factorization
-	static MObject		aDeformSpace ;			// Deform relative to joint space or poseReader space?
-	static MObject		aUserScale ;			// Cmpd scale of how much to alter output by
-	static MObject		aUserScaleX ;			// X
-	static MObject		aUserScaleY ;			// Y
-	static MObject		aUserScaleZ ;			// Z
-
-	static MObject		aInputData ;			// Cmpd input data
-	static MObject		aWorldMatrix ;			// Array of world matrix's for each live skin infl object.  Matches skinCluser "matrix" attr.
-	
-	static MObject		aPose ;					// Cmpd array of poses
-	static MObject		aPoseName ;				// String for user defined name for pose
-	static MObject		aPoseWeight ;			// Weight of the pose currently
-	static MObject		aPoseActive ;			// True if this pose is not currently deleted.
-
-	static MObject		aPoseXForm ;			// Cmpd Array of Data of point for each xform that created this pose.
-	static MObject		aPoseXFormStr ;			// Relative str of the given transform for this pose.  Usually 1/#posexforms when the pose was made
-	static MObject		aPoseXFormIdx ;			// Index of which infl the data is stored for.
-	static MObject		aPoseXFormWorldMatrix ; // World Matrix for this poseReader
-	static MObject		aPoseXFormReadAxis ;	// What axis this poseReader is using...
-	static MObject		aPoseXFormNumPts ;		// Num of Delta Pts
-
-	static MObject		aPoseDelta ;			// Cmpd array delta data for the pose one for each pt
-	static MObject		aPoseDeltaX ;			// What was change in X relative to this matrix?
-	static MObject		aPoseDeltaY ;			// What was change in Y relative to this matrix?
-	static MObject		aPoseDeltaZ ;			// What was change in Z relative to this matrix?
-
-private:
-	MStatus readMatrixArray(MDataBlock& data, MString name, MMatrix **matPtr, unsigned &uMat) ;
-	MStatus readPoseWeights(MDataBlock& data, MString name, unsigned &uPoses, MDoubleArray &dArrWts, 
-					int nIsolate, MVectorArray &vArrRead, MVector &vCur,
-					const MMatrix *matArr ) ;
-	MStatus normalizeWeights(MDoubleArray &dArrWts) ;
-	double smoothStep(const double &dVal);
-	double smoothGaussian(const double &dVal) ;
-
-	MStatus interpWeights(MDoubleArray &dArrWts, 
-		const MVectorArray &vArrRead,
-		const MVector &vCur, const double &dRBFWidth) ;
-
-} ;
-
-
-// ---------------------------------------------------------------------------
-
-void cartesianToSpherical(const double &x, const double &y, const double &z, 
-						double &r, double &phi, double &theta) ;
-void sphericalToCartesian(const double &r, const double &phi, const double &theta, 
-						double &x, double &y, double &z) ;
-
-void cartesianToCylindrical(const double &x, const double &y, const double &z, 
-						double &r, double &theta, double &zc) ;
-void cylindricalToCartesian(const double &r, const double &theta, const double &zc, 
-						double &x, double &y, double &z) ;
-
-void cartesianToPolar(const double &x, const double &y,
-						double &r, double &theta) ;
-void polarToCartesian(const double &r, const double &theta,
-						double &x, double &y) ;
-
-double arclength(const double &r, const double &theta) ;
-
-void cartesianToSphericalUV(const double &x, const double &y, const double &z,
-							double &u, double &v) ;
-
-inline double dist2D(const double &x, const double &y) ;
-
-#define PI			3.14159
-#define HALFPI		1.570795
-
-
+// ---------------------------------------------------------------------------
+// poseDeformer.h - C++ File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	The poseDeformer deformer plugin definition header file
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// VERSIONS:
+//	09/22/04 - comet - Initial Rev
+//	1.03 - 10/05/04 - mcomet - Fixed so does entire loop of all points even
+//				if not in membership, so that targets work and ed-mem works.
+//				Also removed MProgressWindow since seemed buggy.
+//	1.04 - 10/07/04 - mcomet - Made it so now much faster at generating poses.
+//	1.05 - 10/15/04 - mcomet - Now has new RBF interpolation mode.
+//	1.06 - 10/16/04 - mcomet - Added mirrorData node to help with mirroring.
+//	1.07 - 11/03/04 - mcomet - Now only uses membership points when creating
+//				targets, also put in missing scripts to ZIP file.
+//  1.09c - 12/01/04 - mcomet - Now has option for joint-space vs. pose-space
+//				deformation.  So that the sculpt is either tied to the joint
+//				or the reader as it is brought back up.
+//	1.10 - 01/21/05 - mcomet - Fix for wig out mesh when pose deleted.
+//	1.11 - 08/05/05 - mcomet - Now has user Scale settings.
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+
+/*
+ * Includes
+ */ 
+#include <maya/MPxDeformerNode.h> 
+#include <maya/MGlobal.h> 
+#include <maya/MTypeId.h> 
+#include <maya/MStatus.h>
+#include <maya/MDataBlock.h>
+#include <maya/MDataHandle.h>
+#include <maya/MPlug.h>
+#include <maya/MPlugArray.h>
+
+#include <maya/MFnNumericAttribute.h>
+#include <maya/MFnMatrixAttribute.h>
+#include <maya/MFnMatrixData.h>
+#include <maya/MFnCompoundAttribute.h>
+#include <maya/MFnEnumAttribute.h>
+#include <maya/MFnGenericAttribute.h>
+#include <maya/MFnTypedAttribute.h>
+
+#include <maya/MFnStringData.h>
+#include <maya/MString.h> 
+
+#include <maya/MPoint.h>
+#include <maya/MPointArray.h>
+#include <maya/MVector.h>
+#include <maya/MVectorArray.h>
+#include <maya/MDoubleArray.h>
+#include <maya/MIntArray.h>
+#include <maya/MMatrix.h>
+#include <maya/MTransformationMatrix.h>
+#include <maya/MQuaternion.h>
+#include <maya/MItGeometry.h>
+
+#include <maya/MDagPath.h>
+#include <maya/MFnDagNode.h>
+#include <maya/MFnDependencyNode.h>
+
+#include <maya/MFnMesh.h>
+#include <maya/MFnNurbsSurface.h>
+
+#include <maya/MThreadPool.h>
+#include <maya/MThreadUtils.h>
+
+#include "poseDeformerCache.h"
+
+
+// ---------------------------------------------------------------------------
+
+typedef enum { eBlendAdditive, eBlendNormalize, eBlendRBF, eBlendRBFSolved } EBLENDMODE ;
+typedef enum { eSpaceJoint, eSpacePose} eSPACEMODE ;
+typedef enum { eScheduleTile, eSchedulePose } ESCHEDULEMODE ;
+typedef enum { eRBFGaussian, eRBFWendland, eRBFSmoothStep, eRBFSmoothGaussian, eRBFLinear } ERBFKERNEL ;
+typedef enum { eFeatureReadAxis, eFeatureOrientation } ERBFFEATURE ;
+typedef enum { eReaderExternal, eReaderInternal } EREADERMODE ;
+
+#define MAXTHREADCHUNKS		64		// Most chunks we'll ever split the geometry into.
+#define RBFSUPPORT			2.5		// Compact kernel support radius, in RBF widths
+#define RBFGAUSSRANGE		6.1		// RBF widths out the Gaussian table goes, e^-37 past that
+#define RBFPARALLELPOSES	256		// Min total poses before the RBF groups are solved in parallel every frame
+
+// ---------------------------------------------------------------------------
+
+class poseDeformer ;
+
+/*
+ * poseDeformerEvalXForm - One xform that actually contributes this evaluation.
+ */
+class poseDeformerEvalXForm
+{
+public:
+	unsigned uXForm ;			// Index into the pose cache xforms
+	double dMap[9] ;			// Row major 3x3: matrix * user scale * (pose wt * xform str)
+	double dWt ;				// pose wt * xform str
+	bool bBaked ;				// True if reading the baked world deltas instead of the raw ones
+	bool bDiag ;				// True if only the diagonal of dMap is used
+} ;
+
+/*
+ * poseDeformerEvalGroup - A run of active xforms that get added on together.  In 
+ *		joint space all the xforms driven by the same influence are summed in 
+ *		that influence's space first, then put thru its matrix once.
+ */
+class poseDeformerEvalGroup
+{
+public:
+	unsigned uFirst ;			// First active xform in the group
+	unsigned uCount ;			// How many
+	bool bFactored ;			// True if members are summed with their wt only, then put thru dMap
+	double dMap[9] ;			// Row major 3x3: influence matrix * user scale, if bFactored
+} ;
+
+/*
+ * poseDeformerEvalData - Everything the point loop needs for one deform() call.
+ *		Filled in once up front, then only read by the threads, except for
+ *		the ptArrPos entries which each thread only writes inside its own chunk.
+ */
+class poseDeformerEvalData
+{
+public:
+	const poseDeformerCache *ptrCache ;	// Flat pose data
+	poseDeformerEvalXForm *ptrActive ;	// Xforms with a non zero weight this time
+	unsigned uActive ;			// How many of them
+	poseDeformerEvalGroup *ptrGroup ;	// Active xforms grouped by influence
+	unsigned uGroups ;			// How many groups
+	MMatrix matWorld ;			// Geom to world
+	MMatrix invmatWorld ;		// World to geom
+	int nKernel ;				// Which SIMD kernel path, already resolved against the cpu
+	int nSchedule ;				// eScheduleTile or eSchedulePose
+
+	double *ptrAccX ;			// Pose major only, world pos accumulator for each pt in iter order
+	double *ptrAccY ;
+	double *ptrAccZ ;
+	unsigned char *ptrTileFlags ;	// Pose major only, at the first pt of each tile: 0=skip 1=todo 2=todo and contiguous
+
+	MPointArray ptArrPos ;		// Pos of each pt in iter order, replaced with deformed result
+	MIntArray nArrPtIdx ;		// Real pt index for each pt in iter order
+	MDoubleArray dArrPct ;		// Deformer weight * envelope for each pt in iter order
+} ;
+
+/*
+ * poseDeformerEvalChunk - One contiguous range of points for a thread.
+ */
+class poseDeformerEvalChunk
+{
+public:
+	poseDeformerEvalData *ptrData ;
+	unsigned uStart ;			// First pt in iter order
+	unsigned uEnd ;				// One past last pt
+} ;
+
+/*
+ * poseDeformerEvalTasks - All of the chunks for one parallel region.
+ */
+class poseDeformerEvalTasks
+{
+public:
+	poseDeformerEvalChunk chunk[MAXTHREADCHUNKS] ;
+	unsigned uChunks ;
+} ;
+
+/*
+ * poseDeformerRBFChunk - The RBF groups one thread solves, every uStep'th from uFirst.
+ */
+class poseDeformerRBFChunk
+{
+public:
+	poseDeformerRBFGroup *ptrGroup ;	// All of the groups
+	unsigned uGroups ;			// How many
+	unsigned uFirst ;			// First group this thread does
+	unsigned uStep ;			// Then every uStep'th one after
+	const poseDeformerRBFSettings *ptrRBF ;
+	int nBlendMode ;			// eBlendRBF or eBlendRBFSolved
+} ;
+
+/*
+ * poseDeformerRBFTasks - All of the RBF chunks for one parallel region.
+ */
+class poseDeformerRBFTasks
+{
+public:
+	poseDeformerRBFChunk chunk[MAXTHREADCHUNKS] ;
+	unsigned uChunks ;
+} ;
+
+/*
+ * poseDeformerScratch - Node owned work space for deform().  Everything only 
+ *		grows when the influence, xform, pose or pt counts do, so once those
+ *		settle a deform() doesn't hit the heap at all.  uAllocs counts every
+ *		time something had to grow, for checking that.
+ */
+class poseDeformerScratch
+{
+public:
+	poseDeformerScratch() ;
+	virtual ~poseDeformerScratch() ;
+
+	MMatrix *ptrMat ;			// Influence world matrices
+	unsigned uMatAlloc ;
+
+	MDoubleArray dArrWts ;		// Pose weights
+	MVectorArray vArrRead ;		// Pose reader vectors for RBF
+	MIntArray nArrActive ;		// Pose active flags
+	MIntArray nArrInfl ;		// Influence each pose is read from, -1 if it has none
+	MVectorArray vArrCur ;		// Where that influence's reader is now, for each pose
+	MIntArray nArrKeyStart ;	// Where each pose's RBF group key starts in nArrKey, uPoses+1 long
+	MIntArray nArrKey ;			// Each pose's influences, increasing, see groupRBFPoses()
+	MIntArray nArrKeyXForm ;	// cachePose xform each nArrKey entry came from, Orientation only
+	double *ptrCone ;			// Internal reader, current axis x's, y's, z's then the weights, uConeAlloc apart
+	unsigned uConeAlloc ;
+
+	poseDeformerEvalData evalData ;	// Point loop data, also owns ptrActive/ptrGroup/ptrAcc*/ptrTileFlags
+	unsigned uXFormAlloc ;		// Room in ptrActive and ptrGroup
+	unsigned uPtAlloc ;			// Room in ptrAcc* and ptrTileFlags
+
+	unsigned uAllocs ;			// How many times anything had to grow
+
+	void free(void) ;
+	bool reserveMatrices(unsigned uNum) ;
+	bool reserveCone(unsigned uNum) ;
+	bool reserveXForms(unsigned uNum) ;
+	bool reservePts(unsigned uNum) ;
+} ;
+
+// ---------------------------------------------------------------------------
+
+
+/*
+ * poseDeformer - Class Definition
+ */
+class poseDeformer : public MPxDeformerNode
+{
+public:
+	poseDeformer();
+	virtual	~poseDeformer();
+
+    static  void*	creator();
+	static  MStatus	initialize();
+
+	// deformation function
+	//
+	virtual MStatus	deform(MDataBlock& block,
+			   MItGeometry& 	iter,
+			   const MMatrix& 	mat,
+			   unsigned int		multiIndex);
+
+	// dirty tracking so we know when the pose cache must be rebuilt
+	//
+	virtual MStatus setDependentsDirty(const MPlug& plugBeingDirtied,
+				   MPlugArray&		affectedPlugs);
+
+public:
+	static  MTypeId		id;
+
+public:
+	// Local functions
+
+public:
+	// local node attributes
+	static MObject		aInputSettings ;		// Cmpd input settings
+	static MObject		aBlendMode ;			// Do normal additive, or try to normalize weights if >1.0?
+	static MObject		aIsolate ;				// Turn on a specific pose weight 100% for editing/viewing.
+	static MObject		aRBFWidth ;				// Width of blending for Radial Basis Function/LU Factorization
+	static MObject		aRBFRegularize ;		// Added down the RBF matrix diagonal so it always factors
+	static MObject		aRBFKernel ;			// Falloff curve, Gaussian, or compact Wendland/SmoothStep/SmoothGaussian/Linear
+	static MObject		aRBFFeature ;			// Compare poses by the first reader axis, or every xform's orientation?
+	static MObject		aRBFFastKernel ;		// Build the RBF matrix with the approximate acos?
+	static MObject		aDeformSpace ;			// Deform relative to joint space or poseReader space?
+	static MObject		aUserScale ;			// Cmpd scale of how much to alter output by
+	static MObject		aUserScaleX ;			// X
+	static MObject		aUserScaleY ;			// Y
+	static MObject		aUserScaleZ ;			// Z
+	static MObject		aNumThreads ;			// How many threads to split the point loop into.  0=Maya default.
+	static MObject		aParallelThreshold ;	// Min num of pts before we bother threading
+	static MObject		aKernelMode ;			// Which SIMD path to run the delta math on.
+	static MObject		aEvalSchedule ;			// Loop over pts then poses, or poses then pts?
+	static MObject		aReaderMode ;			// Pose weights from connected poseReaders, or our own cone readers?
+
+	static MObject		aInputData ;			// Cmpd input data
+	static MObject		aWorldMatrix ;			// Array of world matrix's for each live skin infl object.  Matches skinCluser "matrix" attr.
+	
+	static MObject		aPose ;					// Cmpd array of poses
+	static MObject		aPoseName ;				// String for user defined name for pose
+	static MObject		aPoseWeight ;			// Weight of the pose currently
+	static MObject		aPoseActive ;			// True if this pose is not currently deleted.
+
+	static MObject		aPoseXForm ;			// Cmpd Array of Data of point for each xform that created this pose.
+	static MObject		aPoseXFormStr ;			// Relative str of the given transform for this pose.  Usually 1/#posexforms when the pose was made
+	static MObject		aPoseXFormIdx ;			// Index of which infl the data is stored for.
+	static MObject		aPoseXFormWorldMatrix ; // World Matrix for this poseReader
+	static MObject		aPoseXFormReadAxis ;	// What axis this poseReader is using...
+	static MObject		aPoseXFormConeAngle ;	// Cone angle for the internal reader, in degrees
+	static MObject		aPoseXFormNumPts ;		// Num of Delta Pts
+
+	static MObject		aPoseDelta ;			// Cmpd array delta data for the pose one for each pt
+	static MObject		aPoseDeltaX ;			// What was change in X relative to this matrix?
+	static MObject		aPoseDeltaY ;			// What was change in Y relative to this matrix?
+	static MObject		aPoseDeltaZ ;			// What was change in Z relative to this matrix?
+
+private:
+	poseDeformerCache cachePose ;			// Flat copy of static pose data, rebuilt only when aPose data changes.
+	poseDeformerScratch scratch ;			// Per frame work space, so deform() doesn't alloc.
+	poseDeformerRBFGroup *ptrRBFGroup ;		// Poses split by influence, each with its own factored RBF matrix.
+	unsigned uRBFGroups ;					// How many groups
+	poseDeformerRBFLUT lutRBF ;				// RBF falloff curve, refilled when the kernel or width changes.
+
+private:
+	MStatus readPoseCache(MDataBlock& data) ;
+	MStatus readMatrixArray(MDataBlock& data, unsigned &uMat) ;
+	MStatus readPoseWeights(MDataBlock& data, unsigned &uPoses, MDoubleArray &dArrWts, 
+					MIntArray &nArrActive, int nIsolate, MVectorArray &vArrRead, 
+					MIntArray &nArrInfl, MVectorArray &vArrCur, const MMatrix *matArr, unsigned uMat ) ;
+	MStatus normalizeWeights(MDoubleArray &dArrWts) ;
+	static MVector readAxis(int nReadAxis) ;
+	void coneWeights(MDoubleArray &dArrWts, const MIntArray &nArrActive, const MMatrix *matArr, unsigned uMat, int nKernel) ;
+	static double smoothStep(const double &dVal);
+
+	static unsigned buildEvalXForms(const poseDeformerCache &cache, const MDoubleArray &dArrWts,
+					const MMatrix *matArr, unsigned uMat, int nDeformSpace, const double dScale[3],
+					poseDeformerEvalXForm *ptrActive) ;
+	static unsigned buildEvalGroups(const poseDeformerCache &cache, const MMatrix *matArr, 
+					int nDeformSpace, const double dScale[3],
+					poseDeformerEvalXForm *ptrActive, unsigned uActive, poseDeformerEvalGroup *ptrGroup) ;
+	static bool scanTile(const poseDeformerEvalData *ptrData, unsigned uTile, unsigned uCount, bool &bContiguous) ;
+	static void accumulateXForm(const poseDeformerEvalData *ptrData, unsigned a, 
+					unsigned uTile, unsigned uCount, bool bContiguous,
+					double *dOutX, double *dOutY, double *dOutZ) ;
+	static void accumulateGroup(const poseDeformerEvalData *ptrData, unsigned g, 
+					unsigned uTile, unsigned uCount, bool bContiguous,
+					double *dOutX, double *dOutY, double *dOutZ) ;
+	static void blendPoint(poseDeformerEvalData *ptrData, unsigned uPt, const MPoint &ptWorld, const MPoint &ptDeformed) ;
+	static void deformPoints(poseDeformerEvalData *ptrData, unsigned uStart, unsigned uEnd) ;
+	static void deformPointsTile(poseDeformerEvalData *ptrData, unsigned uStart, unsigned uEnd) ;
+	static void deformPointsPose(poseDeformerEvalData *ptrData, unsigned uStart, unsigned uEnd) ;
+	static void createEvalTasks(void *ptrData, MThreadRootTask *ptrRoot) ;
+	static MThreadRetVal evalTask(void *ptrData) ;
+	static double smoothGaussian(const double &dVal) ;
+
+	static double rbfSigma2(const double &dRBFWidth) ;
+	static double rbfParam(const poseDeformerRBFSettings &rbf) ;
+	static double rbfKernel(int nKernel, double dParam, double dDist) ;
+	static void buildRBFLUT(poseDeformerRBFLUT &lut, const poseDeformerRBFSettings &rbf) ;
+	static double rbfPhi(const poseDeformerRBFSettings &rbf, double dParam, double dDist) ;
+	static void rbfKernelArray(const poseDeformerRBFSettings &rbf, double dParam, double *dVal, unsigned uCount) ;
+	static void rbfDistRow(poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf, int nFrom, unsigned uFirst, double *dDist) ;
+	static void fillRBFMatrix(MatrixNN &matNNA, poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf) ;
+	static bool fillRBFSparse(poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf) ;
+	static void rbfKernelRow(poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf, double *dRow) ;
+	static MStatus updateRBFCache(poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf) ;
+	static MStatus interpWeights(poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf) ;
+	static MStatus solvedWeights(poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf) ;
+	static int compareRBFKey(const MIntArray &nArrA, unsigned uStartA, unsigned uEndA,
+		const MIntArray &nArrB, unsigned uStartB, unsigned uEndB) ;
+	void buildRBFKeys(const MIntArray &nArrInfl, int nFeature) ;
+	bool groupRBFPoses(const MDoubleArray &dArrWts, const MIntArray &nArrActive, 
+		const MVectorArray &vArrRead, const MIntArray &nArrInfl, const MVectorArray &vArrCur,
+		const MMatrix *matArr, unsigned uMat, int nFeature) ;
+	void solveRBFGroups(MDoubleArray &dArrWts, const poseDeformerRBFSettings &rbf, int nBlendMode, int nNumThreads) ;
+	static void solveRBFGroup(poseDeformerRBFGroup &grp, const poseDeformerRBFSettings &rbf, int nBlendMode) ;
+	static void createRBFTasks(void *ptrData, MThreadRootTask *ptrRoot) ;
+	static MThreadRetVal rbfTask(void *ptrData) ;
+
+} ;
+
+
+// ---------------------------------------------------------------------------
+
+void cartesianToSpherical(const double &x, const double &y, const double &z, 
+						double &r, double &phi, double &theta) ;
+void sphericalToCartesian(const double &r, const double &phi, const double &theta, 
+						double &x, double &y, double &z) ;
+
+void cartesianToCylindrical(const double &x, const double &y, const double &z, 
+						double &r, double &theta, double &zc) ;
+void cylindricalToCartesian(const double &r, const double &theta, const double &zc, 
+						double &x, double &y, double &z) ;
+
+void cartesianToPolar(const double &x, const double &y,
+						double &r, double &theta) ;
+void polarToCartesian(const double &r, const double &theta,
+						double &x, double &y) ;
+
+double arclength(const double &r, const double &theta) ;
+
+void cartesianToSphericalUV(const double &x, const double &y, const double &z,
+							double &u, double &v) ;
+
+inline double dist2D(const double &x, const double &y) ;
+
+#define PI			3.14159
+#define HALFPI		1.570795
+
+
@@ -0,0 +1,810 @@
+// ---------------------------------------------------------------------------
+// poseDeformerCache.cpp - C++ File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	Flat, node owned copy of the static pose data on a poseDeformer so that
+//	deform() doesn't have to walk the pose data handles for every point.
+//	Also holds the factored RBF matrix between frames.
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+/*
+ * Includes
+ */
+#include <math.h>
+
+#include "poseDeformerCache.h"
+#include "poseDeformerKernel.h"
+
+#define RBFINDEXMAXRES		64		// Most cells along a cube map face edge
+
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerCache::poseDeformerCache() - constructor
+ */
+poseDeformerCache::poseDeformerCache()
+{
+	ptrXForm = NULL ;
+	uXForms = 0 ;
+	ptrDelta = NULL ;
+	uDeltas = 0 ;
+	ptrIdx = NULL ;
+	uIdx = 0 ;
+	uPts = 0 ;
+	ptrWorld = NULL ;
+	ptrCone = NULL ;
+	bDirty = true ;		// Nothing read yet, so first deform must build it.
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerCache::~poseDeformerCache() - Destructor
+ */
+poseDeformerCache::~poseDeformerCache()
+{
+	free() ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerCache::free() - Frees any alloced memory
+ */
+void poseDeformerCache::free(void)
+{
+	if (ptrXForm != NULL)
+		delete [] ptrXForm ;
+	ptrXForm = NULL ;
+	uXForms = 0 ;
+
+	if (ptrDelta != NULL)
+		delete [] ptrDelta ;
+	ptrDelta = NULL ;
+	uDeltas = 0 ;
+
+	if (ptrIdx != NULL)
+		delete [] ptrIdx ;
+	ptrIdx = NULL ;
+	uIdx = 0 ;
+
+	if (ptrWorld != NULL)
+		delete [] ptrWorld ;
+	ptrWorld = NULL ;
+
+	if (ptrCone != NULL)
+		delete [] ptrCone ;
+	ptrCone = NULL ;
+
+	uPts = 0 ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerCache::alloc() - Allocs room for uNumXForms xforms, uNumDeltas doubles 
+ *		of delta data and uNumIdx sparse pt indices.  All deltas start at zero.
+ *		Returns false on error.
+ */
+bool poseDeformerCache::alloc(unsigned uNumXForms, unsigned uNumPts, unsigned uNumDeltas, unsigned uNumIdx)
+{
+	free() ;		// First free anything
+	if (uNumXForms == 0 || uNumPts == 0)
+		return true ;		// Valid, just nothing to store.
+
+	ptrXForm = new poseDeformerXFormCache [uNumXForms] ;
+	if (ptrXForm == NULL)
+		return false ;
+	uXForms = uNumXForms ;
+	uPts = uNumPts ;
+
+	ptrCone = new double [uNumXForms * 4] ;
+	if (ptrCone == NULL)
+		{
+		free() ;
+		return false ;
+		}
+	unsigned u ;
+	for (u=0; u < uNumXForms * 4; ++u)
+		ptrCone[u] = 0.0 ;
+
+	if (uNumDeltas > 0)
+		{
+		ptrDelta = new double [uNumDeltas] ;
+		if (ptrDelta == NULL)
+			{
+			free() ;
+			return false ;
+			}
+		for (u=0; u < uNumDeltas; ++u)
+			ptrDelta[u] = 0.0 ;
+		uDeltas = uNumDeltas ;
+		}
+
+	if (uNumIdx > 0)
+		{
+		ptrIdx = new unsigned [uNumIdx] ;
+		if (ptrIdx == NULL)
+			{
+			free() ;
+			return false ;
+			}
+		uIdx = uNumIdx ;
+		}
+
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerCache::layout() - Once every xform has bDense and uNumDeltas set, 
+ *		hands out where each one's blocks start.  Returns false if the arrays
+ *		alloced aren't big enough.
+ */
+bool poseDeformerCache::layout(void)
+{
+	unsigned uDeltaPos = 0 ;
+	unsigned uIdxPos = 0 ;
+
+	unsigned x ;
+	for (x=0; x < uXForms; ++x)
+		{
+		poseDeformerXFormCache &xfc = ptrXForm[x] ;
+		xfc.uDeltaStart = uDeltaPos ;
+		xfc.uIdxStart = uIdxPos ;
+		uDeltaPos += xfc.uNumDeltas * 3 ;
+		if (!xfc.bDense)
+			uIdxPos += xfc.uNumDeltas ;
+		}
+
+	return (uDeltaPos <= uDeltas && uIdxPos <= uIdx) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerCache::findIdx() - For a sparse xform, binary searches for the first
+ *		stored slot whose pt index is >= uPtIdx.  Returns uNumDeltas if none.
+ */
+unsigned poseDeformerCache::findIdx(unsigned uXForm, unsigned uPtIdx) const
+{
+	const unsigned *uArrIdx = idx(uXForm) ;
+	unsigned uLo = 0 ;
+	unsigned uHi = ptrXForm[uXForm].uNumDeltas ;
+	while (uLo < uHi)
+		{
+		unsigned uMid = uLo + ((uHi - uLo) / 2) ;
+		if (uArrIdx[uMid] < uPtIdx)
+			uLo = uMid + 1 ;
+		else
+			uHi = uMid ;
+		}
+	return uLo ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerCache::bakeWorld() - Builds ptrWorld, each delta put thru its poseReader 
+ *		matrix and scaled by the xform str, the same as MVector * MMatrix.  Only
+ *		done once per cache rebuild.  Returns false if out of memory.
+ */
+bool poseDeformerCache::bakeWorld(void)
+{
+	if (ptrWorld != NULL || uDeltas == 0)
+		return true ;		// Already done, or nothing to do.
+
+	ptrWorld = new double [uDeltas] ;
+	if (ptrWorld == NULL)
+		return false ;
+
+	unsigned x ;
+	for (x=0; x < uXForms; ++x)
+		{
+		const poseDeformerXFormCache &xfc = ptrXForm[x] ;
+		const MMatrix &mat = xfc.matReader ;
+		const double *dX = deltaX(x) ;
+		const double *dY = deltaY(x) ;
+		const double *dZ = deltaZ(x) ;
+		double *dWX = ptrWorld + xfc.uDeltaStart ;
+		double *dWY = dWX + xfc.uNumDeltas ;
+		double *dWZ = dWY + xfc.uNumDeltas ;
+
+		unsigned d ;
+		for (d=0; d < xfc.uNumDeltas; ++d)
+			{
+			dWX[d] = (dX[d]*mat(0,0) + dY[d]*mat(1,0) + dZ[d]*mat(2,0)) * xfc.dStr ;
+			dWY[d] = (dX[d]*mat(0,1) + dY[d]*mat(1,1) + dZ[d]*mat(2,1)) * xfc.dStr ;
+			dWZ[d] = (dX[d]*mat(0,2) + dY[d]*mat(1,2) + dZ[d]*mat(2,2)) * xfc.dStr ;
+			}
+		}
+
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFLUT::poseDeformerRBFLUT() - constructor
+ */
+poseDeformerRBFLUT::poseDeformerRBFLUT()
+{
+	ptrTable = NULL ;
+	dScale = 0.0 ;
+	nKernel = -1 ;
+	dWidth = 0.0 ;
+	bValid = false ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFLUT::~poseDeformerRBFLUT() - Destructor
+ */
+poseDeformerRBFLUT::~poseDeformerRBFLUT()
+{
+	free() ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFLUT::free() - Frees any alloced memory
+ */
+void poseDeformerRBFLUT::free(void)
+{
+	if (ptrTable != NULL)
+		delete [] ptrTable ;
+	ptrTable = NULL ;
+	bValid = false ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFLUT::alloc() - The table is always the same size, so it is only
+ *		alloced the first time.  Returns false if out of memory.
+ */
+bool poseDeformerRBFLUT::alloc(void)
+{
+	bValid = false ;
+	if (ptrTable == NULL)
+		ptrTable = new double [RBFLUTSIZE + 2] ;
+	return (ptrTable != NULL) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFLUT::isCurrent() - True if filled for this kernel and width.
+ */
+bool poseDeformerRBFLUT::isCurrent(int nKernelNow, double dWidthNow) const
+{
+	return bValid && nKernel == nKernelNow && dWidth == dWidthNow ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFLUT::lookup() - phi for one distance, the same interpolation
+ *		poseKernelLookup() does for whole rows, so a matrix entry built one
+ *		at a time matches the row built all at once.
+ */
+double poseDeformerRBFLUT::lookup(double dDist) const
+{
+	poseKernelLookup(eKernelScalar, ptrTable, RBFLUTSIZE, dScale, &dDist, 1) ;
+	return dDist ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFIndex::poseDeformerRBFIndex() - constructor
+ */
+poseDeformerRBFIndex::poseDeformerRBFIndex()
+{
+	uRes = 0 ;
+	ptrCellStart = NULL ;
+	ptrCellPose = NULL ;
+	uPoses = 0 ;
+	dRadius = 0.0 ;
+	ptrHits = NULL ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFIndex::~poseDeformerRBFIndex() - Destructor
+ */
+poseDeformerRBFIndex::~poseDeformerRBFIndex()
+{
+	free() ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFIndex::free() - Frees any alloced memory
+ */
+void poseDeformerRBFIndex::free(void)
+{
+	if (ptrCellStart != NULL)
+		delete [] ptrCellStart ;
+	ptrCellStart = NULL ;
+	if (ptrCellPose != NULL)
+		delete [] ptrCellPose ;
+	ptrCellPose = NULL ;
+	if (ptrHits != NULL)
+		delete [] ptrHits ;
+	ptrHits = NULL ;
+	uRes = 0 ;
+	uPoses = 0 ;
+	dRadius = 0.0 ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFIndex::cellOf() - Face is 2*axis, +1 if the biggest component is
+ *		negative, then the other two components over the biggest give where on 
+ *		that face.
+ */
+unsigned poseDeformerRBFIndex::cellOf(const MVector &vDir, unsigned uRes)
+{
+	double dAbs[3] = { fabs(vDir.x), fabs(vDir.y), fabs(vDir.z) } ;
+	unsigned uAxis = 0 ;
+	if (dAbs[1] > dAbs[uAxis])
+		uAxis = 1 ;
+	if (dAbs[2] > dAbs[uAxis])
+		uAxis = 2 ;
+	double dMajor = dAbs[uAxis] ;
+	if (dMajor == 0.0)
+		return 0 ;
+
+	unsigned uFace = uAxis * 2 + ((vDir[uAxis] < 0.0) ? 1 : 0) ;
+	double dU = vDir[ (uAxis == 0) ? 1 : 0 ] / dMajor ;
+	double dV = vDir[ (uAxis == 2) ? 1 : 2 ] / dMajor ;
+
+	int nU = (int)floor( (dU + 1.0) * 0.5 * uRes ) ;
+	int nV = (int)floor( (dV + 1.0) * 0.5 * uRes ) ;
+	if (nU < 0) nU = 0 ;
+	if (nU >= (int)uRes) nU = uRes - 1 ;
+	if (nV < 0) nV = 0 ;
+	if (nV >= (int)uRes) nV = uRes - 1 ;
+
+	return (uFace * uRes + nU) * uRes + nV ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFIndex::build() - Buckets every reader direction.  The cells are
+ *		made about half of dRadiusNow across, so a query only looks at a 
+ *		handful, but no more than there are poses to put in them.  Returns 
+ *		false if out of memory.
+ */
+bool poseDeformerRBFIndex::build(const MVectorArray &vArrRead, double dRadiusNow)
+{
+	free() ;
+	unsigned uNum = vArrRead.length() ;
+	if (uNum == 0 || dRadiusNow <= 0.0)
+		return true ;
+
+	double dRes = ceil( 3.14159 / dRadiusNow ) ;		// Each face is 90 degrees across
+	double dMaxRes = floor( sqrt( uNum / 3.0 ) ) + 1.0 ;
+	if (dRes > dMaxRes)
+		dRes = dMaxRes ;
+	if (dRes > RBFINDEXMAXRES)
+		dRes = RBFINDEXMAXRES ;
+	if (dRes < 1.0)
+		dRes = 1.0 ;
+	unsigned uResNow = (unsigned)dRes ;
+	unsigned uCells = 6 * uResNow * uResNow ;
+
+	ptrCellStart = new unsigned [uCells + 1] ;
+	ptrCellPose = new unsigned [uNum] ;
+	ptrHits = new unsigned [uNum] ;
+	if (ptrCellStart == NULL || ptrCellPose == NULL || ptrHits == NULL)
+		{
+		free() ;
+		return false ;
+		}
+
+	// Counting sort by cell, ptrHits holds each pose's cell for now.
+	unsigned c, p ;
+	for (c=0; c <= uCells; ++c)
+		ptrCellStart[c] = 0 ;
+	for (p=0; p < uNum; ++p)
+		{
+		ptrHits[p] = cellOf(vArrRead[p], uResNow) ;
+		++ptrCellStart[ ptrHits[p] + 1 ] ;
+		}
+	for (c=0; c < uCells; ++c)
+		ptrCellStart[c+1] += ptrCellStart[c] ;
+	for (p=0; p < uNum; ++p)
+		ptrCellPose[ ptrCellStart[ ptrHits[p] ]++ ] = p ;
+	for (c=uCells; c > 0; --c)		// The fill moved each start up to the next, put them back.
+		ptrCellStart[c] = ptrCellStart[c-1] ;
+	ptrCellStart[0] = 0 ;
+
+	uRes = uResNow ;
+	uPoses = uNum ;
+	dRadius = dRadiusNow ;
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFIndex::query() - Every pose that may be within dRadius of vDir, in
+ *		cell order, goes into ptrHits.  Returns how many.
+ *
+ *		A unit p within dRadius of q is within dRadius of q's angle to each
+ *		axis, so each component has an exact [lo, hi] range over the cap.  On
+ *		a face the biggest component is at least 1/sqrt(3), and the face 
+ *		coordinates are the other two over it, which bounds which cells can
+ *		be touched.
+ */
+unsigned poseDeformerRBFIndex::query(const MVector &vDir)
+{
+	unsigned uHits = 0 ;
+	unsigned p ;
+	double dLen = vDir.length() ;
+	if (uRes == 0 || dLen == 0.0)
+		{
+		for (p=0; p < uPoses; ++p)
+			ptrHits[uHits++] = p ;
+		return uHits ;
+		}
+
+	const double dPad = 1e-9 ;		// Don't let round off drop a pose right on the edge.
+	double dLo[3], dHi[3] ;
+	unsigned k ;
+	for (k=0; k < 3; ++k)
+		{
+		double dQ = vDir[k] / dLen ;
+		if (dQ > 1.0) dQ = 1.0 ;
+		if (dQ < -1.0) dQ = -1.0 ;
+		double dAng = acos(dQ) ;
+		double dAngLo = dAng - dRadius - dPad ;
+		double dAngHi = dAng + dRadius + dPad ;
+		dHi[k] = (dAngLo <= 0.0) ? 1.0 : cos(dAngLo) ;
+		dLo[k] = (dAngHi >= 3.14159265358979) ? -1.0 : cos(dAngHi) ;
+		}
+
+	unsigned uFace ;
+	for (uFace=0; uFace < 6; ++uFace)
+		{
+		unsigned uAxis = uFace / 2 ;
+		unsigned uAxisU = (uAxis == 0) ? 1 : 0 ;
+		unsigned uAxisV = (uAxis == 2) ? 1 : 2 ;
+
+		// Range of the biggest component on this face
+		double dMajorLo = dLo[uAxis] ;
+		double dMajorHi = dHi[uAxis] ;
+		if (uFace & 1)
+			{
+			dMajorLo = -dHi[uAxis] ;
+			dMajorHi = -dLo[uAxis] ;
+			}
+		if (dMajorLo < 0.57)		// A bit under 1/sqrt(3)
+			dMajorLo = 0.57 ;
+		if (dMajorHi < dMajorLo)
+			continue ;
+
+		int nCell[2][2] ;		// [u or v][first, last]
+		unsigned uSide ;
+		for (uSide=0; uSide < 2; ++uSide)
+			{
+			unsigned uOther = (uSide == 0) ? uAxisU : uAxisV ;
+			double dMin = dLo[uOther] / dMajorLo ;
+			if (dLo[uOther] / dMajorHi < dMin)
+				dMin = dLo[uOther] / dMajorHi ;
+			double dMax = dHi[uOther] / dMajorLo ;
+			if (dHi[uOther] / dMajorHi > dMax)
+				dMax = dHi[uOther] / dMajorHi ;
+
+			int nFirst = (int)floor( (dMin - dPad + 1.0) * 0.5 * uRes ) ;
+			int nLast = (int)floor( (dMax + dPad + 1.0) * 0.5 * uRes ) ;
+			if (nFirst < 0) nFirst = 0 ;
+			if (nLast >= (int)uRes) nLast = uRes - 1 ;
+			nCell[uSide][0] = nFirst ;
+			nCell[uSide][1] = nLast ;
+			}
+
+		int nU, nV ;
+		for (nU=nCell[0][0]; nU <= nCell[0][1]; ++nU)
+			{
+			for (nV=nCell[1][0]; nV <= nCell[1][1]; ++nV)
+				{
+				unsigned c = (uFace * uRes + nU) * uRes + nV ;
+				for (p=ptrCellStart[c]; p < ptrCellStart[c+1]; ++p)
+					ptrHits[uHits++] = ptrCellPose[p] ;
+				}
+			}
+		}
+
+	return uHits ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFCache::poseDeformerRBFCache() - constructor
+ */
+poseDeformerRBFCache::poseDeformerRBFCache()
+{
+	ptrWork = NULL ;
+	uWork = 0 ;
+	bSparse = false ;
+	bValid = false ;
+	bCoef = false ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFCache::~poseDeformerRBFCache() - Destructor
+ */
+poseDeformerRBFCache::~poseDeformerRBFCache()
+{
+	free() ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFCache::free() - Frees any alloced memory
+ */
+void poseDeformerRBFCache::free(void)
+{
+	facA.free() ;
+	matCoef.free() ;
+	matSky.free() ;
+	indexRead.free() ;
+	if (ptrWork != NULL)
+		delete [] ptrWork ;
+	ptrWork = NULL ;
+	uWork = 0 ;
+	bSparse = false ;
+	vArrRead.clear() ;
+	dArrFeat.clear() ;
+	bValid = false ;
+	bCoef = false ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFCache::alloc() - Makes room for a uPoses x uPoses system.  Only
+ *		reallocs if the size changed.  If bSparseNow the caller has already set 
+ *		up matSky and indexRead, so only the work space is made and the dense 
+ *		storage is freed.  Returns false if out of memory.
+ */
+bool poseDeformerRBFCache::alloc(unsigned uPoses, bool bSparseNow)
+{
+	bValid = false ;
+	bCoef = false ;
+	bSparse = bSparseNow ;
+
+	if (uWork != uPoses)
+		{
+		if (ptrWork != NULL)
+			delete [] ptrWork ;
+		uWork = 0 ;
+		ptrWork = new double [uPoses] ;
+		if (ptrWork == NULL)
+			{
+			free() ;
+			return false ;
+			}
+		uWork = uPoses ;
+		}
+
+	if (bSparse)
+		{
+		facA.free() ;
+		matCoef.free() ;
+		return true ;
+		}
+
+	matSky.free() ;
+	indexRead.free() ;
+	if (!facA.alloc(uPoses))
+		{
+		free() ;
+		return false ;
+		}
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFCache::isCurrent() - True if the cached factorization was built from
+ *		exactly these reader vectors, pose features and settings.
+ */
+bool poseDeformerRBFCache::isCurrent(const MVectorArray &vArrReadNow, const double *dFeatNow, unsigned uFeatNow, const poseDeformerRBFSettings &rbfNow) const
+{
+	if (!bValid || !(rbfKey == rbfNow))
+		return false ;
+
+	if (dArrFeat.length() != uFeatNow)
+		return false ;
+	unsigned u ;
+	for (u=0; u < uFeatNow; ++u)
+		{
+		if (dArrFeat[u] != dFeatNow[u])
+			return false ;
+		}
+
+	unsigned uPoses = vArrReadNow.length() ;
+	if (vArrRead.length() != uPoses)
+		return false ;
+
+	for (u=0; u < uPoses; ++u)
+		{
+		const MVector &vA = vArrRead[u] ;
+		const MVector &vB = vArrReadNow[u] ;
+		if (vA.x != vB.x || vA.y != vB.y || vA.z != vB.z)
+			return false ;
+		}
+
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFCache::setKey() - Remember what the cache was just built from.
+ */
+void poseDeformerRBFCache::setKey(const MVectorArray &vArrReadNow, const double *dFeatNow, unsigned uFeatNow, const poseDeformerRBFSettings &rbfNow)
+{
+	vArrRead = vArrReadNow ;
+	if (dArrFeat.length() != uFeatNow)
+		dArrFeat.setLength(uFeatNow) ;
+	unsigned u ;
+	for (u=0; u < uFeatNow; ++u)
+		dArrFeat[u] = dFeatNow[u] ;
+	rbfKey = rbfNow ;
+	bValid = true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFCache::buildCoef() - Solves A C = I with the cached factorization, 
+ *		so row i of matCoef holds pose i's RBF coefficients.  Only done once per 
+ *		factorization.  Returns false if there is no good factorization or we're 
+ *		out of memory.
+ */
+bool poseDeformerRBFCache::buildCoef(void)
+{
+	if (bCoef)
+		return true ;
+	if (!bValid || bSparse || !facA.bFactored)
+		return false ;
+
+	unsigned uPoses = facA.getDimension() ;
+	if (matCoef.getDimension() != uPoses)
+		{
+		if (matCoef.setDimension(uPoses) != uPoses)
+			return false ;
+		}
+
+	matCoef.identity() ;					// Row i is the unit vector for pose i...
+	if (!facA.solve(matCoef, matCoef))		// ...solved in place.
+		return false ;
+
+	bCoef = true ;
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFGroup::poseDeformerRBFGroup() - constructor
+ */
+poseDeformerRBFGroup::poseDeformerRBFGroup()
+{
+	uSlots = 0 ;
+	ptrFeat = NULL ;
+	ptrCur = NULL ;
+	ptrQuery = NULL ;
+	ptrUnit = NULL ;
+	ptrCurUnit = NULL ;
+	uFeatAlloc = 0 ;
+	bWarn = false ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFGroup::~poseDeformerRBFGroup() - Destructor
+ */
+poseDeformerRBFGroup::~poseDeformerRBFGroup()
+{
+	free() ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFGroup::free() - Frees the feature memory
+ */
+void poseDeformerRBFGroup::free(void)
+{
+	if (ptrFeat != NULL)
+		delete [] ptrFeat ;
+	ptrFeat = NULL ;
+	ptrCur = NULL ;
+	ptrQuery = NULL ;
+	ptrUnit = NULL ;
+	ptrCurUnit = NULL ;
+	uFeatAlloc = 0 ;
+	uSlots = 0 ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseDeformerRBFGroup::allocFeat() - Makes room for uMembers features of uSlotsNow
+ *		quaternions each, plus ptrCur and ptrQuery after them, then the unit
+ *		reader vectors.  Only reallocs when it has to grow.  uSlotsNow of 0 is 
+ *		the ReadAxis feature, which only needs the unit vectors.  Returns false 
+ *		if out of memory.
+ */
+bool poseDeformerRBFGroup::allocFeat(unsigned uSlotsNow, unsigned uMembers)
+{
+	uSlots = uSlotsNow ;
+
+	unsigned uNeed = 4 * uSlots * (uMembers + 2) + 3 * (uMembers + 1) ;
+	if (uNeed > uFeatAlloc)
+		{
+		free() ;
+		ptrFeat = new double [uNeed] ;
+		if (ptrFeat == NULL)
+			return false ;
+		uFeatAlloc = uNeed ;
+		uSlots = uSlotsNow ;
+		}
+
+	ptrCur = ptrFeat + 4 * uSlots * uMembers ;
+	ptrQuery = ptrCur + 4 * uSlots ;
+	ptrUnit = ptrQuery + 4 * uSlots ;
+	ptrCurUnit = ptrUnit + 3 * uMembers ;
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
@@ -0,0 +1,322 @@
+// ---------------------------------------------------------------------------
+// poseDeformerCache.h - C++ Header File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	Flat, node owned copy of the static pose data on a poseDeformer so that
+//	deform() doesn't have to walk the pose data handles for every point.
+//	Also holds the factored RBF matrix between frames.
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+#ifndef __POSEDEFORMERCACHE_H
+#define __POSEDEFORMERCACHE_H
+
+/*
+ * Includes
+ */
+#include <maya/MMatrix.h>
+#include <maya/MVectorArray.h>
+#include <maya/MDoubleArray.h>
+#include <maya/MIntArray.h>
+
+#include "MatrixNN.h"
+
+// ---------------------------------------------------------------------------
+
+
+/*
+ * poseDeformerXFormCache - Static data for one pose/xform element.
+ */
+class poseDeformerXFormCache
+{
+public:
+	poseDeformerXFormCache() { uPoseIdx=0; dStr=0.0; nMatIdx=-1; nReadAxis=1; dQuat[0]=dQuat[1]=dQuat[2]=0.0; dQuat[3]=1.0; bDense=true; uNumDeltas=0; uDeltaStart=0; uIdxStart=0; } ;
+
+	unsigned uPoseIdx ;		// Which pose this xform is part of
+	double dStr ;			// Relative str of the xform in the pose
+	int nMatIdx ;			// Index of which infl the data is stored for
+	MMatrix matReader ;		// World Matrix for the poseReader
+	int nReadAxis ;			// What axis the poseReader is using
+	double dQuat[4] ;		// matReader's rotation as x y z w, for the Orientation RBF feature
+
+	bool bDense ;			// True if stored for every pt, false if only the pts that moved
+	unsigned uNumDeltas ;	// How many deltas are stored, uPts if dense.
+	unsigned uDeltaStart ;	// Where the X block starts in ptrDelta, Y and Z follow.
+	unsigned uIdxStart ;	// Where the pt indices start in ptrIdx if sparse.
+} ;
+
+// ---------------------------------------------------------------------------
+
+
+/*
+ * poseDeformerCache - Class Definition
+ *
+ *	Every xform gets three blocks of deltas, all the X's, then all the Y's
+ *	then all the Z's (SoA), so the kernels can load several pts at once.
+ *
+ *	Most sculpts only move a small area, so an xform whose non zero deltas
+ *	cover less than half the pts is stored sparse: only the pts that moved,
+ *	in increasing pt index order, with a matching list of pt indices in
+ *	ptrIdx.  Otherwise it is stored dense with a delta for all uPts, zero
+ *	where nothing moved.
+ *
+ *	The poseReader matrix and xform str never animate, so for pose-space 
+ *	deformation the world space deltas are baked once into ptrWorld and
+ *	only thrown away when the pose data changes.
+ *
+ *	The same goes for the reader axis and cone angle of each xform, kept
+ *	SoA in ptrCone so the internal reader weights all of them in one pass.
+ */
+class poseDeformerCache
+{
+public:
+	poseDeformerCache();
+	virtual	~poseDeformerCache();
+
+public:
+	poseDeformerXFormCache *ptrXForm ;	// Array of xforms that actually contribute
+	unsigned uXForms ;			// How many xforms are in the array?
+	double *ptrDelta ;			// Delta data for all xforms
+	unsigned uDeltas ;			// How many doubles are in ptrDelta
+	unsigned *ptrIdx ;			// Pt indices for the sparse xforms
+	unsigned uIdx ;				// How many are in ptrIdx
+	unsigned uPts ;				// One past the highest pt index any xform stored
+	bool bDirty ;				// True if the pose data changed and we must rebuild
+	double *ptrWorld ;			// Deltas * matReader * dStr, same layout as ptrDelta.  NULL until needed.
+	double *ptrCone ;			// Unit reader axis x's, y's, z's then 1/cone angle, uXForms apart, for the internal reader
+
+	void free(void) ;			// Free any alloced memory
+	bool alloc(unsigned uNumXForms, unsigned uNumPts, unsigned uNumDeltas, unsigned uNumIdx) ;	// Alloc and zero the arrays
+	bool layout(void) ;			// Hand out delta/idx offsets once every xform knows its bDense/uNumDeltas
+	inline double* deltaX(unsigned uXForm) { return ptrDelta + ptrXForm[uXForm].uDeltaStart ; } ;
+	inline double* deltaY(unsigned uXForm) { return deltaX(uXForm) + ptrXForm[uXForm].uNumDeltas ; } ;
+	inline double* deltaZ(unsigned uXForm) { return deltaY(uXForm) + ptrXForm[uXForm].uNumDeltas ; } ;
+	inline unsigned* idx(unsigned uXForm) { return ptrIdx + ptrXForm[uXForm].uIdxStart ; } ;
+	inline const double* deltaX(unsigned uXForm) const { return ptrDelta + ptrXForm[uXForm].uDeltaStart ; } ;
+	inline const double* deltaY(unsigned uXForm) const { return deltaX(uXForm) + ptrXForm[uXForm].uNumDeltas ; } ;
+	inline const double* deltaZ(unsigned uXForm) const { return deltaY(uXForm) + ptrXForm[uXForm].uNumDeltas ; } ;
+	inline const unsigned* idx(unsigned uXForm) const { return ptrIdx + ptrXForm[uXForm].uIdxStart ; } ;
+	unsigned findIdx(unsigned uXForm, unsigned uPtIdx) const ;	// First sparse slot with index >= uPtIdx
+	bool bakeWorld(void) ;		// Fill in ptrWorld if not done yet
+	inline const double* worldX(unsigned uXForm) const { return ptrWorld + ptrXForm[uXForm].uDeltaStart ; } ;
+	inline const double* worldY(unsigned uXForm) const { return worldX(uXForm) + ptrXForm[uXForm].uNumDeltas ; } ;
+	inline const double* worldZ(unsigned uXForm) const { return worldY(uXForm) + ptrXForm[uXForm].uNumDeltas ; } ;
+	inline const double* coneInv(void) const { return ptrCone + uXForms * 3 ; } ;
+} ;
+
+
+// ---------------------------------------------------------------------------
+
+
+#define RBFLUTSIZE			4096	// Intervals in the RBF falloff table
+
+/*
+ * poseDeformerRBFLUT - Class Definition
+ *
+ *	The RBF falloff curve phi sampled at RBFLUTSIZE+1 evenly spaced 
+ *	normalized distances from 0 out to where it has died off, plus one 
+ *	more copy of the last sample so the interpolation never reads past the
+ *	end.  Anything further than the table reads the last sample.  It only
+ *	depends on the kernel and width, so it's filled once when those change,
+ *	see poseDeformer::buildRBFLUT().
+ */
+class poseDeformerRBFLUT
+{
+public:
+	poseDeformerRBFLUT();
+	virtual	~poseDeformerRBFLUT();
+
+public:
+	double *ptrTable ;			// RBFLUTSIZE+2 samples of phi
+	double dScale ;				// Samples per unit of distance
+	int nKernel ;				// Kernel it was filled for
+	double dWidth ;				// Width it was filled for
+	bool bValid ;				// True once filled
+
+	void free(void) ;			// Free any alloced memory
+	bool alloc(void) ;			// Alloc the table if not already, marks it not valid
+	bool isCurrent(int nKernelNow, double dWidthNow) const ;	// Filled for exactly these?
+	double lookup(double dDist) const ;		// phi(dDist), interpolated
+} ;
+
+// ---------------------------------------------------------------------------
+
+
+/*
+ * poseDeformerRBFSettings - The user settings the RBF matrix is built from.
+ *		ptrLUT is only how phi gets evaluated, it's filled from the settings,
+ *		so it's not part of the compare.
+ */
+class poseDeformerRBFSettings
+{
+public:
+	poseDeformerRBFSettings() { dWidth=0.0; dLambda=0.0; nKernel=0; nFeature=0; bFast=false; ptrLUT=NULL; } ;
+
+	double dWidth ;			// Blend width, 0-1
+	double dLambda ;		// Regularization added down the diagonal
+	int nKernel ;			// ERBFKERNEL falloff curve
+	int nFeature ;			// eFeatureReadAxis or eFeatureOrientation
+	bool bFast ;			// Use the approximate acos for the dense matrix and row
+	const poseDeformerRBFLUT *ptrLUT ;	// Table phi is read from, NULL to evaluate it exactly
+
+	bool operator==(const poseDeformerRBFSettings &rbf) const
+		{ return dWidth == rbf.dWidth && dLambda == rbf.dLambda && nKernel == rbf.nKernel && nFeature == rbf.nFeature && bFast == rbf.bFast ; } ;
+} ;
+
+// ---------------------------------------------------------------------------
+
+
+/*
+ * poseDeformerRBFIndex - Class Definition
+ *
+ *	Buckets the pose reader directions on a cube map, each face of the
+ *	unit cube cut into uRes x uRes cells, so the poses near a direction can
+ *	be found without looking at all of them.  query() works out the range
+ *	of each face the cap of dRadius around the direction can touch, from
+ *	the range each x, y, z can take inside the cap, so it may hand back a
+ *	few poses a bit outside dRadius but never misses one inside.
+ */
+class poseDeformerRBFIndex
+{
+public:
+	poseDeformerRBFIndex();
+	virtual	~poseDeformerRBFIndex();
+
+public:
+	unsigned uRes ;				// Cells along each face edge, 0 if not built
+	unsigned *ptrCellStart ;	// Where each cell's poses start in ptrCellPose, 6*uRes*uRes+1 long
+	unsigned *ptrCellPose ;		// Pose indices grouped by cell
+	unsigned uPoses ;			// How many poses were bucketed
+	double dRadius ;			// Angle in radians query() looks out to
+	unsigned *ptrHits ;			// What query() found, uPoses long
+
+	void free(void) ;			// Free any alloced memory
+	bool build(const MVectorArray &vArrRead, double dRadiusNow) ;	// Bucket these, for queries out to dRadiusNow
+	unsigned query(const MVector &vDir) ;		// Poses that may be within dRadius of vDir go in ptrHits, returns how many
+	static unsigned cellOf(const MVector &vDir, unsigned uRes) ;	// Which cell a direction lands in
+} ;
+
+// ---------------------------------------------------------------------------
+
+
+/*
+ * poseDeformerRBFCache - Class Definition
+ *
+ *	The RBF blend mode's kernel matrix only depends on the stored poseReader
+ *	vectors, or pose features, and the RBF settings, so it is built and factored 
+ *	once and kept here along with what it was built from.  The Gaussian 
+ *	kernel matrix is symmetric positive definite, so LDL^T is tried first, 
+ *	with LU as the fallback if that fails.
+ *
+ *	The Wendland kernel is zero past its support, so for big pose sets it 
+ *	is kept sparse in matSky instead and facA and matCoef are left empty.
+ *	indexRead then finds the poses within the support for each frame,
+ *	for the ReadAxis feature only.
+ */
+class poseDeformerRBFCache
+{
+public:
+	poseDeformerRBFCache();
+	virtual	~poseDeformerRBFCache();
+
+public:
+	MatrixNNFactor facA ;		// Factored A, check facA.bFactored
+	MatrixSkyline matSky ;		// Factored A when bSparse
+	bool bSparse ;				// True if A is in matSky rather than facA
+	poseDeformerRBFIndex indexRead ;	// Reader directions bucketed by the support, only when bSparse
+	MVectorArray vArrRead ;		// Reader vectors it was built from
+	MDoubleArray dArrFeat ;		// Packed pose features it was built from, empty for ReadAxis
+	poseDeformerRBFSettings rbfKey ;	// Settings it was built with
+	bool bValid ;				// True once built
+	MatrixNN matCoef ;			// RBF-Solved coefficients, row i is pose i's, ie: A^-1
+	bool bCoef ;				// True once matCoef is solved for the current factorization
+	double *ptrWork ;			// Work space, uPoses long
+	unsigned uWork ;			// How long ptrWork is
+
+	void free(void) ;			// Free any alloced memory
+	bool alloc(unsigned uPoses, bool bSparseNow) ;	// Size for uPoses, marks it not valid.  Leaves matSky and indexRead alone if bSparseNow.
+	bool factored(void) const { return bSparse ? matSky.bFactored : facA.bFactored ; } ;
+	bool isCurrent(const MVectorArray &vArrReadNow, const double *dFeatNow, unsigned uFeatNow, const poseDeformerRBFSettings &rbfNow) const ;	// Built from exactly these?
+	void setKey(const MVectorArray &vArrReadNow, const double *dFeatNow, unsigned uFeatNow, const poseDeformerRBFSettings &rbfNow) ;		// Remember what it was built from
+	bool buildCoef(void) ;		// Solve matCoef from facA if not done yet
+} ;
+
+// ---------------------------------------------------------------------------
+
+
+/*
+ * poseDeformerRBFGroup - Class Definition
+ *
+ *	All the poses read off the same influences.  Each group is its own RBF
+ *	problem with its own current reader vector and factored matrix, so one
+ *	node can drive several body parts without their poses blending into
+ *	each other.  Groups only touch their own data, so they can be solved
+ *	on different threads.
+ *
+ *	For the Orientation feature each member's feature is one quaternion per
+ *	influence in nArrInfl, packed SoA in ptrFeat: slot k's x's for every
+ *	member, then its y's, z's and w's, then slot k+1.  That way the distance
+ *	kernel streams down whole rows of members at once.  The reader vectors
+ *	are also kept unit length the same way in ptrUnit, for the fast ReadAxis
+ *	kernel.
+ */
+class poseDeformerRBFGroup
+{
+public:
+	poseDeformerRBFGroup();
+	virtual	~poseDeformerRBFGroup();
+
+public:
+	MIntArray nArrInfl ;		// Influences the group's poses are read from, increasing.  Just one for ReadAxis.
+	MVector vCur ;				// The last member's reader axis on the influence, where it is now
+	MIntArray nArrPose ;		// Pose index of each member, increasing
+	MVectorArray vArrRead ;		// Member reader vectors
+	MDoubleArray dArrWts ;		// Member weights, replaced by the RBF weights
+	MIntArray nArrActive ;		// Member active flags
+	unsigned uSlots ;			// Quaternions in each feature, 0 for ReadAxis
+	double *ptrFeat ;			// Member features, 4*uSlots rows of nArrPose.length()
+	double *ptrCur ;			// Feature of where the influences are now, 4*uSlots long
+	double *ptrQuery ;			// Work space for one member's feature, 4*uSlots long
+	double *ptrUnit ;			// Member reader vectors made unit length, 3 rows of nArrPose.length()
+	double *ptrCurUnit ;		// vCur made unit length, 3 long
+	unsigned uFeatAlloc ;		// How many doubles are alloced at ptrFeat
+	poseDeformerRBFCache cacheRBF ;	// Factored RBF matrix for just these
+	bool bWarn ;				// Set if the last rebuild couldn't factor, for the main thread to report
+
+	void free(void) ;			// Free the feature memory
+	bool allocFeat(unsigned uSlotsNow, unsigned uMembers) ;		// Room for the features and unit vectors, only grows
+	unsigned featLength(void) const { return 4 * uSlots * nArrPose.length() ; } ;
+} ;
+
+
+// ---------------------------------------------------------------------------
+
+#endif // end of __POSEDEFORMERCACHE_H
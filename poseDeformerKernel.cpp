@@ -0,0 +1,1683 @@
+// ---------------------------------------------------------------------------
+// poseDeformerKernel.cpp - C++ File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	The low level math loops of the poseDeformer, written over plain SoA
+//	double arrays so they can run on SSE/AVX when the cpu has it.  Nothing
+//	in here knows about Maya.
+//
+//	Every path does the exact same multiplies and adds in the same order as
+//	the scalar one, and we never let the compiler fuse them into FMAs, so
+//	each lane gives the bit for bit same answer as the scalar reference.
+//	That way it doesn't matter which pts land in a vector body or in a
+//	scalar tail, or how the deformer split them up between threads.
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+/*
+ * No FMA contraction, see above.
+ */
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+/*
+ * Includes
+ */
+#include <math.h>
+
+#include "poseDeformerKernel.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define KERNEL_X86	1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define KERNEL_X86	0
+#endif
+
+	// gcc/clang need to be told a function may use newer instructions, msvc doesn't.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define KERNEL_TARGET(ISA)
+#else
+#define KERNEL_TARGET(ISA)	__attribute__((target(ISA)))
+#endif
+
+
+// ---------------------------------------------------------------------------
+//	Cpu Detection
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelDetect() - Finds the best kernel path this cpu and OS can run.
+ *		Only checked once, after that the answer is remembered.
+ */
+int poseKernelDetect(void)
+{
+	static int nDetected = -1 ;
+	if (nDetected >= 0)
+		return nDetected ;
+
+	int nBest = eKernelScalar ;
+
+#if KERNEL_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+	int nInfo[4] ;
+	__cpuid(nInfo, 0) ;
+	int nMaxLeaf = nInfo[0] ;
+
+	__cpuid(nInfo, 1) ;
+	bool bSSE41 = (nInfo[2] & (1 << 19)) != 0 ;
+	bool bOSXSave = (nInfo[2] & (1 << 27)) != 0 ;
+	bool bAVX = (nInfo[2] & (1 << 28)) != 0 ;
+
+	bool bAVX2 = false ;
+	bool bAVX512 = false ;
+	if (nMaxLeaf >= 7)
+		{
+		__cpuidex(nInfo, 7, 0) ;
+		bAVX2 = (nInfo[1] & (1 << 5)) != 0 ;
+		bAVX512 = (nInfo[1] & (1 << 16)) != 0 ;
+		}
+
+	// Make sure the OS actually saves the ymm/zmm registers for us.
+	unsigned long long uXCR0 = 0 ;
+	if (bOSXSave)
+		uXCR0 = _xgetbv(0) ;
+	bool bOSAVX = (uXCR0 & 0x6) == 0x6 ;
+	bool bOSAVX512 = (uXCR0 & 0xe6) == 0xe6 ;
+
+	if (bSSE41)
+		nBest = eKernelSSE4 ;
+	if (bAVX && bAVX2 && bOSAVX)
+		nBest = eKernelAVX2 ;
+	if (bAVX512 && bOSAVX512)
+		nBest = eKernelAVX512 ;
+#else
+	__builtin_cpu_init() ;
+	if (__builtin_cpu_supports("sse4.1"))
+		nBest = eKernelSSE4 ;
+	if (__builtin_cpu_supports("avx2"))
+		nBest = eKernelAVX2 ;
+	if (__builtin_cpu_supports("avx512f"))
+		nBest = eKernelAVX512 ;
+#endif
+#endif
+
+	nDetected = nBest ;
+	return nDetected ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelResolve() - Auto picks the best one.  Asking for more than the cpu
+ *		has drops down to the best one it does have.
+ */
+int poseKernelResolve(int nKernel)
+{
+	int nBest = poseKernelDetect() ;
+	if (nKernel <= eKernelAuto || nKernel > nBest)
+		return nBest ;
+	return nKernel ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelName() - Name of kernel for printing.
+ */
+const char* poseKernelName(int nKernel)
+{
+	switch (nKernel)
+		{
+		case eKernelScalar:		return "scalar" ;
+		case eKernelSSE4:		return "SSE4" ;
+		case eKernelAVX2:		return "AVX2" ;
+		case eKernelAVX512:		return "AVX-512" ;
+		}
+	return "auto" ;
+}
+
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+//	Delta Accumulation
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+
+/*
+ * accumulateScalar() - Reference version.  The vector versions below must match
+ *		this exactly, operation for operation.
+ */
+static void accumulateScalar(const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		double *dOutX, double *dOutY, double *dOutZ, unsigned uStart, unsigned uCount)
+{
+	unsigned i ;
+	for (i=uStart; i < uCount; ++i)
+		{
+		dOutX[i] = dOutX[i] + (dX[i]*dMap[0] + dY[i]*dMap[3] + dZ[i]*dMap[6]) ;	// out += delta * map
+		dOutY[i] = dOutY[i] + (dX[i]*dMap[1] + dY[i]*dMap[4] + dZ[i]*dMap[7]) ;
+		dOutZ[i] = dOutZ[i] + (dX[i]*dMap[2] + dY[i]*dMap[5] + dZ[i]*dMap[8]) ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * accumulateDiagScalar() - Reference version when the map is only a diagonal, ie:
+ *		the deltas are already in world space and just need scale * wt.
+ */
+static void accumulateDiagScalar(const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		double *dOutX, double *dOutY, double *dOutZ, unsigned uStart, unsigned uCount)
+{
+	unsigned i ;
+	for (i=uStart; i < uCount; ++i)
+		{
+		dOutX[i] = dOutX[i] + dX[i]*dMap[0] ;		// out += delta * diag
+		dOutY[i] = dOutY[i] + dY[i]*dMap[4] ;
+		dOutZ[i] = dOutZ[i] + dZ[i]*dMap[8] ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+#if KERNEL_X86
+
+/*
+ * accumulateSSE4() - 2 pts at a time.
+ */
+KERNEL_TARGET("sse4.1")
+static void accumulateSSE4(const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		double *dOutX, double *dOutY, double *dOutZ, unsigned uCount)
+{
+	__m128d m00 = _mm_set1_pd(dMap[0]), m01 = _mm_set1_pd(dMap[1]), m02 = _mm_set1_pd(dMap[2]) ;
+	__m128d m10 = _mm_set1_pd(dMap[3]), m11 = _mm_set1_pd(dMap[4]), m12 = _mm_set1_pd(dMap[5]) ;
+	__m128d m20 = _mm_set1_pd(dMap[6]), m21 = _mm_set1_pd(dMap[7]), m22 = _mm_set1_pd(dMap[8]) ;
+
+	unsigned i = 0 ;
+	for ( ; i + 2 <= uCount; i += 2)
+		{
+		__m128d x = _mm_loadu_pd(dX + i) ;
+		__m128d y = _mm_loadu_pd(dY + i) ;
+		__m128d z = _mm_loadu_pd(dZ + i) ;
+
+		__m128d vx = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, m00), _mm_mul_pd(y, m10)), _mm_mul_pd(z, m20)) ;
+		__m128d vy = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, m01), _mm_mul_pd(y, m11)), _mm_mul_pd(z, m21)) ;
+		__m128d vz = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, m02), _mm_mul_pd(y, m12)), _mm_mul_pd(z, m22)) ;
+
+		_mm_storeu_pd(dOutX + i, _mm_add_pd(_mm_loadu_pd(dOutX + i), vx)) ;
+		_mm_storeu_pd(dOutY + i, _mm_add_pd(_mm_loadu_pd(dOutY + i), vy)) ;
+		_mm_storeu_pd(dOutZ + i, _mm_add_pd(_mm_loadu_pd(dOutZ + i), vz)) ;
+		}
+
+	accumulateScalar(dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, i, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * accumulateAVX2() - 4 pts at a time.
+ */
+KERNEL_TARGET("avx2")
+static void accumulateAVX2(const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		double *dOutX, double *dOutY, double *dOutZ, unsigned uCount)
+{
+	__m256d m00 = _mm256_set1_pd(dMap[0]), m01 = _mm256_set1_pd(dMap[1]), m02 = _mm256_set1_pd(dMap[2]) ;
+	__m256d m10 = _mm256_set1_pd(dMap[3]), m11 = _mm256_set1_pd(dMap[4]), m12 = _mm256_set1_pd(dMap[5]) ;
+	__m256d m20 = _mm256_set1_pd(dMap[6]), m21 = _mm256_set1_pd(dMap[7]), m22 = _mm256_set1_pd(dMap[8]) ;
+
+	unsigned i = 0 ;
+	for ( ; i + 4 <= uCount; i += 4)
+		{
+		__m256d x = _mm256_loadu_pd(dX + i) ;
+		__m256d y = _mm256_loadu_pd(dY + i) ;
+		__m256d z = _mm256_loadu_pd(dZ + i) ;
+
+		__m256d vx = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, m00), _mm256_mul_pd(y, m10)), _mm256_mul_pd(z, m20)) ;
+		__m256d vy = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, m01), _mm256_mul_pd(y, m11)), _mm256_mul_pd(z, m21)) ;
+		__m256d vz = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, m02), _mm256_mul_pd(y, m12)), _mm256_mul_pd(z, m22)) ;
+
+		_mm256_storeu_pd(dOutX + i, _mm256_add_pd(_mm256_loadu_pd(dOutX + i), vx)) ;
+		_mm256_storeu_pd(dOutY + i, _mm256_add_pd(_mm256_loadu_pd(dOutY + i), vy)) ;
+		_mm256_storeu_pd(dOutZ + i, _mm256_add_pd(_mm256_loadu_pd(dOutZ + i), vz)) ;
+		}
+
+	accumulateScalar(dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, i, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * accumulateAVX512() - 8 pts at a time.
+ */
+KERNEL_TARGET("avx512f")
+static void accumulateAVX512(const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		double *dOutX, double *dOutY, double *dOutZ, unsigned uCount)
+{
+	__m512d m00 = _mm512_set1_pd(dMap[0]), m01 = _mm512_set1_pd(dMap[1]), m02 = _mm512_set1_pd(dMap[2]) ;
+	__m512d m10 = _mm512_set1_pd(dMap[3]), m11 = _mm512_set1_pd(dMap[4]), m12 = _mm512_set1_pd(dMap[5]) ;
+	__m512d m20 = _mm512_set1_pd(dMap[6]), m21 = _mm512_set1_pd(dMap[7]), m22 = _mm512_set1_pd(dMap[8]) ;
+
+	unsigned i = 0 ;
+	for ( ; i + 8 <= uCount; i += 8)
+		{
+		__m512d x = _mm512_loadu_pd(dX + i) ;
+		__m512d y = _mm512_loadu_pd(dY + i) ;
+		__m512d z = _mm512_loadu_pd(dZ + i) ;
+
+		__m512d vx = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(x, m00), _mm512_mul_pd(y, m10)), _mm512_mul_pd(z, m20)) ;
+		__m512d vy = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(x, m01), _mm512_mul_pd(y, m11)), _mm512_mul_pd(z, m21)) ;
+		__m512d vz = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(x, m02), _mm512_mul_pd(y, m12)), _mm512_mul_pd(z, m22)) ;
+
+		_mm512_storeu_pd(dOutX + i, _mm512_add_pd(_mm512_loadu_pd(dOutX + i), vx)) ;
+		_mm512_storeu_pd(dOutY + i, _mm512_add_pd(_mm512_loadu_pd(dOutY + i), vy)) ;
+		_mm512_storeu_pd(dOutZ + i, _mm512_add_pd(_mm512_loadu_pd(dOutZ + i), vz)) ;
+		}
+
+	accumulateScalar(dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, i, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * accumulateDiagSSE4() - 2 pts at a time.
+ */
+KERNEL_TARGET("sse4.1")
+static void accumulateDiagSSE4(const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		double *dOutX, double *dOutY, double *dOutZ, unsigned uCount)
+{
+	__m128d m00 = _mm_set1_pd(dMap[0]), m11 = _mm_set1_pd(dMap[4]), m22 = _mm_set1_pd(dMap[8]) ;
+
+	unsigned i = 0 ;
+	for ( ; i + 2 <= uCount; i += 2)
+		{
+		_mm_storeu_pd(dOutX + i, _mm_add_pd(_mm_loadu_pd(dOutX + i), _mm_mul_pd(_mm_loadu_pd(dX + i), m00))) ;
+		_mm_storeu_pd(dOutY + i, _mm_add_pd(_mm_loadu_pd(dOutY + i), _mm_mul_pd(_mm_loadu_pd(dY + i), m11))) ;
+		_mm_storeu_pd(dOutZ + i, _mm_add_pd(_mm_loadu_pd(dOutZ + i), _mm_mul_pd(_mm_loadu_pd(dZ + i), m22))) ;
+		}
+
+	accumulateDiagScalar(dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, i, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * accumulateDiagAVX2() - 4 pts at a time.
+ */
+KERNEL_TARGET("avx2")
+static void accumulateDiagAVX2(const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		double *dOutX, double *dOutY, double *dOutZ, unsigned uCount)
+{
+	__m256d m00 = _mm256_set1_pd(dMap[0]), m11 = _mm256_set1_pd(dMap[4]), m22 = _mm256_set1_pd(dMap[8]) ;
+
+	unsigned i = 0 ;
+	for ( ; i + 4 <= uCount; i += 4)
+		{
+		_mm256_storeu_pd(dOutX + i, _mm256_add_pd(_mm256_loadu_pd(dOutX + i), _mm256_mul_pd(_mm256_loadu_pd(dX + i), m00))) ;
+		_mm256_storeu_pd(dOutY + i, _mm256_add_pd(_mm256_loadu_pd(dOutY + i), _mm256_mul_pd(_mm256_loadu_pd(dY + i), m11))) ;
+		_mm256_storeu_pd(dOutZ + i, _mm256_add_pd(_mm256_loadu_pd(dOutZ + i), _mm256_mul_pd(_mm256_loadu_pd(dZ + i), m22))) ;
+		}
+
+	accumulateDiagScalar(dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, i, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * accumulateDiagAVX512() - 8 pts at a time.
+ */
+KERNEL_TARGET("avx512f")
+static void accumulateDiagAVX512(const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		double *dOutX, double *dOutY, double *dOutZ, unsigned uCount)
+{
+	__m512d m00 = _mm512_set1_pd(dMap[0]), m11 = _mm512_set1_pd(dMap[4]), m22 = _mm512_set1_pd(dMap[8]) ;
+
+	unsigned i = 0 ;
+	for ( ; i + 8 <= uCount; i += 8)
+		{
+		_mm512_storeu_pd(dOutX + i, _mm512_add_pd(_mm512_loadu_pd(dOutX + i), _mm512_mul_pd(_mm512_loadu_pd(dX + i), m00))) ;
+		_mm512_storeu_pd(dOutY + i, _mm512_add_pd(_mm512_loadu_pd(dOutY + i), _mm512_mul_pd(_mm512_loadu_pd(dY + i), m11))) ;
+		_mm512_storeu_pd(dOutZ + i, _mm512_add_pd(_mm512_loadu_pd(dOutZ + i), _mm512_mul_pd(_mm512_loadu_pd(dZ + i), m22))) ;
+		}
+
+	accumulateDiagScalar(dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, i, uCount) ;		// Leftovers
+}
+
+#endif // KERNEL_X86
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelAccumulate() - Adds on the delta of one pose xform, run thru its
+ *		combined map, to uCount pts.  nKernel should already be resolved.
+ */
+void poseKernelAccumulate(int nKernel, const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		double *dOutX, double *dOutY, double *dOutZ, unsigned uCount)
+{
+#if KERNEL_X86
+	switch (nKernel)
+		{
+		case eKernelAVX512:
+			accumulateAVX512(dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, uCount) ;
+			return ;
+		case eKernelAVX2:
+			accumulateAVX2(dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, uCount) ;
+			return ;
+		case eKernelSSE4:
+			accumulateSSE4(dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, uCount) ;
+			return ;
+		}
+#endif
+	accumulateScalar(dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, 0, uCount) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelAccumulateDiag() - Same as above, but only the diagonal of dMap is used, 
+ *		for deltas that were already baked into world space.
+ */
+void poseKernelAccumulateDiag(int nKernel, const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		double *dOutX, double *dOutY, double *dOutZ, unsigned uCount)
+{
+#if KERNEL_X86
+	switch (nKernel)
+		{
+		case eKernelAVX512:
+			accumulateDiagAVX512(dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, uCount) ;
+			return ;
+		case eKernelAVX2:
+			accumulateDiagAVX2(dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, uCount) ;
+			return ;
+		case eKernelSSE4:
+			accumulateDiagSSE4(dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, uCount) ;
+			return ;
+		}
+#endif
+	accumulateDiagScalar(dMap, dX, dY, dZ, dOutX, dOutY, dOutZ, 0, uCount) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelScatter() - Sparse version of the above.  For hit i, adds delta slot 
+ *		uDelta[i] run thru the map on to out slot uSlot[i].  Same math in the same
+ *		order as accumulateScalar(), so a pt comes out the same stored either way.
+ */
+void poseKernelScatter(const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		const unsigned *uDelta, const unsigned *uSlot, unsigned uHits,
+		double *dOutX, double *dOutY, double *dOutZ)
+{
+	unsigned i ;
+	for (i=0; i < uHits; ++i)
+		{
+		unsigned d = uDelta[i] ;
+		unsigned o = uSlot[i] ;
+		dOutX[o] = dOutX[o] + (dX[d]*dMap[0] + dY[d]*dMap[3] + dZ[d]*dMap[6]) ;	// out += delta * map
+		dOutY[o] = dOutY[o] + (dX[d]*dMap[1] + dY[d]*dMap[4] + dZ[d]*dMap[7]) ;
+		dOutZ[o] = dOutZ[o] + (dX[d]*dMap[2] + dY[d]*dMap[5] + dZ[d]*dMap[8]) ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelScatterDiag() - Sparse version of poseKernelAccumulateDiag().
+ */
+void poseKernelScatterDiag(const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		const unsigned *uDelta, const unsigned *uSlot, unsigned uHits,
+		double *dOutX, double *dOutY, double *dOutZ)
+{
+	unsigned i ;
+	for (i=0; i < uHits; ++i)
+		{
+		unsigned d = uDelta[i] ;
+		unsigned o = uSlot[i] ;
+		dOutX[o] = dOutX[o] + dX[d]*dMap[0] ;		// out += delta * diag
+		dOutY[o] = dOutY[o] + dY[d]*dMap[4] ;
+		dOutZ[o] = dOutZ[o] + dZ[d]*dMap[8] ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+//	Matrix Row Update
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+
+/*
+ * rowUpdateScalar() - Reference version of dst -= l * src.
+ */
+static void rowUpdateScalar(double dL, const double *dSrc, double *dDst, unsigned uStart, unsigned uCount)
+{
+	unsigned j ;
+	for (j=uStart; j < uCount; ++j)
+		dDst[j] = dDst[j] - dL * dSrc[j] ;
+}
+
+// ---------------------------------------------------------------------------
+
+#if KERNEL_X86
+
+/*
+ * rowUpdateSSE4() - 2 cols at a time.
+ */
+KERNEL_TARGET("sse4.1")
+static void rowUpdateSSE4(double dL, const double *dSrc, double *dDst, unsigned uCount)
+{
+	__m128d l = _mm_set1_pd(dL) ;
+
+	unsigned j = 0 ;
+	for ( ; j + 2 <= uCount; j += 2)
+		_mm_storeu_pd(dDst + j, _mm_sub_pd(_mm_loadu_pd(dDst + j), _mm_mul_pd(l, _mm_loadu_pd(dSrc + j)))) ;
+
+	rowUpdateScalar(dL, dSrc, dDst, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * rowUpdateAVX2() - 4 cols at a time.
+ */
+KERNEL_TARGET("avx2")
+static void rowUpdateAVX2(double dL, const double *dSrc, double *dDst, unsigned uCount)
+{
+	__m256d l = _mm256_set1_pd(dL) ;
+
+	unsigned j = 0 ;
+	for ( ; j + 4 <= uCount; j += 4)
+		_mm256_storeu_pd(dDst + j, _mm256_sub_pd(_mm256_loadu_pd(dDst + j), _mm256_mul_pd(l, _mm256_loadu_pd(dSrc + j)))) ;
+
+	rowUpdateScalar(dL, dSrc, dDst, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * rowUpdateAVX512() - 8 cols at a time.
+ */
+KERNEL_TARGET("avx512f")
+static void rowUpdateAVX512(double dL, const double *dSrc, double *dDst, unsigned uCount)
+{
+	__m512d l = _mm512_set1_pd(dL) ;
+
+	unsigned j = 0 ;
+	for ( ; j + 8 <= uCount; j += 8)
+		_mm512_storeu_pd(dDst + j, _mm512_sub_pd(_mm512_loadu_pd(dDst + j), _mm512_mul_pd(l, _mm512_loadu_pd(dSrc + j)))) ;
+
+	rowUpdateScalar(dL, dSrc, dDst, j, uCount) ;		// Leftovers
+}
+
+#endif // KERNEL_X86
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelRowUpdate() - dDst[j] -= dL * dSrc[j] for uCount cols.  This is the
+ *		inner loop of the LU trailing matrix update in MatrixNN.  Every path does
+ *		the same multiply then subtract, so they all give the same answer.
+ */
+void poseKernelRowUpdate(int nKernel, double dL, const double *dSrc, double *dDst, unsigned uCount)
+{
+#if KERNEL_X86
+	switch (nKernel)
+		{
+		case eKernelAVX512:
+			rowUpdateAVX512(dL, dSrc, dDst, uCount) ;
+			return ;
+		case eKernelAVX2:
+			rowUpdateAVX2(dL, dSrc, dDst, uCount) ;
+			return ;
+		case eKernelSSE4:
+			rowUpdateSSE4(dL, dSrc, dDst, uCount) ;
+			return ;
+		}
+#endif
+	rowUpdateScalar(dL, dSrc, dDst, 0, uCount) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * rowsUpdateScalar() - Reference version of dst -= l[r] * src row r, for 
+ *		r = 0..uRows-1 in order.
+ */
+static void rowsUpdateScalar(const double *dL, unsigned uRows, const double *dSrc, unsigned uStride, double *dDst, unsigned uStart, unsigned uCount)
+{
+	unsigned j, r ;
+	for (j=uStart; j < uCount; ++j)
+		{
+		double d = dDst[j] ;
+		for (r=0; r < uRows; ++r)
+			d = d - dL[r] * dSrc[r*uStride + j] ;
+		dDst[j] = d ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+#if KERNEL_X86
+
+/*
+ * rowsUpdateSSE4() - 8 cols at a time, then 2.
+ */
+KERNEL_TARGET("sse4.1")
+static void rowsUpdateSSE4(const double *dL, unsigned uRows, const double *dSrc, unsigned uStride, double *dDst, unsigned uCount)
+{
+	unsigned j = 0 ;
+	unsigned r ;
+	for ( ; j + 8 <= uCount; j += 8)		// 4 at once so the subtracts don't wait on each other
+		{
+		__m128d d0 = _mm_loadu_pd(dDst + j) ;
+		__m128d d1 = _mm_loadu_pd(dDst + j + 2) ;
+		__m128d d2 = _mm_loadu_pd(dDst + j + 4) ;
+		__m128d d3 = _mm_loadu_pd(dDst + j + 6) ;
+		for (r=0; r < uRows; ++r)
+			{
+			__m128d l = _mm_set1_pd(dL[r]) ;
+			const double *ptrSrc = dSrc + r*uStride + j ;
+			d0 = _mm_sub_pd(d0, _mm_mul_pd(l, _mm_loadu_pd(ptrSrc))) ;
+			d1 = _mm_sub_pd(d1, _mm_mul_pd(l, _mm_loadu_pd(ptrSrc + 2))) ;
+			d2 = _mm_sub_pd(d2, _mm_mul_pd(l, _mm_loadu_pd(ptrSrc + 4))) ;
+			d3 = _mm_sub_pd(d3, _mm_mul_pd(l, _mm_loadu_pd(ptrSrc + 6))) ;
+			}
+		_mm_storeu_pd(dDst + j, d0) ;
+		_mm_storeu_pd(dDst + j + 2, d1) ;
+		_mm_storeu_pd(dDst + j + 4, d2) ;
+		_mm_storeu_pd(dDst + j + 6, d3) ;
+		}
+	for ( ; j + 2 <= uCount; j += 2)
+		{
+		__m128d d = _mm_loadu_pd(dDst + j) ;
+		for (r=0; r < uRows; ++r)
+			d = _mm_sub_pd(d, _mm_mul_pd(_mm_set1_pd(dL[r]), _mm_loadu_pd(dSrc + r*uStride + j))) ;
+		_mm_storeu_pd(dDst + j, d) ;
+		}
+
+	rowsUpdateScalar(dL, uRows, dSrc, uStride, dDst, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * rowsUpdateAVX2() - 16 cols at a time, then 4.
+ */
+KERNEL_TARGET("avx2")
+static void rowsUpdateAVX2(const double *dL, unsigned uRows, const double *dSrc, unsigned uStride, double *dDst, unsigned uCount)
+{
+	unsigned j = 0 ;
+	unsigned r ;
+	for ( ; j + 16 <= uCount; j += 16)		// 4 at once so the subtracts don't wait on each other
+		{
+		__m256d d0 = _mm256_loadu_pd(dDst + j) ;
+		__m256d d1 = _mm256_loadu_pd(dDst + j + 4) ;
+		__m256d d2 = _mm256_loadu_pd(dDst + j + 8) ;
+		__m256d d3 = _mm256_loadu_pd(dDst + j + 12) ;
+		for (r=0; r < uRows; ++r)
+			{
+			__m256d l = _mm256_set1_pd(dL[r]) ;
+			const double *ptrSrc = dSrc + r*uStride + j ;
+			d0 = _mm256_sub_pd(d0, _mm256_mul_pd(l, _mm256_loadu_pd(ptrSrc))) ;
+			d1 = _mm256_sub_pd(d1, _mm256_mul_pd(l, _mm256_loadu_pd(ptrSrc + 4))) ;
+			d2 = _mm256_sub_pd(d2, _mm256_mul_pd(l, _mm256_loadu_pd(ptrSrc + 8))) ;
+			d3 = _mm256_sub_pd(d3, _mm256_mul_pd(l, _mm256_loadu_pd(ptrSrc + 12))) ;
+			}
+		_mm256_storeu_pd(dDst + j, d0) ;
+		_mm256_storeu_pd(dDst + j + 4, d1) ;
+		_mm256_storeu_pd(dDst + j + 8, d2) ;
+		_mm256_storeu_pd(dDst + j + 12, d3) ;
+		}
+	for ( ; j + 4 <= uCount; j += 4)
+		{
+		__m256d d = _mm256_loadu_pd(dDst + j) ;
+		for (r=0; r < uRows; ++r)
+			d = _mm256_sub_pd(d, _mm256_mul_pd(_mm256_set1_pd(dL[r]), _mm256_loadu_pd(dSrc + r*uStride + j))) ;
+		_mm256_storeu_pd(dDst + j, d) ;
+		}
+
+	rowsUpdateScalar(dL, uRows, dSrc, uStride, dDst, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * rowsUpdateAVX512() - 32 cols at a time, then 8.
+ */
+KERNEL_TARGET("avx512f")
+static void rowsUpdateAVX512(const double *dL, unsigned uRows, const double *dSrc, unsigned uStride, double *dDst, unsigned uCount)
+{
+	unsigned j = 0 ;
+	unsigned r ;
+	for ( ; j + 32 <= uCount; j += 32)		// 4 at once so the subtracts don't wait on each other
+		{
+		__m512d d0 = _mm512_loadu_pd(dDst + j) ;
+		__m512d d1 = _mm512_loadu_pd(dDst + j + 8) ;
+		__m512d d2 = _mm512_loadu_pd(dDst + j + 16) ;
+		__m512d d3 = _mm512_loadu_pd(dDst + j + 24) ;
+		for (r=0; r < uRows; ++r)
+			{
+			__m512d l = _mm512_set1_pd(dL[r]) ;
+			const double *ptrSrc = dSrc + r*uStride + j ;
+			d0 = _mm512_sub_pd(d0, _mm512_mul_pd(l, _mm512_loadu_pd(ptrSrc))) ;
+			d1 = _mm512_sub_pd(d1, _mm512_mul_pd(l, _mm512_loadu_pd(ptrSrc + 8))) ;
+			d2 = _mm512_sub_pd(d2, _mm512_mul_pd(l, _mm512_loadu_pd(ptrSrc + 16))) ;
+			d3 = _mm512_sub_pd(d3, _mm512_mul_pd(l, _mm512_loadu_pd(ptrSrc + 24))) ;
+			}
+		_mm512_storeu_pd(dDst + j, d0) ;
+		_mm512_storeu_pd(dDst + j + 8, d1) ;
+		_mm512_storeu_pd(dDst + j + 16, d2) ;
+		_mm512_storeu_pd(dDst + j + 24, d3) ;
+		}
+	for ( ; j + 8 <= uCount; j += 8)
+		{
+		__m512d d = _mm512_loadu_pd(dDst + j) ;
+		for (r=0; r < uRows; ++r)
+			d = _mm512_sub_pd(d, _mm512_mul_pd(_mm512_set1_pd(dL[r]), _mm512_loadu_pd(dSrc + r*uStride + j))) ;
+		_mm512_storeu_pd(dDst + j, d) ;
+		}
+
+	rowsUpdateScalar(dL, uRows, dSrc, uStride, dDst, j, uCount) ;		// Leftovers
+}
+
+
+#endif // KERNEL_X86
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelRowsUpdate() - Same as doing poseKernelRowUpdate() for uRows src rows
+ *		in a row, uStride apart, but each chunk of dDst is only loaded and stored
+ *		once.  Same math in the same order, so the same answer.
+ */
+void poseKernelRowsUpdate(int nKernel, const double *dL, unsigned uRows, const double *dSrc, unsigned uStride, double *dDst, unsigned uCount)
+{
+#if KERNEL_X86
+	switch (nKernel)
+		{
+		case eKernelAVX512:
+			rowsUpdateAVX512(dL, uRows, dSrc, uStride, dDst, uCount) ;
+			return ;
+		case eKernelAVX2:
+			rowsUpdateAVX2(dL, uRows, dSrc, uStride, dDst, uCount) ;
+			return ;
+		case eKernelSSE4:
+			rowsUpdateSSE4(dL, uRows, dSrc, uStride, dDst, uCount) ;
+			return ;
+		}
+#endif
+	rowsUpdateScalar(dL, uRows, dSrc, uStride, dDst, 0, uCount) ;
+}
+
+// ---------------------------------------------------------------------------
+//	Fast Math
+// ---------------------------------------------------------------------------
+//
+//	Approximate acos for the RBF kernel matrix, built only out of adds,
+//	multiplies, sqrt and bit twiddling so every path still matches the
+//	scalar one bit for bit.
+//
+//	acos(x) is Abramowitz & Stegun 4.4.46, sqrt(1-|x|) times a degree 7
+//	polynomial in |x|, mirrored as pi - acos(|x|) for x < 0.  Abs error is
+//	under 3e-8 radians over all of [-1, 1], and it is exactly 0 at x = 1.
+//
+// ---------------------------------------------------------------------------
+
+static const double dFastPi = 3.14159265358979323846 ;
+static const double dAcosPoly[8] = { 1.5707963050, -0.2145988016, 0.0889789874, -0.0501743046,
+									0.0308918810, -0.0170881256, 0.0066700901, -0.0012624911 } ;
+
+// ---------------------------------------------------------------------------
+
+/*
+ * dirDotScalar() - Reference version of dir . unit vector j.  dUnit holds the
+ *		x's, then uStride later the y's, then the z's.
+ */
+static void dirDotScalar(const double dDir[3], const double *dUnit, unsigned uStride, double *dDot, unsigned uStart, unsigned uCount)
+{
+	const double *dX = dUnit ;
+	const double *dY = dX + uStride ;
+	const double *dZ = dY + uStride ;
+
+	unsigned j ;
+	for (j=uStart; j < uCount; ++j)
+		dDot[j] = dDir[0] * dX[j] + dDir[1] * dY[j] + dDir[2] * dZ[j] ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * fastAcosScalar() - Reference version of dVal = acos(dVal) * dScale, see above.
+ */
+static void fastAcosScalar(double dScale, double *dVal, unsigned uStart, unsigned uCount)
+{
+	unsigned j ;
+	int c ;
+	for (j=uStart; j < uCount; ++j)
+		{
+		double x = dVal[j] ;
+		x = (x > -1.0) ? x : -1.0 ;
+		x = (x < 1.0) ? x : 1.0 ;
+		double ax = fabs(x) ;
+		double p = dAcosPoly[7] ;
+		for (c=6; c >= 0; --c)
+			p = p * ax + dAcosPoly[c] ;
+		double r = sqrt(1.0 - ax) * p ;
+		if (x < 0.0)
+			r = dFastPi - r ;
+		dVal[j] = r * dScale ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+#if KERNEL_X86
+
+/*
+ * dirDotSSE4() - 2 poses at a time.
+ */
+KERNEL_TARGET("sse4.1")
+static void dirDotSSE4(const double dDir[3], const double *dUnit, unsigned uStride, double *dDot, unsigned uCount)
+{
+	const double *dX = dUnit ;
+	const double *dY = dX + uStride ;
+	const double *dZ = dY + uStride ;
+
+	__m128d ax = _mm_set1_pd(dDir[0]) ;
+	__m128d ay = _mm_set1_pd(dDir[1]) ;
+	__m128d az = _mm_set1_pd(dDir[2]) ;
+
+	unsigned j = 0 ;
+	for ( ; j + 2 <= uCount; j += 2)
+		{
+		__m128d d = _mm_mul_pd(ax, _mm_loadu_pd(dX + j)) ;
+		d = _mm_add_pd(d, _mm_mul_pd(ay, _mm_loadu_pd(dY + j))) ;
+		d = _mm_add_pd(d, _mm_mul_pd(az, _mm_loadu_pd(dZ + j))) ;
+		_mm_storeu_pd(dDot + j, d) ;
+		}
+
+	dirDotScalar(dDir, dUnit, uStride, dDot, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * fastAcosSSE4() - 2 at a time.
+ */
+KERNEL_TARGET("sse4.1")
+static void fastAcosSSE4(double dScale, double *dVal, unsigned uCount)
+{
+	__m128d one = _mm_set1_pd(1.0) ;
+	__m128d negOne = _mm_set1_pd(-1.0) ;
+	__m128d zero = _mm_setzero_pd() ;
+	__m128d sign = _mm_set1_pd(-0.0) ;
+	__m128d pi = _mm_set1_pd(dFastPi) ;
+	__m128d scale = _mm_set1_pd(dScale) ;
+
+	unsigned j = 0 ;
+	int c ;
+	for ( ; j + 2 <= uCount; j += 2)
+		{
+		__m128d x = _mm_min_pd(_mm_max_pd(_mm_loadu_pd(dVal + j), negOne), one) ;
+		__m128d ax = _mm_andnot_pd(sign, x) ;
+		__m128d p = _mm_set1_pd(dAcosPoly[7]) ;
+		for (c=6; c >= 0; --c)
+			p = _mm_add_pd(_mm_mul_pd(p, ax), _mm_set1_pd(dAcosPoly[c])) ;
+		__m128d r = _mm_mul_pd(_mm_sqrt_pd(_mm_sub_pd(one, ax)), p) ;
+		r = _mm_blendv_pd(r, _mm_sub_pd(pi, r), _mm_cmplt_pd(x, zero)) ;
+		_mm_storeu_pd(dVal + j, _mm_mul_pd(r, scale)) ;
+		}
+
+	fastAcosScalar(dScale, dVal, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * dirDotAVX2() - 4 poses at a time.
+ */
+KERNEL_TARGET("avx2")
+static void dirDotAVX2(const double dDir[3], const double *dUnit, unsigned uStride, double *dDot, unsigned uCount)
+{
+	const double *dX = dUnit ;
+	const double *dY = dX + uStride ;
+	const double *dZ = dY + uStride ;
+
+	__m256d ax = _mm256_set1_pd(dDir[0]) ;
+	__m256d ay = _mm256_set1_pd(dDir[1]) ;
+	__m256d az = _mm256_set1_pd(dDir[2]) ;
+
+	unsigned j = 0 ;
+	for ( ; j + 4 <= uCount; j += 4)
+		{
+		__m256d d = _mm256_mul_pd(ax, _mm256_loadu_pd(dX + j)) ;
+		d = _mm256_add_pd(d, _mm256_mul_pd(ay, _mm256_loadu_pd(dY + j))) ;
+		d = _mm256_add_pd(d, _mm256_mul_pd(az, _mm256_loadu_pd(dZ + j))) ;
+		_mm256_storeu_pd(dDot + j, d) ;
+		}
+
+	dirDotScalar(dDir, dUnit, uStride, dDot, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * fastAcosAVX2() - 4 at a time.
+ */
+KERNEL_TARGET("avx2")
+static void fastAcosAVX2(double dScale, double *dVal, unsigned uCount)
+{
+	__m256d one = _mm256_set1_pd(1.0) ;
+	__m256d negOne = _mm256_set1_pd(-1.0) ;
+	__m256d zero = _mm256_setzero_pd() ;
+	__m256d sign = _mm256_set1_pd(-0.0) ;
+	__m256d pi = _mm256_set1_pd(dFastPi) ;
+	__m256d scale = _mm256_set1_pd(dScale) ;
+
+	unsigned j = 0 ;
+	int c ;
+	for ( ; j + 4 <= uCount; j += 4)
+		{
+		__m256d x = _mm256_min_pd(_mm256_max_pd(_mm256_loadu_pd(dVal + j), negOne), one) ;
+		__m256d ax = _mm256_andnot_pd(sign, x) ;
+		__m256d p = _mm256_set1_pd(dAcosPoly[7]) ;
+		for (c=6; c >= 0; --c)
+			p = _mm256_add_pd(_mm256_mul_pd(p, ax), _mm256_set1_pd(dAcosPoly[c])) ;
+		__m256d r = _mm256_mul_pd(_mm256_sqrt_pd(_mm256_sub_pd(one, ax)), p) ;
+		r = _mm256_blendv_pd(r, _mm256_sub_pd(pi, r), _mm256_cmp_pd(x, zero, _CMP_LT_OQ)) ;
+		_mm256_storeu_pd(dVal + j, _mm256_mul_pd(r, scale)) ;
+		}
+
+	fastAcosScalar(dScale, dVal, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * dirDotAVX512() - 8 poses at a time.
+ */
+KERNEL_TARGET("avx512f")
+static void dirDotAVX512(const double dDir[3], const double *dUnit, unsigned uStride, double *dDot, unsigned uCount)
+{
+	const double *dX = dUnit ;
+	const double *dY = dX + uStride ;
+	const double *dZ = dY + uStride ;
+
+	__m512d ax = _mm512_set1_pd(dDir[0]) ;
+	__m512d ay = _mm512_set1_pd(dDir[1]) ;
+	__m512d az = _mm512_set1_pd(dDir[2]) ;
+
+	unsigned j = 0 ;
+	for ( ; j + 8 <= uCount; j += 8)
+		{
+		__m512d d = _mm512_mul_pd(ax, _mm512_loadu_pd(dX + j)) ;
+		d = _mm512_add_pd(d, _mm512_mul_pd(ay, _mm512_loadu_pd(dY + j))) ;
+		d = _mm512_add_pd(d, _mm512_mul_pd(az, _mm512_loadu_pd(dZ + j))) ;
+		_mm512_storeu_pd(dDot + j, d) ;
+		}
+
+	dirDotScalar(dDir, dUnit, uStride, dDot, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * fastAcosAVX512() - 8 at a time.  The |x| and the select go thru the integer
+ *		and mask ops, avx512f has no double andnot or blendv.
+ */
+KERNEL_TARGET("avx512f")
+static void fastAcosAVX512(double dScale, double *dVal, unsigned uCount)
+{
+	__m512d one = _mm512_set1_pd(1.0) ;
+	__m512d negOne = _mm512_set1_pd(-1.0) ;
+	__m512d zero = _mm512_setzero_pd() ;
+	__m512i mask = _mm512_set1_epi64(0x7fffffffffffffffLL) ;
+	__m512d pi = _mm512_set1_pd(dFastPi) ;
+	__m512d scale = _mm512_set1_pd(dScale) ;
+
+	unsigned j = 0 ;
+	int c ;
+	for ( ; j + 8 <= uCount; j += 8)
+		{
+		__m512d x = _mm512_min_pd(_mm512_max_pd(_mm512_loadu_pd(dVal + j), negOne), one) ;
+		__m512d ax = _mm512_castsi512_pd(_mm512_and_epi64(_mm512_castpd_si512(x), mask)) ;
+		__m512d p = _mm512_set1_pd(dAcosPoly[7]) ;
+		for (c=6; c >= 0; --c)
+			p = _mm512_add_pd(_mm512_mul_pd(p, ax), _mm512_set1_pd(dAcosPoly[c])) ;
+		__m512d r = _mm512_mul_pd(_mm512_sqrt_pd(_mm512_sub_pd(one, ax)), p) ;
+		r = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(x, zero, _CMP_LT_OQ), r, _mm512_sub_pd(pi, r)) ;
+		_mm512_storeu_pd(dVal + j, _mm512_mul_pd(r, scale)) ;
+		}
+
+	fastAcosScalar(dScale, dVal, j, uCount) ;		// Leftovers
+}
+
+#endif // KERNEL_X86
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelDirDot() - dDot[j] = dDir . unit vector j, for uCount SoA unit vectors.
+ */
+void poseKernelDirDot(int nKernel, const double dDir[3], const double *dUnit, unsigned uStride, double *dDot, unsigned uCount)
+{
+#if KERNEL_X86
+	switch (nKernel)
+		{
+		case eKernelAVX512:
+			dirDotAVX512(dDir, dUnit, uStride, dDot, uCount) ;
+			return ;
+		case eKernelAVX2:
+			dirDotAVX2(dDir, dUnit, uStride, dDot, uCount) ;
+			return ;
+		case eKernelSSE4:
+			dirDotSSE4(dDir, dUnit, uStride, dDot, uCount) ;
+			return ;
+		}
+#endif
+	dirDotScalar(dDir, dUnit, uStride, dDot, 0, uCount) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelFastAcos() - dVal[j] = acos(dVal[j]) * dScale, in place.  Values past
+ *		+-1 are clamped first.  Abs error of the acos is under 3e-8, see above.
+ */
+void poseKernelFastAcos(int nKernel, double dScale, double *dVal, unsigned uCount)
+{
+#if KERNEL_X86
+	switch (nKernel)
+		{
+		case eKernelAVX512:
+			fastAcosAVX512(dScale, dVal, uCount) ;
+			return ;
+		case eKernelAVX2:
+			fastAcosAVX2(dScale, dVal, uCount) ;
+			return ;
+		case eKernelSSE4:
+			fastAcosSSE4(dScale, dVal, uCount) ;
+			return ;
+		}
+#endif
+	fastAcosScalar(dScale, dVal, 0, uCount) ;
+}
+
+// ---------------------------------------------------------------------------
+//	Pose Feature Distance
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+
+/*
+ * quatDotScalar() - Reference version of |q . feat column j|.  dFeat holds the
+ *		x's, then uStride later the y's, then the z's, then the w's.
+ */
+static void quatDotScalar(const double dQ[4], const double *dFeat, unsigned uStride, double *dDot, unsigned uStart, unsigned uCount)
+{
+	const double *dX = dFeat ;
+	const double *dY = dX + uStride ;
+	const double *dZ = dY + uStride ;
+	const double *dW = dZ + uStride ;
+
+	unsigned j ;
+	for (j=uStart; j < uCount; ++j)
+		dDot[j] = fabs(dQ[0] * dX[j] + dQ[1] * dY[j] + dQ[2] * dZ[j] + dQ[3] * dW[j]) ;
+}
+
+// ---------------------------------------------------------------------------
+
+#if KERNEL_X86
+
+/*
+ * quatDotSSE4() - 2 poses at a time.  Clearing the sign bit is what fabs() does.
+ */
+KERNEL_TARGET("sse4.1")
+static void quatDotSSE4(const double dQ[4], const double *dFeat, unsigned uStride, double *dDot, unsigned uCount)
+{
+	const double *dX = dFeat ;
+	const double *dY = dX + uStride ;
+	const double *dZ = dY + uStride ;
+	const double *dW = dZ + uStride ;
+
+	__m128d qx = _mm_set1_pd(dQ[0]) ;
+	__m128d qy = _mm_set1_pd(dQ[1]) ;
+	__m128d qz = _mm_set1_pd(dQ[2]) ;
+	__m128d qw = _mm_set1_pd(dQ[3]) ;
+	__m128d sign = _mm_set1_pd(-0.0) ;
+
+	unsigned j = 0 ;
+	for ( ; j + 2 <= uCount; j += 2)
+		{
+		__m128d d = _mm_mul_pd(qx, _mm_loadu_pd(dX + j)) ;
+		d = _mm_add_pd(d, _mm_mul_pd(qy, _mm_loadu_pd(dY + j))) ;
+		d = _mm_add_pd(d, _mm_mul_pd(qz, _mm_loadu_pd(dZ + j))) ;
+		d = _mm_add_pd(d, _mm_mul_pd(qw, _mm_loadu_pd(dW + j))) ;
+		_mm_storeu_pd(dDot + j, _mm_andnot_pd(sign, d)) ;
+		}
+
+	quatDotScalar(dQ, dFeat, uStride, dDot, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * quatDotAVX2() - 4 poses at a time.
+ */
+KERNEL_TARGET("avx2")
+static void quatDotAVX2(const double dQ[4], const double *dFeat, unsigned uStride, double *dDot, unsigned uCount)
+{
+	const double *dX = dFeat ;
+	const double *dY = dX + uStride ;
+	const double *dZ = dY + uStride ;
+	const double *dW = dZ + uStride ;
+
+	__m256d qx = _mm256_set1_pd(dQ[0]) ;
+	__m256d qy = _mm256_set1_pd(dQ[1]) ;
+	__m256d qz = _mm256_set1_pd(dQ[2]) ;
+	__m256d qw = _mm256_set1_pd(dQ[3]) ;
+	__m256d sign = _mm256_set1_pd(-0.0) ;
+
+	unsigned j = 0 ;
+	for ( ; j + 4 <= uCount; j += 4)
+		{
+		__m256d d = _mm256_mul_pd(qx, _mm256_loadu_pd(dX + j)) ;
+		d = _mm256_add_pd(d, _mm256_mul_pd(qy, _mm256_loadu_pd(dY + j))) ;
+		d = _mm256_add_pd(d, _mm256_mul_pd(qz, _mm256_loadu_pd(dZ + j))) ;
+		d = _mm256_add_pd(d, _mm256_mul_pd(qw, _mm256_loadu_pd(dW + j))) ;
+		_mm256_storeu_pd(dDot + j, _mm256_andnot_pd(sign, d)) ;
+		}
+
+	quatDotScalar(dQ, dFeat, uStride, dDot, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * quatDotAVX512() - 8 poses at a time.  avx512f has no andnot for doubles, so
+ *		the sign bit is cleared as integers.
+ */
+KERNEL_TARGET("avx512f")
+static void quatDotAVX512(const double dQ[4], const double *dFeat, unsigned uStride, double *dDot, unsigned uCount)
+{
+	const double *dX = dFeat ;
+	const double *dY = dX + uStride ;
+	const double *dZ = dY + uStride ;
+	const double *dW = dZ + uStride ;
+
+	__m512d qx = _mm512_set1_pd(dQ[0]) ;
+	__m512d qy = _mm512_set1_pd(dQ[1]) ;
+	__m512d qz = _mm512_set1_pd(dQ[2]) ;
+	__m512d qw = _mm512_set1_pd(dQ[3]) ;
+	__m512i mask = _mm512_set1_epi64(0x7fffffffffffffffLL) ;
+
+	unsigned j = 0 ;
+	for ( ; j + 8 <= uCount; j += 8)
+		{
+		__m512d d = _mm512_mul_pd(qx, _mm512_loadu_pd(dX + j)) ;
+		d = _mm512_add_pd(d, _mm512_mul_pd(qy, _mm512_loadu_pd(dY + j))) ;
+		d = _mm512_add_pd(d, _mm512_mul_pd(qz, _mm512_loadu_pd(dZ + j))) ;
+		d = _mm512_add_pd(d, _mm512_mul_pd(qw, _mm512_loadu_pd(dW + j))) ;
+		_mm512_storeu_pd(dDot + j, _mm512_castsi512_pd(_mm512_and_epi64(_mm512_castpd_si512(d), mask))) ;
+		}
+
+	quatDotScalar(dQ, dFeat, uStride, dDot, j, uCount) ;		// Leftovers
+}
+
+#endif // KERNEL_X86
+
+// ---------------------------------------------------------------------------
+
+/*
+ * quatDot() - Dispatch for the above.
+ */
+static void quatDot(int nKernel, const double dQ[4], const double *dFeat, unsigned uStride, double *dDot, unsigned uCount)
+{
+#if KERNEL_X86
+	switch (nKernel)
+		{
+		case eKernelAVX512:
+			quatDotAVX512(dQ, dFeat, uStride, dDot, uCount) ;
+			return ;
+		case eKernelAVX2:
+			quatDotAVX2(dQ, dFeat, uStride, dDot, uCount) ;
+			return ;
+		case eKernelSSE4:
+			quatDotSSE4(dQ, dFeat, uStride, dDot, uCount) ;
+			return ;
+		}
+#endif
+	quatDotScalar(dQ, dFeat, uStride, dDot, 0, uCount) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelQuatDist() - Distance from the query feature to uCount packed pose
+ *		features.  Each of the uSlots quaternions is 4 rows of dFeat, x y z w,
+ *		uStride apart, one column per pose.  The angle between two rotations
+ *		is 2*acos(|q1.q2|), the |.| so q and -q count as the same, and the
+ *		slots are mixed as the root mean square of their angles so a one 
+ *		slot feature gives the same 0-1 scale as the read axis angle.
+ *		The dots go thru the SIMD paths a tile of poses at a time.  The acos 
+ *		is the exact scalar one, or poseKernelFastAcos() if bFast.
+ */
+void poseKernelQuatDist(int nKernel, const double *dQuery, unsigned uSlots, const double *dFeat, unsigned uStride, double *dDist, unsigned uCount, bool bFast)
+{
+	double dDot[KERNELTILE] ;
+	double dSum[KERNELTILE] ;
+
+	unsigned uBase, uTile, j, k ;
+	for (uBase=0; uBase < uCount; uBase += uTile)
+		{
+		uTile = uCount - uBase ;
+		if (uTile > KERNELTILE)
+			uTile = KERNELTILE ;
+
+		for (j=0; j < uTile; ++j)
+			dSum[j] = 0.0 ;
+
+		for (k=0; k < uSlots; ++k)
+			{
+			quatDot(nKernel, dQuery + k*4, dFeat + k*4*uStride + uBase, uStride, dDot, uTile) ;
+			if (bFast)
+				{
+				poseKernelFastAcos(nKernel, 2.0, dDot, uTile) ;
+				for (j=0; j < uTile; ++j)
+					dSum[j] += dDot[j] * dDot[j] ;
+				continue ;
+				}
+			for (j=0; j < uTile; ++j)
+				{
+				double dAng = 2.0 * acos(dDot[j] < 1.0 ? dDot[j] : 1.0) ;
+				dSum[j] += dAng * dAng ;
+				}
+			}
+
+		for (j=0; j < uTile; ++j)
+			dDist[uBase + j] = uSlots ? sqrt(dSum[j] / (double)uSlots) / 3.14159 : 0.0 ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+//	Table Lookup
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+
+/*
+ * lookupScalar() - Reference version of the linearly interpolated table lookup.
+ *		Position x = dVal * dScale is clamped to [0, uSize], a NaN goes to 0 the
+ *		same way max_pd does it, and dTable must hold uSize+2 values.
+ */
+static void lookupScalar(const double *dTable, unsigned uSize, double dScale, double *dVal, unsigned uStart, unsigned uCount)
+{
+	double dMax = (double)uSize ;
+
+	unsigned j ;
+	for (j=uStart; j < uCount; ++j)
+		{
+		double x = dVal[j] * dScale ;
+		x = (x > 0.0) ? x : 0.0 ;
+		x = (x < dMax) ? x : dMax ;
+		double f = floor(x) ;
+		int i = (int)f ;
+		double t = x - f ;
+		dVal[j] = dTable[i] + t * (dTable[i+1] - dTable[i]) ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+#if KERNEL_X86
+
+/*
+ * lookupSSE4() - 2 at a time.  No gather before avx2, so the two slots are 
+ *		loaded one by one.
+ */
+KERNEL_TARGET("sse4.1")
+static void lookupSSE4(const double *dTable, unsigned uSize, double dScale, double *dVal, unsigned uCount)
+{
+	__m128d scale = _mm_set1_pd(dScale) ;
+	__m128d zero = _mm_setzero_pd() ;
+	__m128d vmax = _mm_set1_pd((double)uSize) ;
+
+	unsigned j = 0 ;
+	for ( ; j + 2 <= uCount; j += 2)
+		{
+		__m128d x = _mm_min_pd(_mm_max_pd(_mm_mul_pd(_mm_loadu_pd(dVal + j), scale), zero), vmax) ;
+		__m128d f = _mm_floor_pd(x) ;
+		__m128i idx = _mm_cvttpd_epi32(f) ;
+		int i0 = _mm_cvtsi128_si32(idx) ;
+		int i1 = _mm_extract_epi32(idx, 1) ;
+		__m128d a = _mm_set_pd(dTable[i1], dTable[i0]) ;
+		__m128d b = _mm_set_pd(dTable[i1+1], dTable[i0+1]) ;
+		__m128d t = _mm_sub_pd(x, f) ;
+		_mm_storeu_pd(dVal + j, _mm_add_pd(a, _mm_mul_pd(t, _mm_sub_pd(b, a)))) ;
+		}
+
+	lookupScalar(dTable, uSize, dScale, dVal, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * lookupAVX2() - 4 at a time.
+ */
+KERNEL_TARGET("avx2")
+static void lookupAVX2(const double *dTable, unsigned uSize, double dScale, double *dVal, unsigned uCount)
+{
+	__m256d scale = _mm256_set1_pd(dScale) ;
+	__m256d zero = _mm256_setzero_pd() ;
+	__m256d vmax = _mm256_set1_pd((double)uSize) ;
+
+	unsigned j = 0 ;
+	for ( ; j + 4 <= uCount; j += 4)
+		{
+		__m256d x = _mm256_min_pd(_mm256_max_pd(_mm256_mul_pd(_mm256_loadu_pd(dVal + j), scale), zero), vmax) ;
+		__m256d f = _mm256_floor_pd(x) ;
+		__m128i idx = _mm256_cvttpd_epi32(f) ;
+		__m256d a = _mm256_i32gather_pd(dTable, idx, 8) ;
+		__m256d b = _mm256_i32gather_pd(dTable + 1, idx, 8) ;
+		__m256d t = _mm256_sub_pd(x, f) ;
+		_mm256_storeu_pd(dVal + j, _mm256_add_pd(a, _mm256_mul_pd(t, _mm256_sub_pd(b, a)))) ;
+		}
+
+	lookupScalar(dTable, uSize, dScale, dVal, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * lookupAVX512() - 8 at a time.
+ */
+KERNEL_TARGET("avx512f")
+static void lookupAVX512(const double *dTable, unsigned uSize, double dScale, double *dVal, unsigned uCount)
+{
+	__m512d scale = _mm512_set1_pd(dScale) ;
+	__m512d zero = _mm512_setzero_pd() ;
+	__m512d vmax = _mm512_set1_pd((double)uSize) ;
+
+	unsigned j = 0 ;
+	for ( ; j + 8 <= uCount; j += 8)
+		{
+		__m512d x = _mm512_min_pd(_mm512_max_pd(_mm512_mul_pd(_mm512_loadu_pd(dVal + j), scale), zero), vmax) ;
+		__m512d f = _mm512_roundscale_pd(x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC) ;
+		__m256i idx = _mm512_cvttpd_epi32(f) ;
+		__m512d a = _mm512_i32gather_pd(idx, dTable, 8) ;
+		__m512d b = _mm512_i32gather_pd(idx, dTable + 1, 8) ;
+		__m512d t = _mm512_sub_pd(x, f) ;
+		_mm512_storeu_pd(dVal + j, _mm512_add_pd(a, _mm512_mul_pd(t, _mm512_sub_pd(b, a)))) ;
+		}
+
+	lookupScalar(dTable, uSize, dScale, dVal, j, uCount) ;		// Leftovers
+}
+
+#endif // KERNEL_X86
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelLookup() - dVal[j] = dTable at position dVal[j] * dScale, linearly 
+ *		interpolated, in place.  This is how the RBF falloff curves are read, so 
+ *		there's no exp or anything else per entry, whichever curve it is.
+ *		The table holds uSize+2 values, sample uSize repeated at the end, and
+ *		positions past uSize read sample uSize.
+ */
+void poseKernelLookup(int nKernel, const double *dTable, unsigned uSize, double dScale, double *dVal, unsigned uCount)
+{
+#if KERNEL_X86
+	switch (nKernel)
+		{
+		case eKernelAVX512:
+			lookupAVX512(dTable, uSize, dScale, dVal, uCount) ;
+			return ;
+		case eKernelAVX2:
+			lookupAVX2(dTable, uSize, dScale, dVal, uCount) ;
+			return ;
+		case eKernelSSE4:
+			lookupSSE4(dTable, uSize, dScale, dVal, uCount) ;
+			return ;
+		}
+#endif
+	lookupScalar(dTable, uSize, dScale, dVal, 0, uCount) ;
+}
+
+// ---------------------------------------------------------------------------
+//	Cone Reader
+// ---------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------
+
+/*
+ * pairDotScalar() - Reference version of dDot[j] = read vector j . cur vector j.
+ *		Both hold the x's, then uStride later the y's, then the z's.
+ */
+static void pairDotScalar(const double *dRead, const double *dCur, unsigned uStride, double *dDot, unsigned uStart, unsigned uCount)
+{
+	const double *rX = dRead ;
+	const double *rY = rX + uStride ;
+	const double *rZ = rY + uStride ;
+	const double *cX = dCur ;
+	const double *cY = cX + uStride ;
+	const double *cZ = cY + uStride ;
+
+	unsigned j ;
+	for (j=uStart; j < uCount; ++j)
+		dDot[j] = rX[j] * cX[j] + rY[j] * cY[j] + rZ[j] * cZ[j] ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * coneRampScalar() - Reference version of the cone falloff.  dVal comes in as
+ *		the angle and goes out as the smoothstep of 1 - angle/cone, clamped
+ *		to 0-1 first.  A NaN goes to 0 the same way max_pd does it.
+ */
+static void coneRampScalar(const double *dInvCone, double *dVal, unsigned uStart, unsigned uCount)
+{
+	unsigned j ;
+	for (j=uStart; j < uCount; ++j)
+		{
+		double t = 1.0 - dVal[j] * dInvCone[j] ;
+		t = (t > 0.0) ? t : 0.0 ;
+		t = (t < 1.0) ? t : 1.0 ;
+		dVal[j] = t * t * (3.0 - (2.0 * t)) ;
+		}
+}
+
+// ---------------------------------------------------------------------------
+
+#if KERNEL_X86
+
+/*
+ * pairDotSSE4() - 2 xforms at a time.
+ */
+KERNEL_TARGET("sse4.1")
+static void pairDotSSE4(const double *dRead, const double *dCur, unsigned uStride, double *dDot, unsigned uCount)
+{
+	const double *rX = dRead ;
+	const double *rY = rX + uStride ;
+	const double *rZ = rY + uStride ;
+	const double *cX = dCur ;
+	const double *cY = cX + uStride ;
+	const double *cZ = cY + uStride ;
+
+	unsigned j = 0 ;
+	for ( ; j + 2 <= uCount; j += 2)
+		{
+		__m128d d = _mm_mul_pd(_mm_loadu_pd(rX + j), _mm_loadu_pd(cX + j)) ;
+		d = _mm_add_pd(d, _mm_mul_pd(_mm_loadu_pd(rY + j), _mm_loadu_pd(cY + j))) ;
+		d = _mm_add_pd(d, _mm_mul_pd(_mm_loadu_pd(rZ + j), _mm_loadu_pd(cZ + j))) ;
+		_mm_storeu_pd(dDot + j, d) ;
+		}
+
+	pairDotScalar(dRead, dCur, uStride, dDot, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * coneRampSSE4() - 2 at a time.
+ */
+KERNEL_TARGET("sse4.1")
+static void coneRampSSE4(const double *dInvCone, double *dVal, unsigned uCount)
+{
+	__m128d one = _mm_set1_pd(1.0) ;
+	__m128d two = _mm_set1_pd(2.0) ;
+	__m128d three = _mm_set1_pd(3.0) ;
+	__m128d zero = _mm_setzero_pd() ;
+
+	unsigned j = 0 ;
+	for ( ; j + 2 <= uCount; j += 2)
+		{
+		__m128d t = _mm_sub_pd(one, _mm_mul_pd(_mm_loadu_pd(dVal + j), _mm_loadu_pd(dInvCone + j))) ;
+		t = _mm_min_pd(_mm_max_pd(t, zero), one) ;
+		__m128d w = _mm_mul_pd(_mm_mul_pd(t, t), _mm_sub_pd(three, _mm_mul_pd(two, t))) ;
+		_mm_storeu_pd(dVal + j, w) ;
+		}
+
+	coneRampScalar(dInvCone, dVal, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * pairDotAVX2() - 4 xforms at a time.
+ */
+KERNEL_TARGET("avx2")
+static void pairDotAVX2(const double *dRead, const double *dCur, unsigned uStride, double *dDot, unsigned uCount)
+{
+	const double *rX = dRead ;
+	const double *rY = rX + uStride ;
+	const double *rZ = rY + uStride ;
+	const double *cX = dCur ;
+	const double *cY = cX + uStride ;
+	const double *cZ = cY + uStride ;
+
+	unsigned j = 0 ;
+	for ( ; j + 4 <= uCount; j += 4)
+		{
+		__m256d d = _mm256_mul_pd(_mm256_loadu_pd(rX + j), _mm256_loadu_pd(cX + j)) ;
+		d = _mm256_add_pd(d, _mm256_mul_pd(_mm256_loadu_pd(rY + j), _mm256_loadu_pd(cY + j))) ;
+		d = _mm256_add_pd(d, _mm256_mul_pd(_mm256_loadu_pd(rZ + j), _mm256_loadu_pd(cZ + j))) ;
+		_mm256_storeu_pd(dDot + j, d) ;
+		}
+
+	pairDotScalar(dRead, dCur, uStride, dDot, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * coneRampAVX2() - 4 at a time.
+ */
+KERNEL_TARGET("avx2")
+static void coneRampAVX2(const double *dInvCone, double *dVal, unsigned uCount)
+{
+	__m256d one = _mm256_set1_pd(1.0) ;
+	__m256d two = _mm256_set1_pd(2.0) ;
+	__m256d three = _mm256_set1_pd(3.0) ;
+	__m256d zero = _mm256_setzero_pd() ;
+
+	unsigned j = 0 ;
+	for ( ; j + 4 <= uCount; j += 4)
+		{
+		__m256d t = _mm256_sub_pd(one, _mm256_mul_pd(_mm256_loadu_pd(dVal + j), _mm256_loadu_pd(dInvCone + j))) ;
+		t = _mm256_min_pd(_mm256_max_pd(t, zero), one) ;
+		__m256d w = _mm256_mul_pd(_mm256_mul_pd(t, t), _mm256_sub_pd(three, _mm256_mul_pd(two, t))) ;
+		_mm256_storeu_pd(dVal + j, w) ;
+		}
+
+	coneRampScalar(dInvCone, dVal, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * pairDotAVX512() - 8 xforms at a time.
+ */
+KERNEL_TARGET("avx512f")
+static void pairDotAVX512(const double *dRead, const double *dCur, unsigned uStride, double *dDot, unsigned uCount)
+{
+	const double *rX = dRead ;
+	const double *rY = rX + uStride ;
+	const double *rZ = rY + uStride ;
+	const double *cX = dCur ;
+	const double *cY = cX + uStride ;
+	const double *cZ = cY + uStride ;
+
+	unsigned j = 0 ;
+	for ( ; j + 8 <= uCount; j += 8)
+		{
+		__m512d d = _mm512_mul_pd(_mm512_loadu_pd(rX + j), _mm512_loadu_pd(cX + j)) ;
+		d = _mm512_add_pd(d, _mm512_mul_pd(_mm512_loadu_pd(rY + j), _mm512_loadu_pd(cY + j))) ;
+		d = _mm512_add_pd(d, _mm512_mul_pd(_mm512_loadu_pd(rZ + j), _mm512_loadu_pd(cZ + j))) ;
+		_mm512_storeu_pd(dDot + j, d) ;
+		}
+
+	pairDotScalar(dRead, dCur, uStride, dDot, j, uCount) ;		// Leftovers
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * coneRampAVX512() - 8 at a time.
+ */
+KERNEL_TARGET("avx512f")
+static void coneRampAVX512(const double *dInvCone, double *dVal, unsigned uCount)
+{
+	__m512d one = _mm512_set1_pd(1.0) ;
+	__m512d two = _mm512_set1_pd(2.0) ;
+	__m512d three = _mm512_set1_pd(3.0) ;
+	__m512d zero = _mm512_setzero_pd() ;
+
+	unsigned j = 0 ;
+	for ( ; j + 8 <= uCount; j += 8)
+		{
+		__m512d t = _mm512_sub_pd(one, _mm512_mul_pd(_mm512_loadu_pd(dVal + j), _mm512_loadu_pd(dInvCone + j))) ;
+		t = _mm512_min_pd(_mm512_max_pd(t, zero), one) ;
+		__m512d w = _mm512_mul_pd(_mm512_mul_pd(t, t), _mm512_sub_pd(three, _mm512_mul_pd(two, t))) ;
+		_mm512_storeu_pd(dVal + j, w) ;
+		}
+
+	coneRampScalar(dInvCone, dVal, j, uCount) ;		// Leftovers
+}
+
+#endif // KERNEL_X86
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelCone() - Cone reader weight for uCount xforms.  The angle between
+ *		each stored reader axis and where it is now, thru poseKernelFastAcos(),
+ *		then 1 inside none of it and smoothstepped down to 0 at the cone angle,
+ *		like the poseReader node does it.  Both sets of axes must be unit length.
+ */
+void poseKernelCone(int nKernel, const double *dRead, const double *dCur, unsigned uStride, const double *dInvCone, double *dWt, unsigned uCount)
+{
+#if KERNEL_X86
+	switch (nKernel)
+		{
+		case eKernelAVX512:
+			pairDotAVX512(dRead, dCur, uStride, dWt, uCount) ;
+			poseKernelFastAcos(nKernel, 1.0, dWt, uCount) ;
+			coneRampAVX512(dInvCone, dWt, uCount) ;
+			return ;
+		case eKernelAVX2:
+			pairDotAVX2(dRead, dCur, uStride, dWt, uCount) ;
+			poseKernelFastAcos(nKernel, 1.0, dWt, uCount) ;
+			coneRampAVX2(dInvCone, dWt, uCount) ;
+			return ;
+		case eKernelSSE4:
+			pairDotSSE4(dRead, dCur, uStride, dWt, uCount) ;
+			poseKernelFastAcos(nKernel, 1.0, dWt, uCount) ;
+			coneRampSSE4(dInvCone, dWt, uCount) ;
+			return ;
+		}
+#endif
+	pairDotScalar(dRead, dCur, uStride, dWt, 0, uCount) ;
+	poseKernelFastAcos(eKernelScalar, 1.0, dWt, uCount) ;
+	coneRampScalar(dInvCone, dWt, 0, uCount) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * poseKernelCheck() - Debug helper.  Runs both nKernel and the scalar reference
+ *		on a copy of the same accumulators and returns the biggest abs difference.
+ *		uCount must be <= KERNELTILE.  Should always come back 0.0.
+ */
+double poseKernelCheck(int nKernel, bool bDiag, const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		const double *dOutX, const double *dOutY, const double *dOutZ, unsigned uCount)
+{
+	double dRefX[KERNELTILE], dRefY[KERNELTILE], dRefZ[KERNELTILE] ;
+	double dTstX[KERNELTILE], dTstY[KERNELTILE], dTstZ[KERNELTILE] ;
+
+	if (uCount > KERNELTILE)
+		uCount = KERNELTILE ;
+
+	unsigned i ;
+	for (i=0; i < uCount; ++i)
+		{
+		dRefX[i] = dTstX[i] = dOutX[i] ;
+		dRefY[i] = dTstY[i] = dOutY[i] ;
+		dRefZ[i] = dTstZ[i] = dOutZ[i] ;
+		}
+
+	if (bDiag)
+		{
+		accumulateDiagScalar(dMap, dX, dY, dZ, dRefX, dRefY, dRefZ, 0, uCount) ;
+		poseKernelAccumulateDiag(nKernel, dMap, dX, dY, dZ, dTstX, dTstY, dTstZ, uCount) ;
+		}
+	else
+		{
+		accumulateScalar(dMap, dX, dY, dZ, dRefX, dRefY, dRefZ, 0, uCount) ;
+		poseKernelAccumulate(nKernel, dMap, dX, dY, dZ, dTstX, dTstY, dTstZ, uCount) ;
+		}
+
+	double dMaxDiff = 0.0 ;
+	for (i=0; i < uCount; ++i)
+		{
+		double dDiff = fabs(dRefX[i] - dTstX[i]) ;
+		if (dDiff > dMaxDiff) dMaxDiff = dDiff ;
+		dDiff = fabs(dRefY[i] - dTstY[i]) ;
+		if (dDiff > dMaxDiff) dMaxDiff = dDiff ;
+		dDiff = fabs(dRefZ[i] - dTstZ[i]) ;
+		if (dDiff > dMaxDiff) dMaxDiff = dDiff ;
+		}
+
+	return dMaxDiff ;
+}
+
+// ---------------------------------------------------------------------------
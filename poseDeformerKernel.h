@@ -0,0 +1,114 @@
+// ---------------------------------------------------------------------------
+// poseDeformerKernel.h - C++ Header File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	The low level math loops of the poseDeformer, written over plain SoA
+//	double arrays so they can run on SSE/AVX when the cpu has it.  Nothing
+//	in here knows about Maya.
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+#ifndef __POSEDEFORMERKERNEL_H
+#define __POSEDEFORMERKERNEL_H
+
+// ---------------------------------------------------------------------------
+
+typedef enum { eKernelAuto, eKernelScalar, eKernelSSE4, eKernelAVX2, eKernelAVX512 } EKERNELMODE ;
+
+#define KERNELTILE		64		// How many pts the deformer hands the kernel at once.
+
+// ---------------------------------------------------------------------------
+
+int poseKernelDetect(void) ;					// Best kernel this cpu can run
+int poseKernelResolve(int nKernel) ;			// Turn a user request into one we can run
+const char* poseKernelName(int nKernel) ;		// For printing
+
+	// out += d * map   for uCount pts.  dMap is a row major 3x3 that already holds
+	// the xform matrix, user scale and weight folded together.
+void poseKernelAccumulate(int nKernel, const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		double *dOutX, double *dOutY, double *dOutZ, unsigned uCount) ;
+
+	// Same as above but only uses the diagonal of dMap, for deltas already in world space.
+void poseKernelAccumulateDiag(int nKernel, const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		double *dOutX, double *dOutY, double *dOutZ, unsigned uCount) ;
+
+	// Same as above but only for the pts a sparse xform stored.  Adds delta 
+	// uDelta[i] on to out slot uSlot[i] for uHits pts.
+void poseKernelScatter(const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		const unsigned *uDelta, const unsigned *uSlot, unsigned uHits,
+		double *dOutX, double *dOutY, double *dOutZ) ;
+
+void poseKernelScatterDiag(const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		const unsigned *uDelta, const unsigned *uSlot, unsigned uHits,
+		double *dOutX, double *dOutY, double *dOutZ) ;
+
+	// dDst -= dL * dSrc for uCount doubles, for the LU trailing update in MatrixNN.
+void poseKernelRowUpdate(int nKernel, double dL, const double *dSrc, double *dDst, unsigned uCount) ;
+
+	// dDst -= dL[r] * row r of dSrc, for uRows rows uStride apart, done in order.
+	// Same answer as uRows poseKernelRowUpdate() calls but dDst only goes thru memory once.
+void poseKernelRowsUpdate(int nKernel, const double *dL, unsigned uRows, const double *dSrc, unsigned uStride, double *dDst, unsigned uCount) ;
+
+	// Distance from dQuery to each of uCount poses, for the RBF Orientation feature.
+	// dQuery is uSlots quaternions x,y,z,w.  dFeat is the same packed SoA, 4*uSlots
+	// rows uStride apart with one column per pose.  0 is the same, 1 is 180 deg off.
+	// bFast uses poseKernelFastAcos().
+void poseKernelQuatDist(int nKernel, const double *dQuery, unsigned uSlots, const double *dFeat, unsigned uStride, double *dDist, unsigned uCount, bool bFast) ;
+
+	// dDot[j] = dDir . unit vector j, dUnit is the x's, y's then z's, uStride apart.
+void poseKernelDirDot(int nKernel, const double dDir[3], const double *dUnit, unsigned uStride, double *dDot, unsigned uCount) ;
+
+	// acos(x)*dScale in place, for the RBF kernel matrix.  Abs err < 3e-8 rad, see 
+	// poseDeformerKernel.cpp.
+void poseKernelFastAcos(int nKernel, double dScale, double *dVal, unsigned uCount) ;
+
+	// dVal = dTable at dVal*dScale, linearly interpolated, in place.  dTable is uSize+2 
+	// long, the last sample repeated, and positions are clamped to [0, uSize].
+void poseKernelLookup(int nKernel, const double *dTable, unsigned uSize, double dScale, double *dVal, unsigned uCount) ;
+
+	// Cone reader weight for uCount xforms.  dRead and dCur are unit axes, x's then y's
+	// then z's uStride apart, dInvCone is 1/cone angle in radians.  1 on the axis down to
+	// 0 at the cone, smoothstepped.
+void poseKernelCone(int nKernel, const double *dRead, const double *dCur, unsigned uStride, const double *dInvCone, double *dWt, unsigned uCount) ;
+
+	// Runs nKernel and the scalar path on the same data and returns the biggest abs diff.
+	// bDiag checks the diagonal kernel instead.
+double poseKernelCheck(int nKernel, bool bDiag, const double dMap[9],
+		const double *dX, const double *dY, const double *dZ,
+		const double *dOutX, const double *dOutY, const double *dOutZ, unsigned uCount) ;
+
+// ---------------------------------------------------------------------------
+
+#endif // end of __POSEDEFORMERKERNEL_H
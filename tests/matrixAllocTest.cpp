@@ -0,0 +1,243 @@
+// ---------------------------------------------------------------------------
+// matrixAllocTest.cpp - C++ File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	Standalone test of MatrixNN's storage, counted with MatrixNN::uAllocCount.
+//	Moves must hand the heap over without allocing, small matrices must live
+//	in dInline, resizing must reuse storage that's big enough and must not
+//	write over the values, and heap storage must be MATRIXNN_ALIGN aligned.
+//	No Maya needed:
+//
+//		g++ -O2 -I.. matrixAllocTest.cpp ../MatrixNN.cpp ../poseDeformerKernel.cpp -o matrixAllocTest
+//
+//	Returns 0 if every check passed.
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+/*
+ * Includes
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <utility>
+
+#include "MatrixNN.h"
+
+// ---------------------------------------------------------------------------
+
+#define ALLOCTESTN		10		// A size that has to go on the heap
+#define ALLOCTESTVAL	7.25	// Marker value, not 0 or 1 so an identity fill shows
+
+static int nFails = 0 ;
+
+// ---------------------------------------------------------------------------
+
+/*
+ * check() - Prints one result and counts the fails.
+ */
+static void check(bool bPass, const char *strWhat)
+{
+	printf("%-56s %s\n", strWhat, bPass ? "ok" : "FAIL") ;
+	if (!bPass)
+		++nFails ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * allAre() - True if the first uDim x uDim values of matNN are all dVal.
+ */
+static bool allAre(const MatrixNN &matNN, unsigned uDim, double dVal)
+{
+	unsigned u ;
+	for (u=0; u < uDim * uDim; ++u)
+		if (matNN.ptrDbl[u] != dVal)
+			return false ;
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testInline() - Every N up to MATRIXNN_INLINE goes in dInline, no heap.
+ */
+static void testInline(void)
+{
+	unsigned uBefore = MatrixNN::uAllocCount ;
+	bool bInline = true ;
+	unsigned uDim ;
+	for (uDim=1; uDim <= MATRIXNN_INLINE; ++uDim)
+		{
+		MatrixNN matA ;
+		if (matA.setDimension(uDim) != uDim || matA.ptrDbl != matA.dInline || matA.ptrHeap != NULL)
+			bInline = false ;
+		}
+	check(bInline, "N <= MATRIXNN_INLINE uses dInline") ;
+	check(MatrixNN::uAllocCount == uBefore, "N <= MATRIXNN_INLINE does no heap alloc") ;
+
+	MatrixNN matA ;
+	uBefore = MatrixNN::uAllocCount ;
+	matA.setDimension(MATRIXNN_INLINE + 1) ;
+	bool bAligned = ((size_t)matA.ptrDbl % MATRIXNN_ALIGN) == 0 ;
+	check(MatrixNN::uAllocCount == uBefore + 1 && matA.ptrHeap != NULL, "N > MATRIXNN_INLINE does one heap alloc") ;
+	check(bAligned, "Heap storage is MATRIXNN_ALIGN aligned") ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testResize() - Same or smaller reuses the storage, and nothing is written
+ *		over the values, identity or otherwise.
+ */
+static void testResize(void)
+{
+	MatrixNN matA ;
+	matA.setDimension(ALLOCTESTN) ;
+	matA.fill(ALLOCTESTVAL) ;
+	double *ptrWas = matA.ptrDbl ;
+
+	unsigned uBefore = MatrixNN::uAllocCount ;
+	matA.setDimension(ALLOCTESTN) ;
+	check(MatrixNN::uAllocCount == uBefore && matA.ptrDbl == ptrWas, "Resize to the same N does no alloc") ;
+	check(allAre(matA, ALLOCTESTN, ALLOCTESTVAL), "Resize to the same N leaves the values") ;
+
+	matA.setDimension(ALLOCTESTN / 2) ;
+	check(MatrixNN::uAllocCount == uBefore && matA.ptrDbl == ptrWas, "Resize smaller does no alloc") ;
+	check(allAre(matA, ALLOCTESTN / 2, ALLOCTESTVAL), "Resize smaller leaves the values") ;
+
+	matA.setDimension(ALLOCTESTN) ;		// Back up to what it had room for
+	check(MatrixNN::uAllocCount == uBefore && matA.ptrDbl == ptrWas, "Resize back up within capacity does no alloc") ;
+
+	matA.setDimension(ALLOCTESTN * 2) ;
+	check(MatrixNN::uAllocCount == uBefore + 1, "Resize past capacity does one alloc") ;
+
+	MatrixNN matB ;
+	matB.setDimension(ALLOCTESTN) ;
+	matB.fill(0.0) ;
+	uBefore = MatrixNN::uAllocCount ;
+	matB = matA ;		// Copy of a bigger one has to grow
+	matA.setDimension(ALLOCTESTN) ;
+	matB = matA ;		// Copy of a smaller one reuses
+	check(MatrixNN::uAllocCount == uBefore + 1, "Copy assign only allocs when it has to grow") ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testMove() - Moves hand the heap over with no alloc and leave the source
+ *		empty.  Inline ones are copied, still no alloc.
+ */
+static void testMove(void)
+{
+	MatrixNN matA ;
+	matA.setDimension(ALLOCTESTN) ;
+	matA.fill(ALLOCTESTVAL) ;
+	double *ptrWas = matA.ptrDbl ;
+
+	unsigned uBefore = MatrixNN::uAllocCount ;
+	MatrixNN matB( std::move(matA) ) ;
+	check(MatrixNN::uAllocCount == uBefore, "Move ctor does no alloc") ;
+	check(matB.ptrDbl == ptrWas && matB.uDimension == ALLOCTESTN && allAre(matB, ALLOCTESTN, ALLOCTESTVAL),
+			"Move ctor takes the heap storage") ;
+	check(matA.ptrDbl == NULL && matA.ptrHeap == NULL && matA.uDimension == 0, "Move ctor leaves the source empty") ;
+
+	MatrixNN matC ;
+	matC.setDimension(ALLOCTESTN * 2) ;		// Has its own heap to give up
+	uBefore = MatrixNN::uAllocCount ;
+	matC = std::move(matB) ;
+	check(MatrixNN::uAllocCount == uBefore, "Move assign does no alloc") ;
+	check(matC.ptrDbl == ptrWas && matC.uDimension == ALLOCTESTN && allAre(matC, ALLOCTESTN, ALLOCTESTVAL),
+			"Move assign takes the heap storage") ;
+	check(matB.ptrDbl == NULL && matB.ptrHeap == NULL && matB.uDimension == 0, "Move assign leaves the source empty") ;
+
+	MatrixNN matD ;
+	matD.setDimension(MATRIXNN_INLINE) ;
+	matD.fill(ALLOCTESTVAL) ;
+	uBefore = MatrixNN::uAllocCount ;
+	MatrixNN matE( std::move(matD) ) ;
+	MatrixNN matF ;
+	matF = std::move(matE) ;
+	check(MatrixNN::uAllocCount == uBefore, "Moving an inline matrix does no alloc") ;
+	check(matF.ptrDbl == matF.dInline && allAre(matF, MATRIXNN_INLINE, ALLOCTESTVAL), "Moving an inline matrix copies into dInline") ;
+	check(matD.uDimension == 0 && matE.uDimension == 0, "Moving an inline matrix leaves the source empty") ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testFactor() - Once a MatrixNNFactor is alloc'd, refilling, LU factoring and
+ *		solving it again like every frame does allocs nothing.
+ */
+static void testFactor(void)
+{
+	MatrixNNFactor fac ;
+	if (!fac.alloc(ALLOCTESTN))
+		{
+		check(false, "MatrixNNFactor alloc") ;
+		return ;
+		}
+
+	double dB[ALLOCTESTN], dX[ALLOCTESTN] ;
+	unsigned uBefore = MatrixNN::uAllocCount ;
+	int nFrame ;
+	unsigned i,j ;
+	bool bSolved = true ;
+	for (nFrame=0; nFrame < 3; ++nFrame)
+		{
+		if (!fac.alloc(ALLOCTESTN))
+			bSolved = false ;
+		for (i=0; i < ALLOCTESTN; ++i)
+			{
+			for (j=0; j < ALLOCTESTN; ++j)
+				fac.matFac[i][j] = (i == j) ? ALLOCTESTN : 1.0 / (1.0 + i + j) ;
+			dB[i] = i ;
+			}
+		if (!fac.factorizeLU() || !fac.solve(dB, dX))
+			bSolved = false ;
+		}
+	check(bSolved, "MatrixNNFactor refactor and solve works") ;
+	check(MatrixNN::uAllocCount == uBefore, "MatrixNNFactor refactor and solve does no alloc") ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * main() - Every check, counts are only compared within a test.
+ */
+int main(int argc, char **argv)
+{
+	testInline() ;
+	testResize() ;
+	testMove() ;
+	testFactor() ;
+
+	return nFails ? 1 : 0 ;
+}
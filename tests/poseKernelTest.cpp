@@ -0,0 +1,721 @@
+// ---------------------------------------------------------------------------
+// poseKernelTest.cpp - C++ File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	Standalone test for the SIMD kernels.  Runs every path the cpu has 
+//	against the scalar reference over random data, and fails if any of them
+//	is off by more than KERNELTESTBOUND: the delta accumulation, the LU row
+//	updates, the RBF kernel matrix dots, acos and table lookup, and the 
+//	cone reader.  The sparse scatter has no SIMD path but has to match the
+//	scalar accumulate.  poseKernelFastAcos() is also checked against acos()
+//	over all of [-1, 1] for its documented error bound, and poseKernelCone()
+//	against the exact weight.  The kernels don't need Maya, so neither 
+//	does this:
+//
+//		g++ -O2 -I.. poseKernelTest.cpp ../poseDeformerKernel.cpp -o poseKernelTest
+//
+//	Returns 0 if every path passed.
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+/*
+ * Includes
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "poseDeformerKernel.h"
+
+// ---------------------------------------------------------------------------
+
+#define KERNELTESTBOUND		0.0		// Every path is meant to be bit for bit the same as scalar
+#define KERNELTESTRUNS		200		// Random runs per path
+#define KERNELTESTMAXPTS	1000	// Most pts in a run, odd counts hit the scalar tails
+#define KERNELTESTACOSERR	3e-8	// poseKernelFastAcos()'s documented abs error
+#define KERNELTESTACOSPTS	200001	// Grid the acos error is checked on, -1 and 1 included
+#define KERNELTESTTABLE		256		// Lookup table size
+#define KERNELTESTSLOTS		3		// Quaternions per Orientation feature
+#define KERNELTESTROWS		8		// Rows per RowsUpdate call
+#define KERNELTESTCONEERR	1.4e-8	// poseKernelCone()'s abs error from the exact weight
+#define KERNELTESTCONEMIN	5.0		// Cone angles tested, degrees
+#define KERNELTESTCONEMAX	180.0
+
+static int nFails = 0 ;
+
+// ---------------------------------------------------------------------------
+
+/*
+ * randVal() - Random double from -dRange to dRange.
+ */
+static double randVal(double dRange)
+{
+	return ( (double)rand() / (double)RAND_MAX * 2.0 - 1.0 ) * dRange ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * maxDiff() - Biggest abs diff between two sets of SoA outputs.
+ */
+static double maxDiff(const double *dA, const double *dB, unsigned uCount)
+{
+	double dMax = 0.0 ;
+	unsigned i ;
+	for (i=0; i < uCount; ++i)
+		{
+		double dDiff = fabs(dA[i] - dB[i]) ;
+		if (dDiff > dMax || dDiff != dDiff)		// NaN's count as a fail
+			dMax = (dDiff != dDiff) ? HUGE_VAL : dDiff ;
+		}
+	return dMax ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * report() - Prints one result and counts the fails.
+ */
+static void report(int nKernel, const char *strWhat, const char *strVs, double dDiff, double dBound)
+{
+	bool bPass = (dDiff <= dBound) ;
+	printf("%-8s %-12s max diff from %-6s %-12g %s\n", poseKernelName(nKernel), strWhat, strVs, dDiff, bPass ? "ok" : "FAIL") ;
+	if (!bPass)
+		++nFails ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testKernel() - KERNELTESTRUNS random runs of nKernel against scalar, both the
+ *		full 3x3 and the diagonal kernel.  Returns the biggest diff seen.
+ */
+static double testKernel(int nKernel, bool bDiag)
+{
+	double *dIn = new double [KERNELTESTMAXPTS * 3] ;
+	double *dRef = new double [KERNELTESTMAXPTS * 3] ;
+	double *dTst = new double [KERNELTESTMAXPTS * 3] ;
+	if (dIn == NULL || dRef == NULL || dTst == NULL)
+		return HUGE_VAL ;
+
+	double dWorst = 0.0 ;
+	int nRun ;
+	unsigned i ;
+	for (nRun=0; nRun < KERNELTESTRUNS; ++nRun)
+		{
+		unsigned uCount = 1 + (unsigned)rand() % KERNELTESTMAXPTS ;
+
+		double dMap[9] ;
+		for (i=0; i < 9; ++i)
+			dMap[i] = randVal(2.0) ;
+		for (i=0; i < uCount * 3; ++i)
+			{
+			dIn[i] = randVal(10.0) ;
+			dRef[i] = dTst[i] = randVal(100.0) ;		// Accumulated on to, so not just zeroes
+			}
+
+		const double *dX = dIn ;
+		const double *dY = dIn + uCount ;
+		const double *dZ = dIn + uCount * 2 ;
+		if (bDiag)
+			{
+			poseKernelAccumulateDiag(eKernelScalar, dMap, dX, dY, dZ, dRef, dRef + uCount, dRef + uCount * 2, uCount) ;
+			poseKernelAccumulateDiag(nKernel, dMap, dX, dY, dZ, dTst, dTst + uCount, dTst + uCount * 2, uCount) ;
+			}
+		else
+			{
+			poseKernelAccumulate(eKernelScalar, dMap, dX, dY, dZ, dRef, dRef + uCount, dRef + uCount * 2, uCount) ;
+			poseKernelAccumulate(nKernel, dMap, dX, dY, dZ, dTst, dTst + uCount, dTst + uCount * 2, uCount) ;
+			}
+
+		double dDiff = maxDiff(dRef, dTst, uCount * 3) ;
+		if (dDiff > dWorst)
+			dWorst = dDiff ;
+		}
+
+	delete [] dIn ;
+	delete [] dRef ;
+	delete [] dTst ;
+	return dWorst ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testScatter() - poseKernelScatter() against the scalar accumulate.  First with
+ *		every pt hit in order, which is just the dense case.  Then with a random
+ *		sparse set of slots, checked against accumulating a gathered copy of 
+ *		those slots, and every slot not hit has to be left alone.
+ */
+static double testScatter(bool bDiag)
+{
+	double *dIn = new double [KERNELTESTMAXPTS * 3] ;
+	double *dRef = new double [KERNELTESTMAXPTS * 3] ;
+	double *dTst = new double [KERNELTESTMAXPTS * 3] ;
+	double *dGather = new double [KERNELTESTMAXPTS * 3] ;
+	unsigned *uDelta = new unsigned [KERNELTESTMAXPTS] ;
+	unsigned *uSlot = new unsigned [KERNELTESTMAXPTS] ;
+	if (dIn == NULL || dRef == NULL || dTst == NULL || dGather == NULL || uDelta == NULL || uSlot == NULL)
+		return HUGE_VAL ;
+
+	double dWorst = 0.0 ;
+	int nRun ;
+	unsigned i, h ;
+	for (nRun=0; nRun < KERNELTESTRUNS; ++nRun)
+		{
+		unsigned uCount = 1 + (unsigned)rand() % KERNELTESTMAXPTS ;
+		bool bSparse = (nRun % 2) != 0 ;
+
+		double dMap[9] ;
+		for (i=0; i < 9; ++i)
+			dMap[i] = randVal(2.0) ;
+		for (i=0; i < uCount * 3; ++i)
+			{
+			dIn[i] = randVal(10.0) ;
+			dRef[i] = dTst[i] = randVal(100.0) ;
+			}
+
+		// Which slots get hit, in order.  Deltas are packed like a sparse xform stores them.
+		unsigned uHits = 0 ;
+		for (i=0; i < uCount; ++i)
+			{
+			if (bSparse && rand() % 4 != 0)
+				continue ;
+			uDelta[uHits] = uHits ;
+			uSlot[uHits] = i ;
+			++uHits ;
+			}
+
+		const double *dX = dIn ;
+		const double *dY = dIn + uCount ;
+		const double *dZ = dIn + uCount * 2 ;
+		if (bDiag)
+			poseKernelScatterDiag(dMap, dX, dY, dZ, uDelta, uSlot, uHits, dTst, dTst + uCount, dTst + uCount * 2) ;
+		else
+			poseKernelScatter(dMap, dX, dY, dZ, uDelta, uSlot, uHits, dTst, dTst + uCount, dTst + uCount * 2) ;
+
+		// The reference runs the scalar accumulate over just the hit slots, then puts them back.
+		for (h=0; h < uHits; ++h)
+			{
+			dGather[h] = dRef[uSlot[h]] ;
+			dGather[uHits + h] = dRef[uCount + uSlot[h]] ;
+			dGather[uHits * 2 + h] = dRef[uCount * 2 + uSlot[h]] ;
+			}
+		if (bDiag)
+			poseKernelAccumulateDiag(eKernelScalar, dMap, dX, dY, dZ, dGather, dGather + uHits, dGather + uHits * 2, uHits) ;
+		else
+			poseKernelAccumulate(eKernelScalar, dMap, dX, dY, dZ, dGather, dGather + uHits, dGather + uHits * 2, uHits) ;
+		for (h=0; h < uHits; ++h)
+			{
+			dRef[uSlot[h]] = dGather[h] ;
+			dRef[uCount + uSlot[h]] = dGather[uHits + h] ;
+			dRef[uCount * 2 + uSlot[h]] = dGather[uHits * 2 + h] ;
+			}
+
+		double dDiff = maxDiff(dRef, dTst, uCount * 3) ;
+		if (dDiff > dWorst)
+			dWorst = dDiff ;
+		}
+
+	delete [] dIn ;
+	delete [] dRef ;
+	delete [] dTst ;
+	delete [] dGather ;
+	delete [] uDelta ;
+	delete [] uSlot ;
+	return dWorst ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testRowUpdate() - poseKernelRowUpdate() against scalar, or if bRows 
+ *		poseKernelRowsUpdate() against KERNELTESTROWS scalar row updates, which 
+ *		it's meant to match exactly.  Rows are padded apart like a MatrixNN 
+ *		panel's.
+ */
+static double testRowUpdate(int nKernel, bool bRows)
+{
+	unsigned uMaxStride = KERNELTESTMAXPTS + 8 ;
+	double *dSrc = new double [KERNELTESTROWS * uMaxStride] ;
+	double *dRef = new double [KERNELTESTMAXPTS] ;
+	double *dTst = new double [KERNELTESTMAXPTS] ;
+	if (dSrc == NULL || dRef == NULL || dTst == NULL)
+		return HUGE_VAL ;
+
+	double dWorst = 0.0 ;
+	int nRun ;
+	unsigned i, r ;
+	for (nRun=0; nRun < KERNELTESTRUNS; ++nRun)
+		{
+		unsigned uCount = 1 + (unsigned)rand() % KERNELTESTMAXPTS ;
+		unsigned uStride = uCount + (unsigned)rand() % 8 ;
+
+		double dL[KERNELTESTROWS] ;
+		for (r=0; r < KERNELTESTROWS; ++r)
+			dL[r] = randVal(2.0) ;
+		for (i=0; i < KERNELTESTROWS * uStride; ++i)
+			dSrc[i] = randVal(10.0) ;
+		for (i=0; i < uCount; ++i)
+			dRef[i] = dTst[i] = randVal(100.0) ;
+
+		if (bRows)
+			{
+			for (r=0; r < KERNELTESTROWS; ++r)
+				poseKernelRowUpdate(eKernelScalar, dL[r], dSrc + r * uStride, dRef, uCount) ;
+			poseKernelRowsUpdate(nKernel, dL, KERNELTESTROWS, dSrc, uStride, dTst, uCount) ;
+			}
+		else
+			{
+			poseKernelRowUpdate(eKernelScalar, dL[0], dSrc, dRef, uCount) ;
+			poseKernelRowUpdate(nKernel, dL[0], dSrc, dTst, uCount) ;
+			}
+
+		double dDiff = maxDiff(dRef, dTst, uCount) ;
+		if (dDiff > dWorst)
+			dWorst = dDiff ;
+		}
+
+	delete [] dSrc ;
+	delete [] dRef ;
+	delete [] dTst ;
+	return dWorst ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * randUnit() - Random unit vector of uDim values into dVec.
+ */
+static void randUnit(double *dVec, unsigned uDim)
+{
+	double dLen ;
+	unsigned k ;
+	do	{
+		dLen = 0.0 ;
+		for (k=0; k < uDim; ++k)
+			{
+			dVec[k] = randVal(1.0) ;
+			dLen += dVec[k] * dVec[k] ;
+			}
+		dLen = sqrt(dLen) ;
+		} while (dLen < 0.1 || dLen > 1.0) ;
+	for (k=0; k < uDim; ++k)
+		dVec[k] /= dLen ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testQuatDist() - poseKernelQuatDist() against scalar, KERNELTESTSLOTS 
+ *		quaternions per pose.  Pose 0 is the query itself and pose 1 is the
+ *		query negated, so the dot clamp at 1 and the |.| both get hit.
+ */
+static double testQuatDist(int nKernel, bool bFast)
+{
+	unsigned uMaxStride = KERNELTESTMAXPTS + 8 ;
+	double *dFeat = new double [KERNELTESTSLOTS * 4 * uMaxStride] ;
+	double *dRef = new double [KERNELTESTMAXPTS] ;
+	double *dTst = new double [KERNELTESTMAXPTS] ;
+	if (dFeat == NULL || dRef == NULL || dTst == NULL)
+		return HUGE_VAL ;
+
+	double dWorst = 0.0 ;
+	int nRun ;
+	unsigned j, k, c ;
+	for (nRun=0; nRun < KERNELTESTRUNS; ++nRun)
+		{
+		unsigned uCount = 1 + (unsigned)rand() % KERNELTESTMAXPTS ;
+		unsigned uStride = uCount + (unsigned)rand() % 8 ;
+
+		double dQuery[KERNELTESTSLOTS * 4] ;
+		for (k=0; k < KERNELTESTSLOTS; ++k)
+			randUnit(dQuery + k * 4, 4) ;
+		for (j=0; j < uCount; ++j)
+			{
+			for (k=0; k < KERNELTESTSLOTS; ++k)
+				{
+				double dQ[4] ;
+				randUnit(dQ, 4) ;
+				for (c=0; c < 4; ++c)
+					{
+					if (j == 0)
+						dQ[c] = dQuery[k*4+c] ;
+					else if (j == 1)
+						dQ[c] = -dQuery[k*4+c] ;
+					dFeat[(k*4+c) * uStride + j] = dQ[c] ;
+					}
+				}
+			}
+
+		poseKernelQuatDist(eKernelScalar, dQuery, KERNELTESTSLOTS, dFeat, uStride, dRef, uCount, bFast) ;
+		poseKernelQuatDist(nKernel, dQuery, KERNELTESTSLOTS, dFeat, uStride, dTst, uCount, bFast) ;
+
+		double dDiff = maxDiff(dRef, dTst, uCount) ;
+		if (dDiff > dWorst)
+			dWorst = dDiff ;
+		}
+
+	delete [] dFeat ;
+	delete [] dRef ;
+	delete [] dTst ;
+	return dWorst ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testDirDot() - poseKernelDirDot() against scalar.
+ */
+static double testDirDot(int nKernel)
+{
+	unsigned uMaxStride = KERNELTESTMAXPTS + 8 ;
+	double *dUnit = new double [3 * uMaxStride] ;
+	double *dRef = new double [KERNELTESTMAXPTS] ;
+	double *dTst = new double [KERNELTESTMAXPTS] ;
+	if (dUnit == NULL || dRef == NULL || dTst == NULL)
+		return HUGE_VAL ;
+
+	double dWorst = 0.0 ;
+	int nRun ;
+	unsigned j ;
+	for (nRun=0; nRun < KERNELTESTRUNS; ++nRun)
+		{
+		unsigned uCount = 1 + (unsigned)rand() % KERNELTESTMAXPTS ;
+		unsigned uStride = uCount + (unsigned)rand() % 8 ;
+
+		double dDir[3], dVec[3] ;
+		randUnit(dDir, 3) ;
+		for (j=0; j < uCount; ++j)
+			{
+			randUnit(dVec, 3) ;
+			dUnit[j] = dVec[0] ;
+			dUnit[uStride + j] = dVec[1] ;
+			dUnit[uStride * 2 + j] = dVec[2] ;
+			}
+
+		poseKernelDirDot(eKernelScalar, dDir, dUnit, uStride, dRef, uCount) ;
+		poseKernelDirDot(nKernel, dDir, dUnit, uStride, dTst, uCount) ;
+
+		double dDiff = maxDiff(dRef, dTst, uCount) ;
+		if (dDiff > dWorst)
+			dWorst = dDiff ;
+		}
+
+	delete [] dUnit ;
+	delete [] dRef ;
+	delete [] dTst ;
+	return dWorst ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testFastAcos() - poseKernelFastAcos() against scalar, over values a bit past
+ *		+-1 on both sides so the clamps get hit, with NaN's and +-1 exactly 
+ *		mixed in.
+ */
+static double testFastAcos(int nKernel)
+{
+	double *dRef = new double [KERNELTESTMAXPTS] ;
+	double *dTst = new double [KERNELTESTMAXPTS] ;
+	if (dRef == NULL || dTst == NULL)
+		return HUGE_VAL ;
+
+	double dWorst = 0.0 ;
+	int nRun ;
+	unsigned j ;
+	for (nRun=0; nRun < KERNELTESTRUNS; ++nRun)
+		{
+		unsigned uCount = 1 + (unsigned)rand() % KERNELTESTMAXPTS ;
+		double dScale = randVal(4.0) ;
+		for (j=0; j < uCount; ++j)
+			{
+			int nPick = rand() % 16 ;
+			if (nPick == 0)
+				dRef[j] = nan("") ;
+			else if (nPick == 1)
+				dRef[j] = 1.0 ;
+			else if (nPick == 2)
+				dRef[j] = -1.0 ;
+			else
+				dRef[j] = randVal(1.1) ;
+			dTst[j] = dRef[j] ;
+			}
+
+		poseKernelFastAcos(eKernelScalar, dScale, dRef, uCount) ;
+		poseKernelFastAcos(nKernel, dScale, dTst, uCount) ;
+
+		double dDiff = maxDiff(dRef, dTst, uCount) ;
+		if (dDiff > dWorst)
+			dWorst = dDiff ;
+		}
+
+	delete [] dRef ;
+	delete [] dTst ;
+	return dWorst ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testAcosBound() - nKernel's poseKernelFastAcos() against acos() on an even
+ *		grid over [-1, 1], ends included.  Also x = 1 has to give exactly 0,
+ *		and a NaN has to clamp to -1 and give pi, also within the bound.
+ */
+static double testAcosBound(int nKernel)
+{
+	double *dVal = new double [KERNELTESTACOSPTS] ;
+	if (dVal == NULL)
+		return HUGE_VAL ;
+
+	unsigned j ;
+	for (j=0; j < KERNELTESTACOSPTS; ++j)
+		dVal[j] = -1.0 + 2.0 * (double)j / (double)(KERNELTESTACOSPTS - 1) ;
+	dVal[KERNELTESTACOSPTS - 1] = 1.0 ;
+	poseKernelFastAcos(nKernel, 1.0, dVal, KERNELTESTACOSPTS) ;
+
+	double dWorst = 0.0 ;
+	for (j=0; j < KERNELTESTACOSPTS; ++j)
+		{
+		double dX = -1.0 + 2.0 * (double)j / (double)(KERNELTESTACOSPTS - 1) ;
+		if (j == KERNELTESTACOSPTS - 1)
+			dX = 1.0 ;
+		double dDiff = fabs(dVal[j] - acos(dX)) ;
+		if (dDiff > dWorst || dDiff != dDiff)
+			dWorst = (dDiff != dDiff) ? HUGE_VAL : dDiff ;
+		}
+	if (dVal[KERNELTESTACOSPTS - 1] != 0.0)
+		dWorst = HUGE_VAL ;
+
+	double dNaN[KERNELTILE] ;
+	for (j=0; j < KERNELTILE; ++j)
+		dNaN[j] = nan("") ;
+	poseKernelFastAcos(nKernel, 1.0, dNaN, KERNELTILE) ;
+	for (j=0; j < KERNELTILE; ++j)
+		{
+		if (dNaN[j] != dVal[0])		// Same as -1
+			dWorst = HUGE_VAL ;
+		}
+
+	delete [] dVal ;
+	return dWorst ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testLookup() - poseKernelLookup() against scalar.  Positions run off both ends
+ *		of the table and some are NaN, which then have to read sample 0, like
+ *		anything below the table does, and past the end has to read sample uSize.
+ */
+static double testLookup(int nKernel)
+{
+	double dTable[KERNELTESTTABLE + 2] ;
+	double *dRef = new double [KERNELTESTMAXPTS] ;
+	double *dTst = new double [KERNELTESTMAXPTS] ;
+	if (dRef == NULL || dTst == NULL)
+		return HUGE_VAL ;
+
+	double dWorst = 0.0 ;
+	int nRun ;
+	unsigned j ;
+	for (nRun=0; nRun < KERNELTESTRUNS; ++nRun)
+		{
+		unsigned uCount = 1 + (unsigned)rand() % KERNELTESTMAXPTS ;
+		for (j=0; j <= KERNELTESTTABLE; ++j)
+			dTable[j] = randVal(1.0) ;
+		dTable[KERNELTESTTABLE + 1] = dTable[KERNELTESTTABLE] ;
+
+		double dScale = KERNELTESTTABLE / 2.0 ;		// 0 to 2 covers the table
+		for (j=0; j < uCount; ++j)
+			{
+			int nPick = rand() % 16 ;
+			if (nPick == 0)
+				dRef[j] = nan("") ;
+			else if (nPick == 1)
+				dRef[j] = 2.0 ;
+			else
+				dRef[j] = randVal(1.5) + 1.0 ;
+			dTst[j] = dRef[j] ;
+			}
+		dTst[0] = dRef[0] = nan("") ;
+
+		poseKernelLookup(eKernelScalar, dTable, KERNELTESTTABLE, dScale, dRef, uCount) ;
+		for (j=0; j < uCount; ++j)
+			{
+			double dPos = dTst[j] * dScale ;
+			if (dPos != dPos || dPos <= 0.0)
+				{
+				if (dRef[j] != dTable[0])
+					dWorst = HUGE_VAL ;
+				}
+			else if (dPos >= KERNELTESTTABLE)
+				{
+				if (dRef[j] != dTable[KERNELTESTTABLE])
+					dWorst = HUGE_VAL ;
+				}
+			}
+		poseKernelLookup(nKernel, dTable, KERNELTESTTABLE, dScale, dTst, uCount) ;
+
+		double dDiff = maxDiff(dRef, dTst, uCount) ;
+		if (dDiff > dWorst)
+			dWorst = dDiff ;
+		}
+
+	delete [] dRef ;
+	delete [] dTst ;
+	return dWorst ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testCone() - poseKernelCone() against scalar, or if bExact against the exact
+ *		weight, smoothstep(1 - acos(read . cur) / cone).  The current axes are 
+ *		random, or near the read axis, or right on it, so every part of the 
+ *		ramp gets hit.
+ */
+static double testCone(int nKernel, bool bExact)
+{
+	unsigned uMaxStride = KERNELTESTMAXPTS + 8 ;
+	double *dRead = new double [3 * uMaxStride] ;
+	double *dCur = new double [3 * uMaxStride] ;
+	double *dInvCone = new double [KERNELTESTMAXPTS] ;
+	double *dRef = new double [KERNELTESTMAXPTS] ;
+	double *dTst = new double [KERNELTESTMAXPTS] ;
+	if (dRead == NULL || dCur == NULL || dInvCone == NULL || dRef == NULL || dTst == NULL)
+		return HUGE_VAL ;
+
+	double dWorst = 0.0 ;
+	int nRun ;
+	unsigned j, k ;
+	for (nRun=0; nRun < KERNELTESTRUNS; ++nRun)
+		{
+		unsigned uCount = 1 + (unsigned)rand() % KERNELTESTMAXPTS ;
+		unsigned uStride = uCount + (unsigned)rand() % 8 ;
+
+		for (j=0; j < uCount; ++j)
+			{
+			double dR[3], dC[3] ;
+			randUnit(dR, 3) ;
+			randUnit(dC, 3) ;
+			int nPick = rand() % 8 ;
+			if (nPick == 0)
+				{
+				for (k=0; k < 3; ++k)
+					dC[k] = dR[k] ;
+				}
+			else if (nPick < 4)
+				{
+				double dNear = randVal(0.5) ;
+				for (k=0; k < 3; ++k)
+					dC[k] = dR[k] + dC[k] * dNear ;
+				double dLen = sqrt(dC[0]*dC[0] + dC[1]*dC[1] + dC[2]*dC[2]) ;
+				for (k=0; k < 3; ++k)
+					dC[k] /= dLen ;
+				}
+			for (k=0; k < 3; ++k)
+				{
+				dRead[k * uStride + j] = dR[k] ;
+				dCur[k * uStride + j] = dC[k] ;
+				}
+			double dCone = KERNELTESTCONEMIN + (double)rand() / RAND_MAX * (KERNELTESTCONEMAX - KERNELTESTCONEMIN) ;
+			dInvCone[j] = 1.0 / (dCone * 3.14159265358979323846 / 180.0) ;
+			}
+
+		poseKernelCone(nKernel, dRead, dCur, uStride, dInvCone, dTst, uCount) ;
+		if (bExact)
+			{
+			for (j=0; j < uCount; ++j)
+				{
+				double dDot = dRead[j] * dCur[j] + dRead[uStride + j] * dCur[uStride + j] + 
+								dRead[uStride * 2 + j] * dCur[uStride * 2 + j] ;
+				dDot = (dDot < 1.0) ? dDot : 1.0 ;
+				dDot = (dDot > -1.0) ? dDot : -1.0 ;
+				double dT = 1.0 - acos(dDot) * dInvCone[j] ;
+				dT = (dT > 0.0) ? dT : 0.0 ;
+				dT = (dT < 1.0) ? dT : 1.0 ;
+				dRef[j] = dT * dT * (3.0 - 2.0 * dT) ;
+				}
+			}
+		else
+			poseKernelCone(eKernelScalar, dRead, dCur, uStride, dInvCone, dRef, uCount) ;
+
+		double dDiff = maxDiff(dRef, dTst, uCount) ;
+		if (dDiff > dWorst)
+			dWorst = dDiff ;
+		}
+
+	delete [] dRead ;
+	delete [] dCur ;
+	delete [] dInvCone ;
+	delete [] dRef ;
+	delete [] dTst ;
+	return dWorst ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * main() - Every path this cpu can run, every kernel.
+ */
+int main(int argc, char **argv)
+{
+	srand(1234) ;
+
+	int nBest = poseKernelDetect() ;
+	int nKernel ;
+	for (nKernel=eKernelScalar; nKernel <= nBest; ++nKernel)
+		{
+		report(nKernel, "full", "scalar", testKernel(nKernel, false), KERNELTESTBOUND) ;
+		report(nKernel, "diag", "scalar", testKernel(nKernel, true), KERNELTESTBOUND) ;
+		report(nKernel, "row update", "scalar", testRowUpdate(nKernel, false), KERNELTESTBOUND) ;
+		report(nKernel, "rows update", "scalar", testRowUpdate(nKernel, true), KERNELTESTBOUND) ;
+		report(nKernel, "quat dist", "scalar", testQuatDist(nKernel, false), KERNELTESTBOUND) ;
+		report(nKernel, "quat fast", "scalar", testQuatDist(nKernel, true), KERNELTESTBOUND) ;
+		report(nKernel, "dir dot", "scalar", testDirDot(nKernel), KERNELTESTBOUND) ;
+		report(nKernel, "fast acos", "scalar", testFastAcos(nKernel), KERNELTESTBOUND) ;
+		report(nKernel, "fast acos", "acos()", testAcosBound(nKernel), KERNELTESTACOSERR) ;
+		report(nKernel, "lookup", "scalar", testLookup(nKernel), KERNELTESTBOUND) ;
+		report(nKernel, "cone", "scalar", testCone(nKernel, false), KERNELTESTBOUND) ;
+		report(nKernel, "cone", "exact", testCone(nKernel, true), KERNELTESTCONEERR) ;
+		}
+
+	// No SIMD path, but it has to come out the same as the dense one.
+	report(eKernelScalar, "scatter", "scalar", testScatter(false), KERNELTESTBOUND) ;
+	report(eKernelScalar, "scatter diag", "scalar", testScatter(true), KERNELTESTBOUND) ;
+
+	if (nBest < eKernelAVX512)
+		printf("(%s is the best this cpu has, the wider paths weren't run)\n", poseKernelName(nBest)) ;
+
+	return nFails ? 1 : 0 ;
+}
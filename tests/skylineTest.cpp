@@ -0,0 +1,373 @@
+// ---------------------------------------------------------------------------
+// skylineTest.cpp - C++ File
+// Copyright ©2004 Michael B. Comet
+// ---------------------------------------------------------------------------
+//
+// DESCRIPTION:
+//	Standalone test of MatrixSkyline against the dense MatrixNN LDL^T.  Builds
+//	Wendland matrices like the compact support RBF mode does, from random
+//	points in a box and from separate clusters, so the pattern has pieces with
+//	no links between them.  Each one is solved both ways and the answers have
+//	to agree.  Also checks that setPattern()'s ordering is a real permutation,
+//	that it shrinks a shuffled band back down, and that a matrix that isn't 
+//	SPD fails to factor and then won't solve.  No Maya needed:
+//
+//		g++ -O2 -I.. skylineTest.cpp ../MatrixNN.cpp ../poseDeformerKernel.cpp -o skylineTest
+//
+//	Returns 0 if every check passed.
+//
+// AUTHOR:
+//	Michel B. Comet - comet@comet-cartoons.com
+//
+// ---------------------------------------------------------------------------
+//
+//  poseDeformer - Pose Space Deformer Maya Plugin by Michael B. Comet
+//  Copyright ©2004 Michael B. Comet
+//
+//   This program is free software; you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation; either version 2 of the License, or
+//   (at your option) any later version.
+//
+//   This program is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with this program; if not, write to the Free Software
+//   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//   For information on poseDeformer contact:
+//			Michael B. Comet - comet@comet-cartoons.com
+//			or visit http://www.comet-cartooons.com/toons/
+//
+// --------------------------------------------------------------------------
+
+/*
+ * Includes
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "MatrixNN.h"
+
+// ---------------------------------------------------------------------------
+
+#define SKYTESTPTS		400		// Points per matrix
+#define SKYTESTCLUSTERS	5		// Clusters in the disconnected one, plus an isolated point
+#define SKYTESTRADIUS	0.15	// Wendland support radius, box is 1 on a side
+#define SKYTESTLAMBDA	1e-3	// Added to the diagonal, like rbfRegularize
+#define SKYTESTBAND		3		// Neighbours each side in the shuffled band
+#define SKYTESTTOL		1e-9	// Biggest diff allowed from the dense answer, relative
+
+static int nFails = 0 ;
+
+// ---------------------------------------------------------------------------
+
+/*
+ * check() - Prints one result and counts the fails.
+ */
+static void check(bool bPass, const char *strWhat)
+{
+	printf("%-56s %s\n", strWhat, bPass ? "ok" : "FAIL") ;
+	if (!bPass)
+		++nFails ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * randVal() - Random value from 0 to 1.
+ */
+static double randVal(void)
+{
+	return (double)rand() / RAND_MAX ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * wendland() - The compact support kernel, (1-r)^4 (4r+1) inside the radius.
+ *		It's positive definite in 3D, so with the lambda the matrix is SPD.
+ */
+static double wendland(const double *dA, const double *dB)
+{
+	double dX = dA[0] - dB[0] ;
+	double dY = dA[1] - dB[1] ;
+	double dZ = dA[2] - dB[2] ;
+	double dR = sqrt(dX*dX + dY*dY + dZ*dZ) / SKYTESTRADIUS ;
+	if (dR >= 1.0)
+		return 0.0 ;
+	double dT = 1.0 - dR ;
+	return dT * dT * dT * dT * (4.0 * dR + 1.0) ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * buildNbrs() - Neighbour list of every pair inside the radius, from both sides.
+ *		uNbrStart gets SKYTESTPTS+1 entries, uNbr is alloced and must be freed.
+ */
+static unsigned *buildNbrs(const double *dPts, unsigned *uNbrStart)
+{
+	unsigned i,j ;
+	unsigned uCount = 0 ;
+	for (i=0; i < SKYTESTPTS; ++i)
+		for (j=0; j < SKYTESTPTS; ++j)
+			if (i != j && wendland(dPts + i*3, dPts + j*3) > 0.0)
+				++uCount ;
+
+	unsigned *uNbr = new unsigned [uCount + 1] ;
+	uCount = 0 ;
+	for (i=0; i < SKYTESTPTS; ++i)
+		{
+		uNbrStart[i] = uCount ;
+		for (j=0; j < SKYTESTPTS; ++j)
+			if (i != j && wendland(dPts + i*3, dPts + j*3) > 0.0)
+				uNbr[uCount++] = j ;
+		}
+	uNbrStart[SKYTESTPTS] = uCount ;
+
+	return uNbr ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * isPermutation() - True if matSky's ptrPerm and ptrInv are each other's inverse.
+ */
+static bool isPermutation(const MatrixSkyline &matSky)
+{
+	unsigned i ;
+	for (i=0; i < matSky.uDimension; ++i)
+		{
+		if (matSky.ptrPerm[i] >= matSky.uDimension || matSky.ptrInv[ matSky.ptrPerm[i] ] != i)
+			return false ;
+		}
+	return true ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * compareSolve() - Fills the skyline and a dense MatrixNN from dPts, factors 
+ *		both and solves a random b.  Returns the biggest diff, relative to the
+ *		biggest answer, or HUGE_VAL if either fails.
+ */
+static double compareSolve(const double *dPts, const unsigned *uNbrStart, const unsigned *uNbr, MatrixSkyline &matSky)
+{
+	MatrixNN matA ;
+	if (matA.setDimension(SKYTESTPTS) != SKYTESTPTS)
+		return HUGE_VAL ;
+
+	unsigned i,j,k ;
+	matA.fill(0.0) ;
+	for (i=0; i < SKYTESTPTS; ++i)
+		{
+		double dDiag = wendland(dPts + i*3, dPts + i*3) + SKYTESTLAMBDA ;
+		matA[i][i] = dDiag ;
+		matSky.set(i, i, dDiag) ;
+		for (k=uNbrStart[i]; k < uNbrStart[i+1]; ++k)
+			{
+			j = uNbr[k] ;
+			double dVal = wendland(dPts + i*3, dPts + j*3) ;
+			matA[i][j] = dVal ;
+			matSky.set(i, j, dVal) ;
+			}
+		}
+
+	double dB[SKYTESTPTS], dX[SKYTESTPTS], dXSky[SKYTESTPTS] ;
+	for (i=0; i < SKYTESTPTS; ++i)
+		dB[i] = randVal() * 2.0 - 1.0 ;
+
+	if (!matA.factorizeLDLT() || !matA.substituteLDLT(dB, dX))
+		return HUGE_VAL ;
+	if (!matSky.factorizeLDLT() || !matSky.solve(dB, dXSky))
+		return HUGE_VAL ;
+
+	double dBiggest = 0.0 ;
+	double dDiff = 0.0 ;
+	for (i=0; i < SKYTESTPTS; ++i)
+		{
+		if (fabs(dX[i]) > dBiggest)
+			dBiggest = fabs(dX[i]) ;
+		double dD = fabs(dX[i] - dXSky[i]) ;
+		if (dD > dDiff || dD != dD)
+			dDiff = (dD != dD) ? HUGE_VAL : dD ;
+		}
+
+	return (dBiggest > 0.0) ? dDiff / dBiggest : dDiff ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testBox() - Random points in a unit box, mostly one connected piece.  Also
+ *		solves in place, b and x the same array, which must give the same x.
+ */
+static void testBox(void)
+{
+	double dPts[SKYTESTPTS * 3] ;
+	unsigned uNbrStart[SKYTESTPTS + 1] ;
+	unsigned i ;
+	for (i=0; i < SKYTESTPTS * 3; ++i)
+		dPts[i] = randVal() ;
+	unsigned *uNbr = buildNbrs(dPts, uNbrStart) ;
+
+	MatrixSkyline matSky ;
+	check(matSky.setPattern(SKYTESTPTS, uNbrStart, uNbr), "Box: setPattern") ;
+	check(isPermutation(matSky), "Box: ordering is a permutation") ;
+	check(matSky.uEnvelope < SKYTESTPTS * (SKYTESTPTS + 1) / 2, "Box: envelope smaller than the dense triangle") ;
+
+	double dDiff = compareSolve(dPts, uNbrStart, uNbr, matSky) ;
+	printf("    max diff from dense %g\n", dDiff) ;
+	check(dDiff < SKYTESTTOL, "Box: solve matches dense LDL^T") ;
+
+	double dB[SKYTESTPTS], dX[SKYTESTPTS] ;
+	for (i=0; i < SKYTESTPTS; ++i)
+		dB[i] = dX[i] = (double)i / SKYTESTPTS ;
+	bool bSame = matSky.solve(dB, dX) && matSky.solve(dB, dB) ;
+	for (i=0; i < SKYTESTPTS && bSame; ++i)
+		bSame = (dB[i] == dX[i]) ;
+	check(bSame, "Box: solving in place gives the same x") ;
+
+	delete [] uNbr ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testClusters() - Tight clusters too far apart to touch, and one point off
+ *		on its own, so RCM has to seed every piece.  Each piece should come out
+ *		in one run of rows, so no row's envelope reaches into another piece.
+ */
+static void testClusters(void)
+{
+	double dPts[SKYTESTPTS * 3] ;
+	unsigned uNbrStart[SKYTESTPTS + 1] ;
+	unsigned uPiece[SKYTESTPTS] ;
+	unsigned i,j ;
+	for (i=0; i < SKYTESTPTS; ++i)
+		{
+		// Interleaved, so the pieces start out mixed up.  The last one is alone.
+		uPiece[i] = (i == SKYTESTPTS - 1) ? SKYTESTCLUSTERS : i % SKYTESTCLUSTERS ;
+		for (j=0; j < 3; ++j)
+			dPts[i*3+j] = uPiece[i] * 1.0 + randVal() * 0.4 ;
+		}
+	unsigned *uNbr = buildNbrs(dPts, uNbrStart) ;
+	check(uNbrStart[SKYTESTPTS] == uNbrStart[SKYTESTPTS-1], "Clusters: last point has no neighbours") ;
+
+	MatrixSkyline matSky ;
+	check(matSky.setPattern(SKYTESTPTS, uNbrStart, uNbr), "Clusters: setPattern") ;
+	check(isPermutation(matSky), "Clusters: ordering is a permutation") ;
+
+	bool bContiguous = true ;
+	unsigned uRuns = 1 ;
+	for (i=1; i < SKYTESTPTS; ++i)
+		{
+		if (uPiece[ matSky.ptrPerm[i] ] != uPiece[ matSky.ptrPerm[i-1] ])
+			++uRuns ;
+		if (uPiece[ matSky.ptrPerm[ matSky.ptrFirst[i] ] ] != uPiece[ matSky.ptrPerm[i] ])
+			bContiguous = false ;
+		}
+	check(uRuns == SKYTESTCLUSTERS + 1, "Clusters: each piece is one run of rows") ;
+	check(bContiguous, "Clusters: no envelope crosses between pieces") ;
+
+	double dDiff = compareSolve(dPts, uNbrStart, uNbr, matSky) ;
+	printf("    max diff from dense %g\n", dDiff) ;
+	check(dDiff < SKYTESTTOL, "Clusters: solve matches dense LDL^T") ;
+
+	delete [] uNbr ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testBand() - A band SKYTESTBAND wide each side, with the rows shuffled.  As
+ *		given its envelope is most of the triangle, RCM should get it back down
+ *		to about the band.
+ */
+static void testBand(void)
+{
+	unsigned uLabel[SKYTESTPTS] ;
+	unsigned i,j ;
+	for (i=0; i < SKYTESTPTS; ++i)
+		uLabel[i] = i ;
+	for (i=SKYTESTPTS-1; i > 0; --i)
+		{
+		j = (unsigned)rand() % (i + 1) ;
+		unsigned uSwap = uLabel[i] ;
+		uLabel[i] = uLabel[j] ;
+		uLabel[j] = uSwap ;
+		}
+
+	// Row uLabel[i] is next to uLabel[i-BAND] .. uLabel[i+BAND]
+	unsigned uAt[SKYTESTPTS] ;
+	for (i=0; i < SKYTESTPTS; ++i)
+		uAt[ uLabel[i] ] = i ;
+	unsigned uNbrStart[SKYTESTPTS + 1] ;
+	unsigned *uNbr = new unsigned [SKYTESTPTS * SKYTESTBAND * 2] ;
+	unsigned uCount = 0 ;
+	for (i=0; i < SKYTESTPTS; ++i)
+		{
+		uNbrStart[i] = uCount ;
+		unsigned uPos = uAt[i] ;
+		for (j=(uPos > SKYTESTBAND) ? uPos - SKYTESTBAND : 0; j <= uPos + SKYTESTBAND && j < SKYTESTPTS; ++j)
+			if (j != uPos)
+				uNbr[uCount++] = uLabel[j] ;
+		}
+	uNbrStart[SKYTESTPTS] = uCount ;
+
+	MatrixSkyline matSky ;
+	check(matSky.setPattern(SKYTESTPTS, uNbrStart, uNbr), "Band: setPattern") ;
+	printf("    envelope %u, band is %u\n", matSky.uEnvelope, SKYTESTPTS * (SKYTESTBAND + 1)) ;
+	check(matSky.uEnvelope <= SKYTESTPTS * (2 * SKYTESTBAND + 1), "Band: shuffled band reordered back to near the band") ;
+
+	delete [] uNbr ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * testNotSPD() - A 3 x 3 chain whose second D comes out negative.  Has to fail
+ *		the factor, then refuse to solve.  Refactoring once it's fixed works.
+ */
+static void testNotSPD(void)
+{
+	unsigned uNbrStart[4] = { 0, 1, 3, 4 } ;
+	unsigned uNbr[4] = { 1, 0, 2, 1 } ;
+	MatrixSkyline matSky ;
+	check(matSky.setPattern(3, uNbrStart, uNbr), "Not SPD: setPattern") ;
+
+	unsigned i ;
+	for (i=0; i < 3; ++i)
+		matSky.set(i, i, 1.0) ;
+	matSky.set(0, 1, 2.0) ;
+	matSky.set(1, 2, 0.5) ;
+	double dB[3] = { 1.0, 1.0, 1.0 } ;
+	double dX[3] ;
+	check(!matSky.factorizeLDLT(), "Not SPD: factorizeLDLT fails") ;
+	check(!matSky.bFactored && !matSky.solve(dB, dX), "Not SPD: solve refuses") ;
+
+	matSky.set(0, 1, 0.5) ;
+	check(matSky.factorizeLDLT() && matSky.solve(dB, dX), "Not SPD: fixed up, factors and solves") ;
+}
+
+// ---------------------------------------------------------------------------
+
+/*
+ * main() - Every check.
+ */
+int main(int argc, char **argv)
+{
+	srand(1234) ;
+
+	testBox() ;
+	testClusters() ;
+	testBand() ;
+	testNotSPD() ;
+
+	return nFails ? 1 : 0 ;
+}